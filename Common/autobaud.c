@@ -0,0 +1,318 @@
+/**
+  ******************************************************************************
+  * @file    autobaud.c
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   UART auto-baud detection module, see autobaud.h for the method.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "autobaud.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Timer updates without an edge before the line is seen idle */
+#define AB_IDLE_UPDATES					2U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static UART_HandleTypeDef *AbUart = NULL;
+static TIM_HandleTypeDef *AbTimer = NULL;
+static volatile AbStateTypeDef AbState = AB_STATE_RESET;
+/* Edges captured in the current character */
+static uint8_t AbEdges = 0;
+/* Timer updates since the last edge, saturated at AB_IDLE_UPDATES */
+static uint8_t AbUpdates = 0;
+/* Last captured value */
+static uint16_t AbLast = 0;
+/* UART receiver enabled before the detection */
+static uint32_t AbReceiverEnabled = 0;
+static AbResultTypeDef AbResult;
+
+/* Private function prototypes -----------------------------------------------*/
+static void AbHalt(void);
+static void AbReject(void);
+static void AbApply(void);
+static void AbEdge(uint16_t capture);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Stops the capture and gives the TIM1 CH1 input back to its pin
+  * @param  None
+  * @retval None
+  */
+static void AbHalt(void)
+{
+	HAL_NVIC_DisableIRQ(TIM1_IRQn);
+	__HAL_TIM_DISABLE_IT(AbTimer, TIM_IT_UPDATE);
+	HAL_TIM_IC_Stop_IT(AbTimer, TIM_CHANNEL_1);
+	__HAL_TIM_DISABLE(AbTimer);
+	__HAL_SYSCON_TIM1CH1IN_SEL(SYSCON_DEFAULT);
+}
+
+/**
+  * @brief  Drops the current character and waits for an idle line
+  * @param  None
+  * @retval None
+  */
+static void AbReject(void)
+{
+	AbResult.Rejected++;
+	AbUpdates = 0;
+	AbState = AB_STATE_RESYNC;
+}
+
+/**
+  * @brief  Programs the UART divider from the measured sync character
+  * @param  None
+  * @retval None
+  */
+static void AbApply(void)
+{
+	uint32_t pclk = HAL_RCC_GetPCLKFreq();
+	uint32_t dbaud = ((AbUart->Instance->SCON & UART_SCON_DBAUD) >> UART_SCON_DBAUD_Pos) + 1U;
+	/* BRG + 1, rounded to the nearest */
+	uint32_t div = ((dbaud * AbResult.SyncTicks) + (16U * AB_SYNC_BITS)) / (32U * AB_SYNC_BITS);
+
+	if((div == 0U) || (div > (UART_BAUDCR_BRG + 1U)))
+	{
+		AbReject();
+		return;
+	}
+
+	AbHalt();
+
+	AbResult.MeasuredBaudRate = (pclk * AB_SYNC_BITS) / AbResult.SyncTicks;
+	AbResult.BaudRate = (dbaud * pclk) / (32U * div);
+
+	/* Only the divider changes, the frame format and the handlers are kept */
+	AbUart->Instance->BAUDCR = ((div - 1U) & UART_BAUDCR_BRG) | UART_BAUDCR_SELF_BRG;
+	AbUart->Init.BaudRate = AbResult.BaudRate;
+
+	__HAL_UART_CLEAR_FLAG(AbUart, UART_FLAG_RXNE | UART_FLAG_FE);
+	SET_BIT(AbUart->Instance->SCON, AbReceiverEnabled);
+
+	AbState = AB_STATE_DONE;
+	AbCompleteCallback(AbUart);
+}
+
+/**
+  * @brief  Handles one captured edge
+  * @param  capture: captured counter value
+  * @retval None
+  */
+static void AbEdge(uint16_t capture)
+{
+	uint32_t delta = (uint16_t)(capture - AbLast);
+	uint32_t margin;
+
+	AbLast = capture;
+	AbUpdates = 0;
+
+	switch(AbState)
+	{
+		case AB_STATE_WAIT:
+			/* The line idles high, this is the falling edge of a start bit */
+			AbEdges = 1;
+			AbResult.SyncTicks = 0;
+			AbState = AB_STATE_MEASURE;
+			break;
+
+		case AB_STATE_MEASURE:
+			if(AbEdges == 1U)
+			{
+				AbResult.StartBitTicks = delta;
+			}
+			margin = AbResult.StartBitTicks / AB_TOLERANCE;
+			if((delta == 0U) || (delta + margin < AbResult.StartBitTicks) || (delta > AbResult.StartBitTicks + margin))
+			{
+				AbReject();
+				break;
+			}
+			AbResult.SyncTicks += delta;
+			if(++AbEdges == AB_SYNC_EDGES)
+			{
+				AbApply();
+			}
+			break;
+
+		default:
+			/* AB_STATE_RESYNC, the line is not idle yet */
+			break;
+	}
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Starts the auto-baud detection
+  * @note   The UART must be initialized, its receiver is held off until the
+  *         new baud rate is programmed. TIM1 is owned by this module until
+  *         the detection completes or AbStop() is called.
+  * @param  huart: UART0 or UART1 handle
+  * @param  htim: TIM1 handle, Instance set, it is configured here
+  * @retval HAL status
+  */
+HAL_StatusTypeDef AbStart(UART_HandleTypeDef *huart, TIM_HandleTypeDef *htim)
+{
+	TIM_IC_InitTypeDef sConfig = {0};
+
+	if(((huart->Instance != UART0) && (huart->Instance != UART1)) || (htim->Instance != TIM1))
+	{
+		return HAL_ERROR;
+	}
+
+	HAL_NVIC_DisableIRQ(TIM1_IRQn);
+
+	AbUart = huart;
+	AbTimer = htim;
+	AbEdges = 0;
+	AbUpdates = 0;
+	AbResult.StartBitTicks = 0;
+	AbResult.SyncTicks = 0;
+	AbResult.MeasuredBaudRate = 0;
+	AbResult.BaudRate = 0;
+	AbResult.Rejected = 0;
+
+	__HAL_RCC_TIM1_CLK_ENABLE();
+	__HAL_RCC_SYSCON_CLK_ENABLE();
+
+	/* Free running 16 bit counter at PCLK */
+	htim->Init.Prescaler = 0;
+	htim->Init.Period = 0xFFFFU;
+	htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim->Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim->Init.RepetitionCounter = 0;
+	htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if(HAL_TIM_IC_Init(htim) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+
+	sConfig.ICPolarity = TIM_ICPOLARITY_BOTHEDGE;
+	sConfig.ICSelection = TIM_ICSELECTION_DIRECTTI;
+	sConfig.ICPrescaler = TIM_ICPSC_DIV1;
+	sConfig.ICFilter = 0;
+	if(HAL_TIM_IC_ConfigChannel(htim, &sConfig, TIM_CHANNEL_1) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+
+	/* The sync character must not reach the UART at the old baud rate */
+	AbReceiverEnabled = huart->Instance->SCON & UART_SCON_REN;
+	CLEAR_BIT(huart->Instance->SCON, UART_SCON_REN);
+
+	__HAL_SYSCON_TIM1CH1IN_SEL((huart->Instance == UART0) ? SYSCON_UART0_RXD : SYSCON_UART1_RXD);
+
+	AbState = AB_STATE_WAIT;
+	__HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE | TIM_FLAG_CC1 | TIM_FLAG_CC1OF);
+	__HAL_TIM_ENABLE_IT(htim, TIM_IT_UPDATE);
+	HAL_TIM_IC_Start_IT(htim, TIM_CHANNEL_1);
+
+	HAL_NVIC_SetPriority(TIM1_IRQn, AB_IRQ_PRIORITY);
+	HAL_NVIC_EnableIRQ(TIM1_IRQn);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Stops the auto-baud detection, the UART keeps its baud rate
+  * @param  None
+  * @retval None
+  */
+void AbStop(void)
+{
+	if((AbState == AB_STATE_RESET) || (AbState == AB_STATE_DONE))
+	{
+		return;
+	}
+
+	AbHalt();
+	SET_BIT(AbUart->Instance->SCON, AbReceiverEnabled);
+	AbState = AB_STATE_RESET;
+}
+
+/**
+  * @brief  TIM1 interrupt service, call it from TIM1_IRQHandler()
+  * @param  None
+  * @retval None
+  */
+void AbTimerIRQHandler(void)
+{
+	if(__HAL_TIM_GET_FLAG(AbTimer, TIM_FLAG_CC1) && __HAL_TIM_GET_IT_SOURCE(AbTimer, TIM_IT_CC1))
+	{
+		__HAL_TIM_CLEAR_IT(AbTimer, TIM_IT_CC1);
+		/* An edge was lost, the interrupt came later than the next edge */
+		if(__HAL_TIM_GET_FLAG(AbTimer, TIM_FLAG_CC1OF))
+		{
+			__HAL_TIM_CLEAR_FLAG(AbTimer, TIM_FLAG_CC1OF);
+			AbLast = (uint16_t)HAL_TIM_ReadCapturedValue(AbTimer, TIM_CHANNEL_1);
+			if(AbState == AB_STATE_MEASURE)
+			{
+				AbReject();
+			}
+			AbUpdates = 0;
+		}
+		else
+		{
+			AbEdge((uint16_t)HAL_TIM_ReadCapturedValue(AbTimer, TIM_CHANNEL_1));
+		}
+	}
+
+	if((AbState != AB_STATE_DONE) && __HAL_TIM_GET_FLAG(AbTimer, TIM_FLAG_UPDATE) && __HAL_TIM_GET_IT_SOURCE(AbTimer, TIM_IT_UPDATE))
+	{
+		__HAL_TIM_CLEAR_IT(AbTimer, TIM_IT_UPDATE);
+		if(AbUpdates < AB_IDLE_UPDATES)
+		{
+			AbUpdates++;
+		}
+		if(AbUpdates == AB_IDLE_UPDATES)
+		{
+			/* A full timer period without edges */
+			if(AbState == AB_STATE_RESYNC)
+			{
+				AbState = AB_STATE_WAIT;
+			}
+			else if(AbState == AB_STATE_MEASURE)
+			{
+				/* Bit time longer than the timer period */
+				AbReject();
+			}
+		}
+	}
+}
+
+/**
+  * @brief  Returns the detection state
+  * @param  None
+  * @retval State
+  */
+AbStateTypeDef AbGetState(void)
+{
+	return AbState;
+}
+
+/**
+  * @brief  Returns the last measurement
+  * @param  None
+  * @retval Result, valid once the state is AB_STATE_DONE
+  */
+const AbResultTypeDef *AbGetResult(void)
+{
+	return &AbResult;
+}
+
+/**
+  * @brief  Detection complete callback, called from the TIM1 interrupt
+  * @param  huart: UART handle, its new baud rate is in Init.BaudRate
+  * @retval None
+  */
+__weak void AbCompleteCallback(UART_HandleTypeDef *huart)
+{
+	/* Prevent unused argument(s) compilation warning */
+	UNUSED(huart);
+	/* NOTE : This function Should not be modified, when the callback is needed,
+            the AbCompleteCallback could be implemented in the user file
+   */
+}
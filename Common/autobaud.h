@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    autobaud.h
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Header file of UART auto-baud detection module.
+  ******************************************************************************
+  */
+
+#ifndef __CX32L003_AUTOBAUD_H
+#define __CX32L003_AUTOBAUD_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "cx32l003_hal.h"
+
+/*
+ * Auto-baud detection for UART0 and UART1 with TIM1 input capture.
+ * The UART RXD signal is routed inside the chip to the TIM1 CH1 input
+ * (SYSCON TIM1CR), the RX pin keeps its UART alternate function and no extra
+ * wiring is needed. TIM1 counts PCLK and captures both edges of the line.
+ * The host sends the sync character 0x55 ('U'), seen on the line as
+ *   start 0 1 0 1 0 1 0 1 0 stop
+ * that is AB_SYNC_EDGES edges one bit time apart. The first interval is the
+ * start bit, every next one must match it within 1/AB_TOLERANCE, the span from
+ * the first to the last edge covers AB_SYNC_BITS bit times and gives the bit
+ * time to a fraction of a PCLK tick. The UART divider is derived from it:
+ *   BRG = (DBAUD + 1) * span / (32 * AB_SYNC_BITS) - 1, rounded
+ * and only BAUDCR is rewritten, the UART keeps the rest of its configuration
+ * and its handle is not initialized again.
+ * Any character other than the sync character, or an interval too long for
+ * the 16 bit timer, is rejected. The detection then waits for a full timer
+ * period (65536 PCLK ticks) of idle line before looking for a start bit again.
+ * The UART is initialized by the application (HAL_UART_Init) with any baud
+ * rate, then AbStart() configures TIM1 and takes over its interrupt.
+ * AbTimerIRQHandler() must be called from TIM1_IRQHandler(). AbCompleteCallback()
+ * is called from the interrupt once the new baud rate is programmed.
+ */
+
+/* Priority of the TIM1 interrupt, it must be served within one bit time */
+#define AB_IRQ_PRIORITY				PRIORITY_HIGHEST
+/* Edges and bit times of the sync character 0x55 */
+#define AB_SYNC_EDGES					10U
+#define AB_SYNC_BITS					(AB_SYNC_EDGES - 1U)
+/* Every bit time must match the start bit within 1/AB_TOLERANCE */
+#define AB_TOLERANCE					4U
+
+/* Detection states */
+typedef enum
+{
+	AB_STATE_RESET = 0,						/* Not started or stopped */
+	AB_STATE_WAIT,								/* Waiting for a start bit */
+	AB_STATE_MEASURE,							/* Sync character edges being captured */
+	AB_STATE_RESYNC,							/* Character rejected, waiting for an idle line */
+	AB_STATE_DONE									/* New baud rate programmed */
+} AbStateTypeDef;
+
+/* Measurement and result */
+typedef struct
+{
+	uint32_t StartBitTicks;				/* Start bit width, PCLK ticks */
+	uint32_t SyncTicks;						/* First to last edge of the sync character, PCLK ticks */
+	uint32_t MeasuredBaudRate;		/* Baud rate measured on the line */
+	uint32_t BaudRate;						/* Baud rate programmed, nearest the divider allows */
+	uint32_t Rejected;						/* Characters rejected */
+} AbResultTypeDef;
+
+
+HAL_StatusTypeDef AbStart(UART_HandleTypeDef *huart, TIM_HandleTypeDef *htim);
+void AbStop(void);
+void AbTimerIRQHandler(void);
+AbStateTypeDef AbGetState(void);
+const AbResultTypeDef *AbGetResult(void);
+void AbCompleteCallback(UART_HandleTypeDef *huart);
+#endif /* __CX32L003_AUTOBAUD_H */
@@ -0,0 +1,543 @@
+/**
+  ******************************************************************************
+  * @file    foc.c
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Field oriented motor control module, see foc.h for the control scheme.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "foc.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define FOC_INV_SQRT3						18919		/* 1 / sqrt(3) in q15 */
+#define FOC_SQRT3_2							28378		/* sqrt(3) / 2 in q15 */
+#define FOC_QUARTER_TURN				0x40000000U
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* sin(k * pi / 128) in q15, k = 0 to 64 */
+static const int16_t FocSineTable[65] =
+{
+	0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+	6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+	12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+	18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+	23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+	27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+	30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+	32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+	32767
+};
+
+#if !defined(FOC_HOST_SIM)
+static TIM_HandleTypeDef *FocTimer = NULL;
+static ADC_HandleTypeDef *FocAdc = NULL;
+static FocTypeDef Foc;
+/* Current offsets in ADC counts, summed during FOC_STATE_CALIBRATE */
+static uint32_t FocOffsetA = 0;
+static uint32_t FocOffsetB = 0;
+static uint32_t FocCalibrationCount = 0;
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static int32_t FocSat16(int32_t x);
+static int16_t FocPi(FocPiTypeDef *pi, int32_t err, int32_t limit);
+static void FocObserver(FocTypeDef *foc);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Saturates to the q15 range
+  * @param  x: value
+  * @retval x clamped to -32768..32767
+  */
+static int32_t FocSat16(int32_t x)
+{
+	if(x > 32767)
+	{
+		return 32767;
+	}
+	if(x < -32768)
+	{
+		return -32768;
+	}
+	return x;
+}
+
+/**
+  * @brief  PI step with the integral clamped to the output range (anti windup)
+  * @param  pi: PI state
+  * @param  err: error, saturated to q15
+  * @param  limit: output limit, the output is within -limit..limit
+  * @retval PI output
+  */
+static int16_t FocPi(FocPiTypeDef *pi, int32_t err, int32_t limit)
+{
+	int32_t integral;
+	int32_t bound = limit << pi->Gains.Shift;
+	int32_t out;
+
+	err = FocSat16(err);
+	integral = pi->Integral + (pi->Gains.Ki * err);
+	if(integral > bound)
+	{
+		integral = bound;
+	}
+	else if(integral < -bound)
+	{
+		integral = -bound;
+	}
+	pi->Integral = integral;
+
+	out = ((pi->Gains.Kp * err) + integral) >> pi->Gains.Shift;
+	if(out > limit)
+	{
+		out = limit;
+	}
+	else if(out < -limit)
+	{
+		out = -limit;
+	}
+	return (int16_t)out;
+}
+
+/**
+  * @brief  Flux observer and PLL, updates PllAngle and PllSpeed
+  * @note   The stator flux is the integral of the voltage minus the resistive
+  *         drop, with a leak so the offsets do not make it drift. Removing
+  *         the inductive flux leaves the rotor flux, aligned with the d axis.
+  *         The PLL drives the sine of the angle between the rotor flux and its
+  *         own angle to zero. Valpha and Vbeta are the voltages applied during
+  *         the period that just ended.
+  * @param  foc: controller
+  * @retval None
+  */
+static void FocObserver(FocTypeDef *foc)
+{
+	const FocConfigTypeDef *cfg = &foc->Config;
+	int32_t psiAlpha;
+	int32_t psiBeta;
+	int32_t err;
+
+	foc->FluxAlpha += foc->Valpha - ((cfg->Rs * foc->Ialpha) >> 15) - (foc->FluxAlpha >> FOC_FLUX_LEAK_SHIFT);
+	foc->FluxBeta += foc->Vbeta - ((cfg->Rs * foc->Ibeta) >> 15) - (foc->FluxBeta >> FOC_FLUX_LEAK_SHIFT);
+	psiAlpha = FocSat16((foc->FluxAlpha - ((cfg->Ls * foc->Ialpha) >> 8)) >> cfg->FluxShift);
+	psiBeta = FocSat16((foc->FluxBeta - ((cfg->Ls * foc->Ibeta) >> 8)) >> cfg->FluxShift);
+
+	err = ((psiBeta * FocCos(foc->PllAngle)) - (psiAlpha * FocSin(foc->PllAngle))) >> 15;
+	foc->PllSpeed = foc->PllIntegral + (cfg->PllKp * err);
+	foc->PllIntegral += cfg->PllKi * err;
+	foc->PllAngle += (uint32_t)foc->PllSpeed;
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Sine from the quarter wave table with linear interpolation
+  * @param  angle: angle, 2^32 per turn
+  * @retval sine in q15, within 3 LSB
+  */
+int16_t FocSin(uint32_t angle)
+{
+	uint32_t a = angle >> 16;
+	uint32_t x = a & 0x3FFFU;
+	uint32_t i;
+	int32_t s;
+
+	/* Second and fourth quadrants mirror the first and third ones */
+	if((a & 0x4000U) != 0U)
+	{
+		x = 0x4000U - x;
+	}
+	i = x >> 8;
+	if(i >= 64U)
+	{
+		s = FocSineTable[64];
+	}
+	else
+	{
+		s = FocSineTable[i] + (((FocSineTable[i + 1U] - FocSineTable[i]) * (int32_t)(x & 0xFFU)) >> 8);
+	}
+	return (int16_t)(((a & 0x8000U) != 0U) ? -s : s);
+}
+
+/**
+  * @brief  Cosine from the quarter wave table
+  * @param  angle: angle, 2^32 per turn
+  * @retval cosine in q15
+  */
+int16_t FocCos(uint32_t angle)
+{
+	return FocSin(angle + FOC_QUARTER_TURN);
+}
+
+/**
+  * @brief  Initializes a controller, state FOC_STATE_IDLE with zero references
+  * @param  foc: controller
+  * @param  config: motor and control parameters, copied
+  * @param  period: TIM1 auto reload value, the duty cycles range 0 to period
+  * @retval None
+  */
+void FocReset(FocTypeDef *foc, const FocConfigTypeDef *config, uint16_t period)
+{
+	memset(foc, 0, sizeof(FocTypeDef));
+	foc->Config = *config;
+	foc->Period = period;
+	foc->VoltageMaxInv = (int32_t)((1UL << 30) / (uint32_t)config->VoltageMax);
+	foc->PiD.Gains = config->CurrentPi;
+	foc->PiQ.Gains = config->CurrentPi;
+	foc->PiSpeed.Gains = config->SpeedPi;
+	foc->State = FOC_STATE_IDLE;
+}
+
+/**
+  * @brief  Control step, once per PWM period
+  * @note   Cycle count on the Cortex-M0+ (single cycle multiplier, estimated
+  *         from the code, not measured): Clarke and Park 60, 6 sines 170,
+  *         observer and PLL 110, PI loops and voltage limit 110, inverse Park
+  *         and SVPWM 120, plus calls and loads, about 650 cycles in all. This
+  *         leaves 550 of the 1200 cycles of a 20 kHz period at 24 MHz.
+  * @param  foc: controller, in state FOC_STATE_STARTUP or FOC_STATE_RUN
+  * @param  ia: phase A current in q15, positive into the motor
+  * @param  ib: phase B current in q15
+  * @param  pDuty: the 3 compare values for the next period, 0 to foc->Period
+  * @retval None
+  */
+void FocStep(FocTypeDef *foc, int16_t ia, int16_t ib, uint16_t *pDuty)
+{
+	const FocConfigTypeDef *cfg = &foc->Config;
+	int32_t s;
+	int32_t c;
+	int32_t iqRef;
+	int32_t vd;
+	int32_t vq;
+	int32_t va;
+	int32_t vb;
+	int32_t vc;
+	int32_t max;
+	int32_t min;
+	int32_t duty;
+	uint32_t angle;
+	uint32_t i;
+
+	/* Clarke, ia + ib + ic = 0 */
+	foc->Ialpha = ia;
+	foc->Ibeta = (int16_t)FocSat16((((int32_t)ia + (2 * (int32_t)ib)) * FOC_INV_SQRT3) >> 15);
+
+	/* Rotor angle */
+	if(cfg->AngleSource == FOC_ANGLE_SENSORLESS)
+	{
+		FocObserver(foc);
+		if(foc->State == FOC_STATE_STARTUP)
+		{
+			/* Current forced at a rotating angle until the back EMF is observable */
+			foc->OpenSpeed += cfg->StartupAccel;
+			foc->OpenAngle += (uint32_t)foc->OpenSpeed;
+			foc->Angle = foc->OpenAngle;
+			foc->Speed = foc->OpenSpeed;
+			if(((cfg->StartupSpeed >= 0) && (foc->OpenSpeed >= cfg->StartupSpeed)) ||
+				 ((cfg->StartupSpeed < 0) && (foc->OpenSpeed <= cfg->StartupSpeed)))
+			{
+				/* Hand over to the PLL, the loops starting from the current and the
+				   voltage of the open loop seen in the PLL frame, so nothing jumps */
+				s = FocSin(foc->PllAngle);
+				c = FocCos(foc->PllAngle);
+				foc->PiSpeed.Integral = ((foc->Ibeta * c) - (foc->Ialpha * s)) >> (15 - foc->PiSpeed.Gains.Shift);
+				foc->PiD.Integral = ((foc->Valpha * c) + (foc->Vbeta * s)) >> (15 - foc->PiD.Gains.Shift);
+				foc->PiQ.Integral = ((foc->Vbeta * c) - (foc->Valpha * s)) >> (15 - foc->PiQ.Gains.Shift);
+				foc->SpeedSum = 0;
+				foc->SpeedCount = 0;
+				foc->State = FOC_STATE_RUN;
+			}
+		}
+		else
+		{
+			foc->Angle = foc->PllAngle;
+			foc->Speed = foc->PllSpeed;
+		}
+	}
+	else
+	{
+		/* Extrapolated between two FocSetAngle() */
+		foc->ExtAngle += (uint32_t)foc->ExtSpeed;
+		foc->Angle = foc->ExtAngle;
+		foc->Speed = foc->ExtSpeed;
+	}
+
+	/* Park */
+	s = FocSin(foc->Angle);
+	c = FocCos(foc->Angle);
+	foc->Id = (int16_t)FocSat16(((foc->Ialpha * c) + (foc->Ibeta * s)) >> 15);
+	foc->Iq = (int16_t)FocSat16(((foc->Ibeta * c) - (foc->Ialpha * s)) >> 15);
+
+	/* Speed loop */
+	if(foc->State == FOC_STATE_STARTUP)
+	{
+		iqRef = cfg->StartupCurrent;
+	}
+	else
+	{
+		if(cfg->Mode == FOC_MODE_SPEED)
+		{
+			foc->SpeedSum += foc->Speed >> FOC_SPEED_DIVIDER_SHIFT;
+			if(++foc->SpeedCount >= FOC_SPEED_DIVIDER)
+			{
+				foc->IqRef = FocPi(&foc->PiSpeed, (foc->SpeedRef - foc->SpeedSum) >> FOC_SPEED_SHIFT, cfg->CurrentMax);
+				foc->SpeedSum = 0;
+				foc->SpeedCount = 0;
+			}
+		}
+		iqRef = foc->IqRef;
+		if(iqRef > cfg->CurrentMax)
+		{
+			iqRef = cfg->CurrentMax;
+		}
+		else if(iqRef < -cfg->CurrentMax)
+		{
+			iqRef = -cfg->CurrentMax;
+		}
+	}
+
+	/* Current loops, Vq limited to the circle left by Vd (Vq < Vmax - Vd^2 / Vmax) */
+	vd = FocPi(&foc->PiD, foc->IdRef - foc->Id, cfg->VoltageMax);
+	vq = FocPi(&foc->PiQ, iqRef - foc->Iq, cfg->VoltageMax - ((((vd * vd) >> 15) * foc->VoltageMaxInv) >> 15));
+	foc->Vd = (int16_t)vd;
+	foc->Vq = (int16_t)vq;
+
+	/* Inverse Park at the angle in the middle of the next period */
+	angle = foc->Angle + (uint32_t)foc->Speed + (uint32_t)(foc->Speed >> 1);
+	s = FocSin(angle);
+	c = FocCos(angle);
+	foc->Valpha = (int16_t)FocSat16(((vd * c) - (vq * s)) >> 15);
+	foc->Vbeta = (int16_t)FocSat16(((vd * s) + (vq * c)) >> 15);
+
+	/* SVPWM, phase voltages centered by min-max injection */
+	va = foc->Valpha;
+	vb = (((int32_t)foc->Vbeta * FOC_SQRT3_2) >> 15) - (va >> 1);
+	vc = -va - vb;
+	max = (va > vb) ? va : vb;
+	max = (vc > max) ? vc : max;
+	min = (va < vb) ? va : vb;
+	min = (vc < min) ? vc : min;
+	c = (max + min) >> 1;
+
+	pDuty[0] = (uint16_t)(va - c);
+	pDuty[1] = (uint16_t)(vb - c);
+	pDuty[2] = (uint16_t)(vc - c);
+	for(i = 0; i < 3U; i++)
+	{
+		duty = (int32_t)(foc->Period >> 1) + (((int32_t)(int16_t)pDuty[i] * (int32_t)foc->Period) >> 15);
+		if(duty < 0)
+		{
+			duty = 0;
+		}
+		else if(duty > (int32_t)foc->Period)
+		{
+			duty = foc->Period;
+		}
+		pDuty[i] = (uint16_t)duty;
+	}
+}
+
+#if !defined(FOC_HOST_SIM)
+/**
+  * @brief  Initializes the module on an initialized TIM1 and ADC
+  * @note   TIM1 is center aligned with CH1..CH3 in PWM mode 1 and dead time,
+  *         the ADC converts the 2 current channels in continuous mode on the
+  *         TIM1 TRGO. The TIM1 TRGO is set to the update event, once per period.
+  * @param  htim: TIM1 handle
+  * @param  hadc: ADC handle
+  * @param  config: motor and control parameters, copied
+  * @retval HAL status
+  */
+HAL_StatusTypeDef FocInit(TIM_HandleTypeDef *htim, ADC_HandleTypeDef *hadc, const FocConfigTypeDef *config)
+{
+	if((htim == NULL) || (hadc == NULL) || (config == NULL) || (config->VoltageMax <= 0) ||
+		 (config->ChannelA > 7U) || (config->ChannelB > 7U))
+	{
+		return HAL_ERROR;
+	}
+
+	HAL_NVIC_DisableIRQ(ADC_IRQn);
+	FocTimer = htim;
+	FocAdc = hadc;
+	FocReset(&Foc, config, (uint16_t)__HAL_TIM_GET_AUTORELOAD(htim));
+
+	/* Center aligned counters update at both ends, keep one update per period */
+	htim->Instance->RCR = 1U;
+	/* Master mode update (TIM_TRGO_UPDATE), its bit names are missing from the device header */
+	MODIFY_REG(htim->Instance->CR2, TIM_CR2_MMS_Msk, 2UL << TIM_CR2_MMS_Pos);
+
+	__HAL_ADC_DISABLE_IT(hadc, ADC_IT_CONTINUE);
+	__HAL_ADC_CLEAR_FLAG(hadc, ADC_INTFLAG_CONTINUE);
+	__HAL_ADC_ENABLE_IT(hadc, ADC_IT_CONTINUE);
+	HAL_NVIC_SetPriority(ADC_IRQn, FOC_IRQ_PRIORITY);
+	HAL_NVIC_EnableIRQ(ADC_IRQn);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Starts the motor
+  * @note   The PWM starts with the main output disabled while the current
+  *         offsets are measured, then the outputs are enabled in the open loop
+  *         start (sensorless) or the closed loop (external angle). The
+  *         references are cleared.
+  * @param  None
+  * @retval HAL status
+  */
+HAL_StatusTypeDef FocStart(void)
+{
+	uint32_t half;
+
+	if((FocTimer == NULL) || (Foc.State != FOC_STATE_IDLE))
+	{
+		return HAL_ERROR;
+	}
+
+	FocReset(&Foc, &Foc.Config, Foc.Period);
+	FocOffsetA = 0;
+	FocOffsetB = 0;
+	FocCalibrationCount = 0;
+	Foc.State = FOC_STATE_CALIBRATE;
+
+	half = (uint32_t)Foc.Period >> 1;
+	__HAL_TIM_SET_COMPARE(FocTimer, TIM_CHANNEL_1, half);
+	__HAL_TIM_SET_COMPARE(FocTimer, TIM_CHANNEL_2, half);
+	__HAL_TIM_SET_COMPARE(FocTimer, TIM_CHANNEL_3, half);
+	/* Loads the repetition counter, then the counter starts */
+	FocTimer->Instance->EGR = TIM_EGR_UG;
+	HAL_TIM_PWM_Start(FocTimer, TIM_CHANNEL_1);
+	HAL_TIM_PWM_Start(FocTimer, TIM_CHANNEL_2);
+	HAL_TIM_PWM_Start(FocTimer, TIM_CHANNEL_3);
+	HAL_TIM_PWMN_Start(FocTimer, TIM_CHANNEL_1);
+	HAL_TIM_PWMN_Start(FocTimer, TIM_CHANNEL_2);
+	HAL_TIM_PWMN_Start(FocTimer, TIM_CHANNEL_3);
+	__HAL_TIM_MOE_DISABLE_UNCONDITIONALLY(FocTimer);
+
+	if(HAL_ADC_Start(FocAdc) != HAL_OK)
+	{
+		FocStop();
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+/**
+  * @brief  Stops the motor, the outputs are disabled at once
+  * @param  None
+  * @retval None
+  */
+void FocStop(void)
+{
+	if(FocTimer == NULL)
+	{
+		return;
+	}
+
+	__HAL_TIM_MOE_DISABLE_UNCONDITIONALLY(FocTimer);
+	Foc.State = FOC_STATE_IDLE;
+	HAL_ADC_Stop(FocAdc);
+	HAL_TIM_PWMN_Stop(FocTimer, TIM_CHANNEL_1);
+	HAL_TIM_PWMN_Stop(FocTimer, TIM_CHANNEL_2);
+	HAL_TIM_PWMN_Stop(FocTimer, TIM_CHANNEL_3);
+	HAL_TIM_PWM_Stop(FocTimer, TIM_CHANNEL_1);
+	HAL_TIM_PWM_Stop(FocTimer, TIM_CHANNEL_2);
+	HAL_TIM_PWM_Stop(FocTimer, TIM_CHANNEL_3);
+}
+
+/**
+  * @brief  Sets the Iq reference, used in FOC_MODE_CURRENT
+  * @param  iq: current in q15, limited to CurrentMax
+  * @retval None
+  */
+void FocSetCurrent(int16_t iq)
+{
+	Foc.IqRef = iq;
+}
+
+/**
+  * @brief  Sets the speed reference, used in FOC_MODE_SPEED
+  * @param  speed: electrical speed, 1/2^32 turn per PWM period
+  * @retval None
+  */
+void FocSetSpeed(int32_t speed)
+{
+	Foc.SpeedRef = speed;
+}
+
+/**
+  * @brief  Gives the rotor angle, FOC_ANGLE_EXTERNAL
+  * @note   Called from the hall or encoder handler at each new position, the
+  *         angle is extrapolated with the speed until the next call.
+  * @param  angle: electrical angle, 65536 per turn
+  * @param  speed: electrical speed, 1/2^32 turn per PWM period
+  * @retval None
+  */
+void FocSetAngle(uint16_t angle, int32_t speed)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	Foc.ExtAngle = (uint32_t)angle << 16;
+	Foc.ExtSpeed = speed;
+	__set_PRIMASK(primask);
+}
+
+/**
+  * @brief  ADC interrupt service, call it from ADC_IRQHandler()
+  * @param  None
+  * @retval None
+  */
+void FocAdcIRQHandler(void)
+{
+	volatile uint32_t *result = &FocAdc->Instance->RESULT0;
+	int32_t rawA;
+	int32_t rawB;
+	int16_t ia;
+	int16_t ib;
+	uint16_t duty[3];
+
+	__HAL_ADC_CLEAR_FLAG(FocAdc, ADC_INTFLAG_CONTINUE);
+	rawA = (int32_t)(result[Foc.Config.ChannelA] & ADC_RESULT0_Result0_Msk);
+	rawB = (int32_t)(result[Foc.Config.ChannelB] & ADC_RESULT0_Result0_Msk);
+
+	if(Foc.State == FOC_STATE_CALIBRATE)
+	{
+		FocOffsetA += (uint32_t)rawA;
+		FocOffsetB += (uint32_t)rawB;
+		if(++FocCalibrationCount == FOC_CALIBRATION_SAMPLES)
+		{
+			FocOffsetA /= FOC_CALIBRATION_SAMPLES;
+			FocOffsetB /= FOC_CALIBRATION_SAMPLES;
+			Foc.State = (Foc.Config.AngleSource == FOC_ANGLE_SENSORLESS) ? FOC_STATE_STARTUP : FOC_STATE_RUN;
+			__HAL_TIM_MOE_ENABLE(FocTimer);
+		}
+		return;
+	}
+	if(Foc.State == FOC_STATE_IDLE)
+	{
+		return;
+	}
+
+	ia = (int16_t)FocSat16(((rawA - (int32_t)FocOffsetA) * Foc.Config.CurrentGain) >> 11);
+	ib = (int16_t)FocSat16(((rawB - (int32_t)FocOffsetB) * Foc.Config.CurrentGain) >> 11);
+	FocStep(&Foc, ia, ib, duty);
+	FocTimer->Instance->CCR1 = duty[0];
+	FocTimer->Instance->CCR2 = duty[1];
+	FocTimer->Instance->CCR3 = duty[2];
+}
+
+/**
+  * @brief  Controller state, references and measures, read only
+  * @param  None
+  * @retval controller
+  */
+const FocTypeDef *FocGetState(void)
+{
+	return &Foc;
+}
+#endif
@@ -0,0 +1,169 @@
+/**
+  ******************************************************************************
+  * @file    foc.h
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Header file of field oriented motor control module.
+  ******************************************************************************
+  */
+
+#ifndef __CX32L003_FOC_H
+#define __CX32L003_FOC_H
+
+/* Includes ------------------------------------------------------------------*/
+#if defined(FOC_HOST_SIM)
+#include <stdint.h>
+#else
+#include "cx32l003_hal.h"
+#endif
+
+/*
+ * Field oriented control of a 3 phase PMSM or BLDC motor on the TIM1
+ * complementary outputs, in q15 fixed point.
+ * TIM1 runs center aligned with CH1..CH3 and CH1N..CH3N and dead time, set up
+ * by the application (HAL_TIM_PWM_Init, HAL_TIM_PWM_ConfigChannel,
+ * HAL_TIM_ConfigBreakDeadTime). FocInit() makes the update event of the
+ * counter underflow, once per PWM period, the TIM1 TRGO: it triggers the ADC
+ * conversion of the phase A and B low side shunt currents while all the low
+ * side switches conduct. The ADC is initialized by the application in
+ * continuous mode on these 2 channels, ExternalTrigConv1 = ADC_EXTTRIG1_TIM1_TRGO.
+ * Every control step runs in the ADC end of continuous conversion interrupt:
+ *   currents     Clarke transform to alpha/beta, Park transform to d/q
+ *   angle        sensorless: flux observer and PLL, started in open loop (I/f)
+ *                external: hall or encoder angle given by FocSetAngle(), the
+ *                angle is extrapolated with the given speed between two calls
+ *   loops        PI on Id and Iq, PI on the speed every FOC_SPEED_DIVIDER steps
+ *   modulation   inverse Park, space vector PWM by min-max injection
+ * The new duty cycles are preloaded and take effect at the next period.
+ * Per unit q15 scales: currents 1.0 = ADC full scale current, voltages 1.0 =
+ * bus voltage, angles 65536 = one electrical turn, speeds in 1/2^32 electrical
+ * turn per PWM period. There is no division and no table larger than the
+ * 65 point quarter sine in the interrupt: the step takes about 650 cycles,
+ * a little over half of a 20 kHz period at 24 MHz (estimated, see FocStep()).
+ * FocStep() is pure arithmetic: with FOC_HOST_SIM defined the module builds on
+ * a PC without the HAL, see Utilities/FocSim for the motor model that drives it.
+ */
+
+/* Speed loop runs once every FOC_SPEED_DIVIDER control steps, a power of two */
+#define FOC_SPEED_DIVIDER				16U
+#define FOC_SPEED_DIVIDER_SHIFT	4U
+/* Speed errors are divided by 2^FOC_SPEED_SHIFT before the speed PI */
+#define FOC_SPEED_SHIFT					12U
+/* Flux observer integrator leak, corner frequency PWM frequency / 2^n / 2 pi */
+#define FOC_FLUX_LEAK_SHIFT			11U
+/* ADC samples averaged for the current offsets */
+#define FOC_CALIBRATION_SAMPLES	64U
+/* Priority of the ADC interrupt */
+#define FOC_IRQ_PRIORITY				PRIORITY_HIGHEST
+
+/* Angle sources */
+#define FOC_ANGLE_SENSORLESS		0U		/* Flux observer and PLL, open loop start */
+#define FOC_ANGLE_EXTERNAL			1U		/* FocSetAngle() from a hall or encoder handler */
+
+/* Control modes */
+#define FOC_MODE_CURRENT				0U		/* Iq reference set by FocSetCurrent() */
+#define FOC_MODE_SPEED					1U		/* Speed reference set by FocSetSpeed() */
+
+/* States */
+#define FOC_STATE_IDLE					0U		/* Outputs off */
+#define FOC_STATE_CALIBRATE			1U		/* Outputs off, current offsets measured */
+#define FOC_STATE_STARTUP				2U		/* Open loop ramp, sensorless only */
+#define FOC_STATE_RUN						3U		/* Closed loop */
+
+/* PI gains, out = (Kp * err + sum(Ki * err)) / 2^Shift */
+typedef struct
+{
+	int16_t Kp;
+	int16_t Ki;
+	uint8_t Shift;								/* At most 15 */
+} FocGainsTypeDef;
+
+/* PI state */
+typedef struct
+{
+	FocGainsTypeDef Gains;
+	int32_t Integral;							/* Integral term scaled by 2^Shift */
+} FocPiTypeDef;
+
+/* Motor and control parameters, per unit q15 */
+typedef struct
+{
+	uint32_t ChannelA;						/* ADC channel of the phase A current, 0 to 7 */
+	uint32_t ChannelB;						/* ADC channel of the phase B current, 0 to 7 */
+	int16_t CurrentGain;					/* 32767 maps +/-2048 ADC counts to +/-1.0, negative for inverting amplifiers */
+	uint8_t AngleSource;					/* FOC_ANGLE_xxx */
+	uint8_t Mode;									/* FOC_MODE_xxx */
+	FocGainsTypeDef CurrentPi;		/* Id and Iq loops, output in voltage */
+	FocGainsTypeDef SpeedPi;			/* Speed loop, output in current */
+	int16_t CurrentMax;						/* Iq reference limit */
+	int16_t VoltageMax;						/* Voltage vector limit, at most 18918 (1 / sqrt(3)) */
+	int16_t Rs;										/* Phase resistance, R * Ibase / Vbase in q15 */
+	int16_t Ls;										/* Phase inductance, L * Ibase / (Vbase * Tpwm) in q8 */
+	uint8_t FluxShift;						/* Observer flux scaled down by 2^FluxShift to about 0.5 */
+	int32_t PllKp;								/* PLL gains, speed units per unit of angle error */
+	int32_t PllKi;
+	int32_t StartupSpeed;					/* Open loop end speed, its sign gives the direction */
+	int32_t StartupAccel;					/* Open loop speed increment per step, same sign */
+	int16_t StartupCurrent;				/* Open loop Iq */
+} FocConfigTypeDef;
+
+/* Controller state */
+typedef struct
+{
+	FocConfigTypeDef Config;
+	uint16_t Period;							/* TIM1 auto reload value */
+	int32_t VoltageMaxInv;				/* 2^30 / VoltageMax */
+	volatile uint32_t State;			/* FOC_STATE_xxx */
+	/* References */
+	volatile int16_t IdRef;
+	volatile int16_t IqRef;
+	volatile int32_t SpeedRef;
+	/* Measures */
+	int16_t Ialpha;
+	int16_t Ibeta;
+	int16_t Id;
+	int16_t Iq;
+	int16_t Vd;
+	int16_t Vq;
+	int16_t Valpha;
+	int16_t Vbeta;
+	uint32_t Angle;								/* Angle used by the transforms, 2^32 per turn */
+	int32_t Speed;								/* Speed used by the speed loop */
+	/* Loops */
+	FocPiTypeDef PiD;
+	FocPiTypeDef PiQ;
+	FocPiTypeDef PiSpeed;
+	int32_t SpeedSum;
+	uint32_t SpeedCount;
+	/* Open loop start */
+	uint32_t OpenAngle;
+	int32_t OpenSpeed;
+	/* Flux observer and PLL */
+	int32_t FluxAlpha;
+	int32_t FluxBeta;
+	uint32_t PllAngle;
+	int32_t PllSpeed;
+	int32_t PllIntegral;
+	/* External angle, written by FocSetAngle() */
+	volatile uint32_t ExtAngle;
+	volatile int32_t ExtSpeed;
+} FocTypeDef;
+
+
+void FocReset(FocTypeDef *foc, const FocConfigTypeDef *config, uint16_t period);
+void FocStep(FocTypeDef *foc, int16_t ia, int16_t ib, uint16_t *pDuty);
+int16_t FocSin(uint32_t angle);
+int16_t FocCos(uint32_t angle);
+
+#if !defined(FOC_HOST_SIM)
+HAL_StatusTypeDef FocInit(TIM_HandleTypeDef *htim, ADC_HandleTypeDef *hadc, const FocConfigTypeDef *config);
+HAL_StatusTypeDef FocStart(void);
+void FocStop(void);
+void FocSetCurrent(int16_t iq);
+void FocSetSpeed(int32_t speed);
+void FocSetAngle(uint16_t angle, int32_t speed);
+void FocAdcIRQHandler(void);
+const FocTypeDef *FocGetState(void);
+#endif
+#endif /* __CX32L003_FOC_H */
@@ -0,0 +1,467 @@
+/**
+  ******************************************************************************
+  * @file    kvstore.c
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Flash key/value store module, see kvstore.h for the layout.
+  *          The functions are not reentrant, do not call them from interrupts.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "kvstore.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define KV_MAGIC							0x3153564BU		/* "KVS1" */
+#define KV_NONE								0xFFFFU				/* Key not in the index */
+#define KV_TOMBSTONE					0xFFU					/* Length of a delete record */
+#define KV_ERASED_WORD				0xFFFFFFFFU
+
+/* Private macro -------------------------------------------------------------*/
+#define KV_PAGE_ADDR(page)		(KV_FLASH_BASE + ((uint32_t)(page) * KV_PAGE_SIZE))
+#define KV_NEXT_PAGE(page)		((uint8_t)(((page) + 1U) % KV_PAGE_COUNT))
+#define KV_WORD(addr)					(*(const uint32_t *)KV_FLASH_PTR(addr))
+
+/* Private variables ---------------------------------------------------------*/
+/* Offset from KV_FLASH_BASE of the latest record of each key */
+static uint16_t KvIndex[KV_MAX_KEYS];
+static uint8_t KvActive = 0;
+static uint16_t KvWriteOffset = KV_PAGE_SIZE;
+static uint32_t KvSequence = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t KvIsBlank(uint32_t addr, uint32_t len);
+static uint8_t KvPageIsValid(uint8_t page);
+static HAL_StatusTypeDef KvErasePage(uint8_t page);
+static uint16_t KvRecordCrc(uint8_t key, uint8_t len, const uint8_t *data);
+static uint16_t KvScanPage(uint8_t page);
+static HAL_StatusTypeDef KvProgramRecord(uint32_t addr, uint8_t key, uint8_t len, const uint8_t *data);
+static HAL_StatusTypeDef KvAppend(uint8_t key, uint8_t len, const uint8_t *data);
+static HAL_StatusTypeDef KvRotate(void);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Checks that a flash area is erased
+  * @param  addr: word aligned start address
+  * @param  len: length in bytes, multiple of 4
+  * @retval 1 if every word reads 0xFFFFFFFF
+  */
+static uint8_t KvIsBlank(uint32_t addr, uint32_t len)
+{
+	for(; len != 0U; len -= 4U, addr += 4U)
+	{
+		if(KV_WORD(addr) != KV_ERASED_WORD)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+  * @brief  Checks that a page has been committed
+  * @param  page: page number in the ring
+  * @retval 1 if the magic word is present
+  */
+static uint8_t KvPageIsValid(uint8_t page)
+{
+	return (uint8_t)(KV_WORD(KV_PAGE_ADDR(page) + 4U) == KV_MAGIC);
+}
+
+/**
+  * @brief  Erases one page of the ring unless it is already blank
+  * @note   A committed page is retired first by clearing its magic word: an
+  *         interrupted erase leaves any word in any state, it must not leave
+  *         the magic word next to a damaged sequence number.
+  * @param  page: page number in the ring
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KvErasePage(uint8_t page)
+{
+	static const uint8_t retired[4] = {0, 0, 0, 0};
+	FLASH_EraseInitTypeDef erase;
+	uint32_t error = 0;
+
+	if(KvIsBlank(KV_PAGE_ADDR(page), KV_PAGE_SIZE))
+	{
+		return HAL_OK;
+	}
+
+	if(KvPageIsValid(page))
+	{
+		if(HAL_FLASH_ProgramBuffer(KV_PAGE_ADDR(page) + 4U, retired, sizeof(retired)) != HAL_OK)
+		{
+			return HAL_ERROR;
+		}
+	}
+
+	erase.TypeErase = FLASH_TYPEERASE_PAGES;
+	erase.PageAddress = KV_PAGE_ADDR(page);
+	erase.NbPages = 1;
+	if(HAL_FLASH_Erase(&erase, &error) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+	return KvIsBlank(KV_PAGE_ADDR(page), KV_PAGE_SIZE) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+  * @brief  Computes the CRC16 protecting a record
+  * @param  key: record key
+  * @param  len: record length or KV_TOMBSTONE
+  * @param  data: record data, unused for a tombstone
+  * @retval CRC16 value
+  */
+static uint16_t KvRecordCrc(uint8_t key, uint8_t len, const uint8_t *data)
+{
+	uint8_t head[2];
+	uint32_t crc;
+
+	head[0] = key;
+	head[1] = len;
+	crc = HAL_CRC_SW_Accumulate(CRC_SW_INIT_VALUE, head, 2);
+	if(len != KV_TOMBSTONE)
+	{
+		crc = HAL_CRC_SW_Accumulate(crc, data, len);
+	}
+	return (uint16_t)crc;
+}
+
+/**
+  * @brief  Walks the records of a page and updates the index with them
+  * @note   A record with an invalid header or CRC can only be the one a power
+  *         cut interrupted, the page is then closed: nothing is appended to it.
+  * @param  page: page number in the ring
+  * @retval Offset of the first free byte in the page, KV_PAGE_SIZE if closed
+  */
+static uint16_t KvScanPage(uint8_t page)
+{
+	uint32_t base = KV_PAGE_ADDR(page);
+	uint32_t offset = KV_PAGE_HEADER_SIZE;
+	uint32_t header, size;
+	uint8_t key, len;
+
+	while(offset < KV_PAGE_SIZE)
+	{
+		header = KV_WORD(base + offset);
+		if(header == KV_ERASED_WORD)
+		{
+			/* End of the log, the rest must be blank to be usable */
+			if(!KvIsBlank(base + offset, KV_PAGE_SIZE - offset))
+			{
+				offset = KV_PAGE_SIZE;
+			}
+			break;
+		}
+
+		key = (uint8_t)header;
+		len = (uint8_t)(header >> 8);
+		size = (len == KV_TOMBSTONE) ? 4U : KV_RECORD_SIZE(len);
+		if((key >= KV_MAX_KEYS) || ((len > KV_MAX_VALUE_SIZE) && (len != KV_TOMBSTONE)) ||
+			 ((offset + size) > KV_PAGE_SIZE) ||
+			 (KvRecordCrc(key, len, KV_FLASH_PTR(base + offset + 4U)) != (uint16_t)(header >> 16)))
+		{
+			offset = KV_PAGE_SIZE;
+			break;
+		}
+
+		KvIndex[key] = (len == KV_TOMBSTONE) ? KV_NONE : (uint16_t)((uint32_t)page * KV_PAGE_SIZE + offset);
+		offset += size;
+	}
+	return (uint16_t)offset;
+}
+
+/**
+  * @brief  Programs one record, data first and header word last
+  * @param  addr: flash address of the record header
+  * @param  key: record key
+  * @param  len: record length or KV_TOMBSTONE
+  * @param  data: record data
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KvProgramRecord(uint32_t addr, uint8_t key, uint8_t len, const uint8_t *data)
+{
+	uint8_t header[4];
+	uint16_t crc = KvRecordCrc(key, len, data);
+
+	if((len != KV_TOMBSTONE) && (len != 0U))
+	{
+		if(HAL_FLASH_ProgramBuffer(addr + 4U, data, len) != HAL_OK)
+		{
+			return HAL_ERROR;
+		}
+	}
+
+	header[0] = key;
+	header[1] = len;
+	header[2] = (uint8_t)crc;
+	header[3] = (uint8_t)(crc >> 8);
+	return HAL_FLASH_ProgramBuffer(addr, header, 4);
+}
+
+/**
+  * @brief  Appends a record to the active page, rotating first if it is full
+  * @param  key: record key
+  * @param  len: record length or KV_TOMBSTONE
+  * @param  data: record data
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KvAppend(uint8_t key, uint8_t len, const uint8_t *data)
+{
+	uint32_t size = (len == KV_TOMBSTONE) ? 4U : KV_RECORD_SIZE(len);
+
+	if((KvWriteOffset + size) > KV_PAGE_SIZE)
+	{
+		if(KvRotate() != HAL_OK)
+		{
+			return HAL_ERROR;
+		}
+	}
+
+	if(KvProgramRecord(KV_PAGE_ADDR(KvActive) + KvWriteOffset, key, len, data) != HAL_OK)
+	{
+		/* Whatever got programmed fails its CRC, the scan closes the page */
+		return HAL_ERROR;
+	}
+
+	KvIndex[key] = (len == KV_TOMBSTONE) ? KV_NONE : (uint16_t)((uint32_t)KvActive * KV_PAGE_SIZE + KvWriteOffset);
+	KvWriteOffset += (uint16_t)size;
+	return HAL_OK;
+}
+
+/**
+  * @brief  Moves to the spare page and reclaims the oldest page
+  * @note   The live records of the oldest page are copied into the spare page,
+  *         the spare page is committed, then the oldest page is erased. With
+  *         two pages the oldest page is the active one.
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef KvRotate(void)
+{
+	uint8_t spare = KV_NEXT_PAGE(KvActive);
+	uint8_t oldest = KV_NEXT_PAGE(spare);
+	uint32_t offset = KV_PAGE_HEADER_SIZE;
+	uint32_t record, header;
+	uint8_t key, len;
+	uint8_t page_header[KV_PAGE_HEADER_SIZE];
+	uint32_t sequence = KvSequence + 1U;
+
+	if(KvPageIsValid(oldest))
+	{
+		for(key = 0; key < KV_MAX_KEYS; key++)
+		{
+			if((KvIndex[key] == KV_NONE) || ((KvIndex[key] / KV_PAGE_SIZE) != oldest))
+			{
+				continue;
+			}
+
+			record = KV_FLASH_BASE + KvIndex[key];
+			header = KV_WORD(record);
+			len = (uint8_t)(header >> 8);
+			if(KvProgramRecord(KV_PAGE_ADDR(spare) + offset, key, len, KV_FLASH_PTR(record + 4U)) != HAL_OK)
+			{
+				return HAL_ERROR;
+			}
+			KvIndex[key] = (uint16_t)((uint32_t)spare * KV_PAGE_SIZE + offset);
+			offset += KV_RECORD_SIZE(len);
+		}
+	}
+
+	/* Commit point: the magic word is programmed last */
+	page_header[0] = (uint8_t)sequence;
+	page_header[1] = (uint8_t)(sequence >> 8);
+	page_header[2] = (uint8_t)(sequence >> 16);
+	page_header[3] = (uint8_t)(sequence >> 24);
+	page_header[4] = (uint8_t)KV_MAGIC;
+	page_header[5] = (uint8_t)(KV_MAGIC >> 8);
+	page_header[6] = (uint8_t)(KV_MAGIC >> 16);
+	page_header[7] = (uint8_t)(KV_MAGIC >> 24);
+	if(HAL_FLASH_ProgramBuffer(KV_PAGE_ADDR(spare), page_header, KV_PAGE_HEADER_SIZE) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+
+	KvActive = spare;
+	KvSequence = sequence;
+	KvWriteOffset = (uint16_t)offset;
+
+	/* Everything still needed from the oldest page now lives in the new one */
+	return KvErasePage(oldest);
+}
+
+/**
+  * @brief  Mounts the store and builds the RAM index
+  * @note   Finishes any rotation a power cut interrupted. A store without any
+  *         committed page is formatted.
+  * @param  None
+  * @retval HAL status
+  */
+HAL_StatusTypeDef KvInit(void)
+{
+	uint8_t page, key, found = 0;
+	uint32_t sequence;
+
+	for(page = 0; page < KV_PAGE_COUNT; page++)
+	{
+		if(KvPageIsValid(page))
+		{
+			sequence = KV_WORD(KV_PAGE_ADDR(page));
+			if(!found || (sequence > KvSequence))
+			{
+				KvActive = page;
+				KvSequence = sequence;
+				found = 1;
+			}
+		}
+	}
+	if(!found)
+	{
+		return KvFormat();
+	}
+
+	for(key = 0; key < KV_MAX_KEYS; key++)
+	{
+		KvIndex[key] = KV_NONE;
+	}
+
+	/* Oldest to newest, the page after the active one is the spare */
+	page = KV_NEXT_PAGE(KV_NEXT_PAGE(KvActive));
+	for(;;)
+	{
+		if(page == KvActive)
+		{
+			KvWriteOffset = KvScanPage(page);
+			break;
+		}
+		if(KvPageIsValid(page))
+		{
+			(void)KvScanPage(page);
+		}
+		page = KV_NEXT_PAGE(page);
+	}
+
+	/* Either a reclaimed page whose erase was cut, or an uncommitted copy */
+	return KvErasePage(KV_NEXT_PAGE(KvActive));
+}
+
+/**
+  * @brief  Erases the whole store
+  * @param  None
+  * @retval HAL status
+  */
+HAL_StatusTypeDef KvFormat(void)
+{
+	uint8_t page, key;
+
+	for(key = 0; key < KV_MAX_KEYS; key++)
+	{
+		KvIndex[key] = KV_NONE;
+	}
+	for(page = 0; page < KV_PAGE_COUNT; page++)
+	{
+		if(KvErasePage(page) != HAL_OK)
+		{
+			return HAL_ERROR;
+		}
+	}
+
+	/* Rotating from the last page commits page 0 with sequence 1 */
+	KvActive = KV_PAGE_COUNT - 1;
+	KvSequence = 0;
+	return KvRotate();
+}
+
+/**
+  * @brief  Stores a value
+  * @note   Nothing is programmed when the stored value is already identical.
+  * @param  key: 0 to KV_MAX_KEYS - 1
+  * @param  pData: value
+  * @param  length: value length, up to KV_MAX_VALUE_SIZE
+  * @retval HAL status
+  */
+HAL_StatusTypeDef KvWrite(uint8_t key, const void *pData, uint8_t length)
+{
+	uint32_t record;
+
+	if((key >= KV_MAX_KEYS) || (length > KV_MAX_VALUE_SIZE) || ((pData == NULL) && (length != 0U)))
+	{
+		return HAL_ERROR;
+	}
+
+	if(KvIndex[key] != KV_NONE)
+	{
+		record = KV_FLASH_BASE + KvIndex[key];
+		if(((uint8_t)(KV_WORD(record) >> 8) == length) &&
+			 ((length == 0U) || (memcmp(KV_FLASH_PTR(record + 4U), pData, length) == 0)))
+		{
+			return HAL_OK;
+		}
+	}
+
+	if(KvAppend(key, length, (const uint8_t *)pData) != HAL_OK)
+	{
+		/* Rebuild the index from what actually reached the flash */
+		(void)KvInit();
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
+
+/**
+  * @brief  Reads a value from the index, the flash is not searched
+  * @param  key: 0 to KV_MAX_KEYS - 1
+  * @param  pData: destination
+  * @param  size: destination size, at least the stored length
+  * @param  pLength: returns the stored length, may be NULL
+  * @retval HAL_ERROR if the key is not stored or does not fit
+  */
+HAL_StatusTypeDef KvRead(uint8_t key, void *pData, uint8_t size, uint8_t *pLength)
+{
+	uint32_t record;
+	uint8_t len;
+
+	if((key >= KV_MAX_KEYS) || (KvIndex[key] == KV_NONE))
+	{
+		return HAL_ERROR;
+	}
+
+	record = KV_FLASH_BASE + KvIndex[key];
+	len = (uint8_t)(KV_WORD(record) >> 8);
+	if(pLength != NULL)
+	{
+		*pLength = len;
+	}
+	if(len > size)
+	{
+		return HAL_ERROR;
+	}
+	memcpy(pData, KV_FLASH_PTR(record + 4U), len);
+	return HAL_OK;
+}
+
+/**
+  * @brief  Removes a key
+  * @param  key: 0 to KV_MAX_KEYS - 1
+  * @retval HAL status
+  */
+HAL_StatusTypeDef KvDelete(uint8_t key)
+{
+	if(key >= KV_MAX_KEYS)
+	{
+		return HAL_ERROR;
+	}
+	if(KvIndex[key] == KV_NONE)
+	{
+		return HAL_OK;
+	}
+
+	if(KvAppend(key, KV_TOMBSTONE, NULL) != HAL_OK)
+	{
+		(void)KvInit();
+		return HAL_ERROR;
+	}
+	return HAL_OK;
+}
@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    kvstore.h
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Header file of flash key/value store module.
+  ******************************************************************************
+  */
+
+#ifndef __CX32L003_KVSTORE_H
+#define __CX32L003_KVSTORE_H
+
+/* Includes ------------------------------------------------------------------*/
+#if defined(KV_HOST_SIM)
+#include "kv_sim_hal.h"
+#else
+#include "cx32l003_hal.h"
+#endif
+
+/*
+ * Log structured key/value store, the EEPROM emulation on the on-chip flash.
+ * KV_PAGE_COUNT pages starting at KV_FLASH_BASE form a ring, they are used
+ * one after the other and exactly one page, the one after the active page,
+ * is always kept erased. A page starts with a sequence word and a magic word,
+ * then records are appended, each record being:
+ *   header word: bit 7..0 key, bit 15..8 length, bit 31..16 CRC16
+ *   data:        length bytes, padded to a word
+ * The CRC covers key, length and data. The data is programmed first and the
+ * header word last, so a record only exists once it is completely written.
+ * A page becomes valid the same way, its magic word is programmed last.
+ * When the active page is full, the live records of the oldest page are copied
+ * into the spare page, the spare page is committed with the next sequence
+ * number and only then the oldest page is retired (magic word cleared) and
+ * erased to become the new spare.
+ * A power cut at any point leaves either the old or the new state.
+ * KvInit() rebuilds the RAM index (one offset per key) from a scan, reads are
+ * then served directly through the index without searching the flash.
+ * The CRC and FLASH HAL modules must be enabled.
+ * With KV_HOST_SIM defined the module builds on a PC against a simulated
+ * flash, see Utilities/KvSim for the harness that cuts the power at every
+ * program and erase step.
+ */
+
+/* First byte of the store, page aligned, must not overlap the program */
+#ifndef KV_FLASH_BASE
+	#define KV_FLASH_BASE				(FLASH_SIZE_32K - (KV_PAGE_COUNT * KV_PAGE_SIZE))
+#endif
+/* Number of pages in the ring, at least 2 */
+#define KV_PAGE_COUNT					4
+#define KV_PAGE_SIZE					FLASH_PAGE_SIZE
+/* Keys are 0 to KV_MAX_KEYS - 1 */
+#define KV_MAX_KEYS						16
+/* Largest value in bytes */
+#define KV_MAX_VALUE_SIZE			24
+
+/* Memory mapped access to the store, may be redirected for a host build */
+#ifndef KV_FLASH_PTR
+	#define KV_FLASH_PTR(addr)		((const uint8_t *)(addr))
+#endif
+
+#define KV_PAGE_HEADER_SIZE		8U
+#define KV_RECORD_SIZE(len)		(4U + (((len) + 3U) & ~3U))
+
+#if (KV_PAGE_COUNT < 2)
+	#error "KV_PAGE_COUNT must be at least 2"
+#endif
+/* All live values plus one more record must fit a fresh page */
+#if (((KV_MAX_KEYS + 1) * KV_RECORD_SIZE(KV_MAX_VALUE_SIZE)) > (KV_PAGE_SIZE - KV_PAGE_HEADER_SIZE))
+	#error "KV_MAX_KEYS * KV_MAX_VALUE_SIZE does not fit in one page"
+#endif
+#if (KV_MAX_KEYS > 255) || (KV_MAX_VALUE_SIZE > 254)
+	#error "Key and length must fit in one byte"
+#endif
+
+
+HAL_StatusTypeDef KvInit(void);
+HAL_StatusTypeDef KvFormat(void);
+HAL_StatusTypeDef KvWrite(uint8_t key, const void *pData, uint8_t length);
+HAL_StatusTypeDef KvRead(uint8_t key, void *pData, uint8_t size, uint8_t *pLength);
+HAL_StatusTypeDef KvDelete(uint8_t key);
+#endif /* __CX32L003_KVSTORE_H */
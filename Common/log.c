@@ -6,9 +6,19 @@
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+#ifdef LOG_DEFERRED
+static uint8_t LogTxBuffer[LOG_TX_BUFFER_SIZE];
+static uint8_t LogRxBuffer[LOG_RX_BUFFER_SIZE];
+static uint32_t LogDropped = 0;
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
 static void SerialInit(uint32_t baud_rate);
 static void SerialSend(uint8_t data);
+static void SerialWrite(const uint8_t *data, uint16_t len);
+#ifdef LOG_DEFERRED
+static void SerialPoll(void);
+#endif
 
 /* Private functions ---------------------------------------------------------*/
 /**
@@ -29,6 +39,9 @@ static void Log_UART_SetConfig(UART_HandleTypeDef *huart)
   /*-------------------------- UART BAUDCR Configuration ---------------------*/
   huart->Instance->BAUDCR = (((((huart->Init.BaudDouble >> UART_SCON_DBAUD_Pos)+1)*HAL_RCC_GetPCLKFreq())/(32*(huart->Init.BaudRate))-1) & UART_BAUDCR_BRG) | UART_BAUDCR_SELF_BRG;	
 
+  /* The handle is used with the HAL transfer functions */
+  HAL_UART_BindByteHandlers(huart);
+
 	__HAL_UART_ENABLE_IT(huart, UART_IT_TC | UART_IT_RXNE);
 }
 
@@ -43,6 +56,99 @@ void LogInit(void)
 {
 #ifdef LOG_METHOD_SERIAL
 		SerialInit(LOG_SERIAL_BPS);
+	#ifdef LOG_DEFERRED
+		/* From now on printf only copies into LogTxBuffer, UART1 interrupt sends it */
+		HAL_UART_Stream_Start(&huart1, LogTxBuffer, LOG_TX_BUFFER_SIZE, LogRxBuffer, LOG_RX_BUFFER_SIZE);
+		HAL_NVIC_SetPriority(UART1_IRQn, LOG_IRQ_PRIORITY);
+		HAL_NVIC_EnableIRQ(UART1_IRQn);
+	#endif
+#endif
+}
+
+/**
+  * @brief  Log UART interrupt service, call it from UART1_IRQHandler()
+  * @param  None
+  * @retval None
+  */
+void LogIRQHandler(void)
+{
+	HAL_UART_IRQHandler(&huart1);
+}
+
+/**
+  * @brief  Waits until all queued log output has left the UART
+  * @note   Usable with interrupts masked, e.g. from a fault handler
+  * @param  None
+  * @retval None
+  */
+void LogFlush(void)
+{
+#ifdef LOG_DEFERRED
+	while(huart1.TxRingActive != 0U)
+	{
+		SerialPoll();
+	}
+#endif
+}
+
+/**
+  * @brief  Queues one tokenized record, called through LOG_T()
+  * @note   The header and the arguments are assembled first, then the whole
+  *         record is reserved and copied in one ring write with interrupts
+  *         masked: records and printf text from different contexts never
+  *         interleave and the decoder never finds a header without its arguments.
+  * @param  header: Record header, see LOG_T_HEADER()
+  * @param  args: Argument words, count taken from the header
+  * @retval None
+  */
+void LogTokenWrite(uint32_t header, const uint32_t *args)
+{
+#ifdef LOG_TOKENIZED
+	uint32_t record[LOG_T_MAX_ARGS + 1];
+	uint32_t n = (header >> 24) & 0x0FU;
+	uint32_t i;
+	uint16_t len;
+	uint32_t primask;
+
+	if(n > LOG_T_MAX_ARGS)
+	{
+		return;
+	}
+	record[0] = header;
+	for(i = 0; i < n; i++)
+	{
+		record[i + 1U] = args[i];
+	}
+	len = (uint16_t)((n + 1U) * 4U);
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	if(HAL_UART_GetTxFree(&huart1) >= len)
+	{
+		HAL_UART_Write(&huart1, (const uint8_t *)record, len);
+	}
+	else
+	{
+		LogDropped += len;
+	}
+	__set_PRIMASK(primask);
+#else
+	UNUSED(header);
+	UNUSED(args);
+#endif
+}
+
+/**
+  * @brief  Returns the number of log bytes lost to ring overflow
+  * @param  None
+  * @retval Dropped byte count
+  */
+uint32_t LogGetDropped(void)
+{
+#ifdef LOG_DEFERRED
+	return LogDropped;
+#else
+	return 0;
 #endif
 }
 
@@ -117,8 +223,106 @@ static void SerialInit(uint32_t baud_rate)
 
 void SerialSend(uint8_t data) 
 {
+#ifdef LOG_DEFERRED
+	SerialWrite(&data, 1);
+#else
 	HAL_UART_Transmit(&huart1, &data, 1, 1000);  
-	
+#endif
+}
+
+#ifdef LOG_DEFERRED
+/**
+  * @brief  Serves the UART1 Tx interrupt by polling, the IRQ is masked meanwhile
+  *         so this is safe from any context, including a higher priority ISR.
+  * @param  None
+  * @retval None
+  */
+static void SerialPoll(void)
+{
+	HAL_NVIC_DisableIRQ(UART1_IRQn);
+	if(__HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC))
+	{
+		HAL_UART_IRQHandler(&huart1);
+	}
+	HAL_NVIC_EnableIRQ(UART1_IRQn);
+}
+#endif
+
+/**
+  * @brief  Sends a block of log text according to the configured method
+  * @note   The Tx ring takes one producer at a time: interrupts are masked while
+  *         the bytes are reserved and copied, so printf or LOG_T() from an ISR
+  *         never write into the same bytes as the code they preempt.
+  * @note   Nothing drains the ring before LogInit() or once the stream is
+  *         stopped: the text is then dropped, whatever the policy. With
+  *         LOG_TOKENIZED the ring does not know where the queued records start,
+  *         so LOG_OVERFLOW_DROP_OLD drops the new block whole instead of cutting
+  *         a queued record.
+  * @param  data: Pointer to the text
+  * @param  len: Text length in bytes
+  * @retval None
+  */
+static void SerialWrite(const uint8_t *data, uint16_t len)
+{
+#ifdef LOG_DEFERRED
+	uint32_t primask;
+	uint16_t done;
+
+	#if (LOG_OVERFLOW_POLICY == LOG_OVERFLOW_DROP_OLD) && !defined(LOG_TOKENIZED)
+	uint16_t room;
+
+	if(len > LOG_TX_BUFFER_SIZE)
+	{
+		LogDropped += len - LOG_TX_BUFFER_SIZE;
+		data += len - LOG_TX_BUFFER_SIZE;
+		len = LOG_TX_BUFFER_SIZE;
+	}
+	#endif
+
+	#if (LOG_OVERFLOW_POLICY == LOG_OVERFLOW_BLOCK)
+	while((len != 0U) && (huart1.TxRing.pBuffer != NULL))
+	{
+		primask = __get_PRIMASK();
+		__disable_irq();
+		done = HAL_UART_Write(&huart1, data, len);
+		__set_PRIMASK(primask);
+		data += done;
+		len -= done;
+		if(len != 0U)
+		{
+			SerialPoll();
+		}
+	}
+	LogDropped += len;
+	#else
+	primask = __get_PRIMASK();
+	__disable_irq();
+		#if (LOG_OVERFLOW_POLICY == LOG_OVERFLOW_DROP_OLD) && !defined(LOG_TOKENIZED)
+	/* The Tx interrupt is masked too while the consumer index is moved */
+	room = HAL_UART_GetTxFree(&huart1);
+	if((len > room) && (huart1.TxRing.pBuffer != NULL))
+	{
+		huart1.TxRing.Tail += len - room;
+		LogDropped += len - room;
+	}
+		#elif (LOG_OVERFLOW_POLICY == LOG_OVERFLOW_DROP_OLD)
+	/* Whole blocks only, as LogTokenWrite() does for the records */
+	if(len > HAL_UART_GetTxFree(&huart1))
+	{
+		LogDropped += len;
+		len = 0U;
+	}
+		#endif
+	done = HAL_UART_Write(&huart1, data, len);
+	LogDropped += len - done;
+	__set_PRIMASK(primask);
+	#endif
+#else
+	while(len--)
+	{
+		SerialSend(*data++);
+	}
+#endif
 }
 
 
@@ -128,21 +332,28 @@ int _write(int file, char *data, int len)
 {
 	 int bytes_written;
 
+	 #ifdef LOG_METHOD_SERIAL
+	 int line_start = 0;
+
 	 for (bytes_written = 0; bytes_written < len; bytes_written++)
 	 {
-				#ifdef LOG_METHOD_SERIAL
-				// expand LF to CR-LF
-				if (*data == '\n') {
-						SerialSend('\r');
+				// expand LF to CR-LF, text between line feeds is sent as one block
+				if (data[bytes_written] == '\n') {
+						SerialWrite((const uint8_t *)&data[line_start], bytes_written - line_start);
+						SerialWrite((const uint8_t *)"\r\n", 2);
+						line_start = bytes_written + 1;
 				}
-				SerialSend(*data);
-				#else //Another method to log
+	 }
+	 SerialWrite((const uint8_t *)&data[line_start], bytes_written - line_start);
+	 #else //Another method to log
+	 for (bytes_written = 0; bytes_written < len; bytes_written++)
+	 {
 						#ifdef LOG_METHOD_RAM
 						*LOG_RAM_CHAR = *data;
 						#endif
-				#endif
-				data++;
+						data++;
 	 }
+	 #endif
 
 	 return bytes_written;
 }
@@ -187,5 +398,7 @@ void panic(const char* func)
 {
 	// If panic info enabled, print it out
 	printf("Panic call from %s\n",func);
+	/* Push out everything still queued before the system goes down */
+	LogFlush();
 	/* Add any panic string desired or while loop as needed */
 }
@@ -24,6 +24,91 @@
 #ifdef LOG_METHOD_SERIAL
 	/* Serial port baud rate */
 	#define LOG_SERIAL_BPS 9600
+
+	/* Uncomment to queue log output in RAM and send it from the UART1 interrupt,
+	   LogIRQHandler() must then be called from UART1_IRQHandler() */
+	//#define LOG_DEFERRED
+#endif
+
+/* Overflow policies of the deferred log ring */
+#define LOG_OVERFLOW_DROP_NEW		0		/* Discard the text that does not fit */
+#define LOG_OVERFLOW_DROP_OLD		1		/* Discard the oldest queued text, the new text with LOG_TOKENIZED */
+#define LOG_OVERFLOW_BLOCK			2		/* Wait for the UART to make room, drop before LogInit() */
+
+#ifdef LOG_DEFERRED
+	/* Ring sizes in bytes, must be a power of two */
+	#define LOG_TX_BUFFER_SIZE	512
+	#define LOG_RX_BUFFER_SIZE	16
+	#define LOG_OVERFLOW_POLICY	LOG_OVERFLOW_DROP_NEW
+	#define LOG_IRQ_PRIORITY		PRIORITY_LOWEST
+
+	/* Uncomment to make LOG_T() queue binary records instead of formatting text */
+	//#define LOG_TOKENIZED
+#endif
+
+/* 
+ * Tokenized log: LOG_T(fmt, args...) stores a record made of one header word
+ * and up to 8 raw argument words, each argument is cast to uint32_t. The format
+ * string is never formatted on target, it is kept in the ".log_fmt" section and
+ * the header carries its address:
+ *   bit 31..28: LOG_T_SYNC, bit 27..24: argument count, bit 23..0: format address
+ * Utilities/LogDecoder rebuilds the text from the ELF file and the UART capture,
+ * plain printf text may be interleaved with records.
+ * Supported conversions are integer, char and pointer ones, %s only for strings
+ * located in flash. Records never split, one that does not fit is dropped.
+ * To keep the format strings out of flash, add to the GNU linker script:
+ *   .log_fmt 0 (INFO) : { KEEP(*(.log_fmt)) }
+ * Without LOG_TOKENIZED, LOG_T() falls back to printf().
+ */
+#define LOG_T_SYNC						0xA0000000U
+#define LOG_T_MAX_ARGS				8
+
+#if defined ( __ICCARM__ )
+	#define LOG_FMT_SECTION			_Pragma("location=\".log_fmt\"") __root
+#else
+	#define LOG_FMT_SECTION			__attribute__((section(".log_fmt"), used))
+#endif
+
+#ifdef LOG_TOKENIZED
+	#define LOG_T(...)						LOG_T_CAT(LOG_T_, LOG_T_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#else
+	#define LOG_T(...)						printf(__VA_ARGS__)
+#endif
+
+#define LOG_T_CAT(a, b)					LOG_T_CAT_(a, b)
+#define LOG_T_CAT_(a, b)				a##b
+#define LOG_T_NARGS(...)				LOG_T_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, _)
+#define LOG_T_NARGS_(f, a1, a2, a3, a4, a5, a6, a7, a8, n, ...)	n
+
+#define LOG_T_HEADER(fmt, n)		(LOG_T_SYNC | ((uint32_t)(n) << 24) | ((uint32_t)(fmt) & 0x00FFFFFFU))
+
+#define LOG_T_RECORD(fmt, n, ...)																		\
+	do {																															\
+		LOG_FMT_SECTION static const char _log_fmt[] = fmt;							\
+		const uint32_t _log_arg[] = { __VA_ARGS__ };										\
+		LogTokenWrite(LOG_T_HEADER(_log_fmt, n), _log_arg);							\
+	} while(0)
+
+#define LOG_T_0(fmt)																										\
+	do {																															\
+		LOG_FMT_SECTION static const char _log_fmt[] = fmt;							\
+		LogTokenWrite(LOG_T_HEADER(_log_fmt, 0), NULL);									\
+	} while(0)
+#define LOG_T_1(fmt, a)									LOG_T_RECORD(fmt, 1, (uint32_t)(a))
+#define LOG_T_2(fmt, a, b)							LOG_T_RECORD(fmt, 2, (uint32_t)(a), (uint32_t)(b))
+#define LOG_T_3(fmt, a, b, c)						LOG_T_RECORD(fmt, 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+#define LOG_T_4(fmt, a, b, c, d)				LOG_T_RECORD(fmt, 4, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+#define LOG_T_5(fmt, a, b, c, d, e)			LOG_T_RECORD(fmt, 5, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d), \
+																								(uint32_t)(e))
+#define LOG_T_6(fmt, a, b, c, d, e, f)	LOG_T_RECORD(fmt, 6, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d), \
+																								(uint32_t)(e), (uint32_t)(f))
+#define LOG_T_7(fmt, a, b, c, d, e, f, g)		LOG_T_RECORD(fmt, 7, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d), \
+																								(uint32_t)(e), (uint32_t)(f), (uint32_t)(g))
+#define LOG_T_8(fmt, a, b, c, d, e, f, g, h)	LOG_T_RECORD(fmt, 8, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d), \
+																								(uint32_t)(e), (uint32_t)(f), (uint32_t)(g), (uint32_t)(h))
+
+#if defined(LOG_TOKENIZED) && !defined(LOG_DEFERRED)
+	#error "LOG_TOKENIZED requires LOG_DEFERRED"
 #endif
 
 #ifdef LOG_METHOD_RAM
@@ -36,4 +121,8 @@
 void LogInit(void);
 void logout(bool success);
 void panic(const char* func);
+void LogFlush(void);
+void LogIRQHandler(void);
+uint32_t LogGetDropped(void);
+void LogTokenWrite(uint32_t header, const uint32_t *args);
 #endif /* __XM32F103_LOG_H */
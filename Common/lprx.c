@@ -0,0 +1,270 @@
+/**
+  ******************************************************************************
+  * @file    lprx.c
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   LPUART deep sleep batched receive module, see lprx.h for the wake-up rules.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "lprx.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static LPUART_HandleTypeDef *LpRxUart = NULL;
+static AWK_HandleTypeDef *LpRxAwk = NULL;
+static LpRxConfigTypeDef LpRxConfig;
+/* Ring, Head is advanced by the LPUART interrupt and Tail by LpRxRead() */
+static uint8_t *LpRxBuffer = NULL;
+static uint16_t LpRxMask = 0;
+static volatile uint16_t LpRxHead = 0;
+static volatile uint16_t LpRxTail = 0;
+/* Pending LPRX_EVENT_xxx */
+static volatile uint32_t LpRxEvents = 0;
+static LpRxStatsTypeDef LpRxStats;
+
+/* Private function prototypes -----------------------------------------------*/
+static void LpRxWake(uint32_t event);
+static void LpRxIdleRestart(void);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Records a wake-up event, the core returns to LpRxWait() after the interrupt
+  * @param  event: LPRX_EVENT_xxx
+  * @retval None
+  */
+static void LpRxWake(uint32_t event)
+{
+	LpRxEvents |= event;
+	HAL_PWR_DisableSleepOnExit();
+}
+
+/**
+  * @brief  Restarts the idle timeout
+  * @param  None
+  * @retval None
+  */
+static void LpRxIdleRestart(void)
+{
+	__HAL_AWK_DISABLE(LpRxAwk);
+	/* The counter overflows after 256 - RLOAD periods */
+	__HAL_AWK_SET_RELOAD(LpRxAwk, 256U - LpRxConfig.IdleTicks);
+	__HAL_AWK_CLEAR_IT(LpRxAwk);
+	__HAL_AWK_ENABLE(LpRxAwk);
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Starts the batched receive
+  * @note   The LPUART must be initialized in low power mode from LIRC or LXT and
+  *         the AWK with its clock and divider, their interrupts are then owned
+  *         by this module.
+  * @param  hlpuart: LPUART handle
+  * @param  hawk: AWK handle, may be NULL when IdleTicks is 0
+  * @param  pBuffer: ring storage
+  * @param  size: ring size, a power of two
+  * @param  config: wake conditions, copied
+  * @retval HAL status
+  */
+HAL_StatusTypeDef LpRxInit(LPUART_HandleTypeDef *hlpuart, AWK_HandleTypeDef *hawk, uint8_t *pBuffer, uint16_t size, const LpRxConfigTypeDef *config)
+{
+	if((pBuffer == NULL) || (config == NULL) || (size < 2U) || ((size & (size - 1U)) != 0U) ||
+		 (config->Threshold >= size) || (config->IdleTicks > 256U) || ((config->IdleTicks != 0U) && (hawk == NULL)))
+	{
+		return HAL_ERROR;
+	}
+
+	HAL_NVIC_DisableIRQ(LPUART_IRQn);
+	HAL_NVIC_DisableIRQ(AWK_IRQn);
+
+	LpRxUart = hlpuart;
+	LpRxAwk = hawk;
+	LpRxConfig = *config;
+	LpRxBuffer = pBuffer;
+	LpRxMask = size - 1U;
+	LpRxHead = 0;
+	LpRxTail = 0;
+	LpRxEvents = 0;
+	LpRxStats.Bytes = 0;
+	LpRxStats.Wakeups = 0;
+	LpRxStats.Errors = 0;
+	LpRxStats.Overruns = 0;
+
+	if(config->IdleTicks != 0U)
+	{
+		__HAL_AWK_DISABLE(hawk);
+		__HAL_AWK_CLEAR_IT(hawk);
+		HAL_NVIC_SetPriority(AWK_IRQn, LPRX_IRQ_PRIORITY);
+		HAL_NVIC_EnableIRQ(AWK_IRQn);
+	}
+
+	__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_RXNE | LPUART_FLAG_FE);
+	__HAL_LPUART_ENABLE_IT(hlpuart, LPUART_IT_RXNE);
+	HAL_NVIC_SetPriority(LPUART_IRQn, LPRX_IRQ_PRIORITY);
+	HAL_NVIC_EnableIRQ(LPUART_IRQn);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  LPUART interrupt service, call it from LPUART_IRQHandler()
+  * @param  None
+  * @retval None
+  */
+void LpRxUartIRQHandler(void)
+{
+	uint8_t data;
+	uint16_t head;
+	uint32_t error;
+
+	if(!__HAL_LPUART_GET_FLAG(LpRxUart, LPUART_FLAG_RXNE))
+	{
+		return;
+	}
+
+	error = LpRxUart->RxByte(LpRxUart->Instance, &data);
+	if(__HAL_LPUART_GET_FLAG(LpRxUart, LPUART_FLAG_FE))
+	{
+		error |= HAL_LPUART_ERROR_FE;
+	}
+	__HAL_LPUART_CLEAR_FLAG(LpRxUart, LPUART_FLAG_RXNE | LPUART_FLAG_FE);
+
+	if(LpRxConfig.IdleTicks != 0U)
+	{
+		LpRxIdleRestart();
+	}
+
+	if(error != HAL_LPUART_ERROR_NONE)
+	{
+		LpRxStats.Errors++;
+		return;
+	}
+
+	head = LpRxHead;
+	if((uint16_t)(head - LpRxTail) > LpRxMask)
+	{
+		LpRxStats.Overruns++;
+		LpRxWake(LPRX_EVENT_OVERRUN);
+		return;
+	}
+	LpRxBuffer[head & LpRxMask] = data;
+	LpRxHead = ++head;
+	LpRxStats.Bytes++;
+
+	if(data == LpRxConfig.Delimiter)
+	{
+		LpRxWake(LPRX_EVENT_DELIMITER);
+	}
+	if((LpRxConfig.Threshold != 0U) && ((uint16_t)(head - LpRxTail) >= LpRxConfig.Threshold))
+	{
+		LpRxWake(LPRX_EVENT_THRESHOLD);
+	}
+	/* The last free byte leaves the application one character time to read */
+	if((uint16_t)(head - LpRxTail) >= LpRxMask)
+	{
+		LpRxWake(LPRX_EVENT_FULL);
+	}
+}
+
+/**
+  * @brief  AWK interrupt service, call it from AWK_IRQHandler()
+  * @param  None
+  * @retval None
+  */
+void LpRxAwkIRQHandler(void)
+{
+	if(__HAL_AWK_GET_FLAG(LpRxAwk) == RESET)
+	{
+		return;
+	}
+
+	__HAL_AWK_CLEAR_IT(LpRxAwk);
+	/* One shot, started again by the next byte */
+	__HAL_AWK_DISABLE(LpRxAwk);
+	if(LpRxHead != LpRxTail)
+	{
+		LpRxWake(LPRX_EVENT_IDLE);
+	}
+}
+
+/**
+  * @brief  Sleeps in deep sleep mode until a wake condition is met
+  * @note   The received bytes are handled by the LPUART interrupt only, the
+  *         core goes straight back to deep sleep after each of them. The
+  *         SysTick is suspended meanwhile.
+  * @param  None
+  * @retval LPRX_EVENT_xxx that ended the wait, they are cleared
+  */
+uint32_t LpRxWait(void)
+{
+	uint32_t events;
+
+	HAL_SuspendTick();
+	__disable_irq();
+	while(LpRxEvents == 0U)
+	{
+		HAL_PWR_EnableSleepOnExit();
+		/* Woken with the interrupt pending, it runs once enabled below and the
+			 core sleeps again on its return while SLEEPONEXIT is still set */
+		HAL_PWR_EnterDEEPSLEEPMode();
+		__enable_irq();
+		__disable_irq();
+	}
+	events = LpRxEvents;
+	LpRxEvents = 0;
+	__enable_irq();
+	HAL_PWR_DisableSleepOnExit();
+	HAL_ResumeTick();
+
+	LpRxStats.Wakeups++;
+	return events;
+}
+
+/**
+  * @brief  Reads bytes from the ring
+  * @param  pData: destination
+  * @param  size: largest number of bytes to read
+  * @retval Number of bytes read
+  */
+uint16_t LpRxRead(uint8_t *pData, uint16_t size)
+{
+	uint16_t tail = LpRxTail;
+	uint16_t count = (uint16_t)(LpRxHead - tail);
+	uint16_t i;
+
+	if(count > size)
+	{
+		count = size;
+	}
+	for(i = 0; i < count; i++)
+	{
+		pData[i] = LpRxBuffer[(tail + i) & LpRxMask];
+	}
+	LpRxTail = tail + count;
+
+	return count;
+}
+
+/**
+  * @brief  Returns the number of bytes waiting in the ring
+  * @param  None
+  * @retval Byte count
+  */
+uint16_t LpRxGetCount(void)
+{
+	return (uint16_t)(LpRxHead - LpRxTail);
+}
+
+/**
+  * @brief  Returns the counters
+  * @param  None
+  * @retval Counters
+  */
+const LpRxStatsTypeDef *LpRxGetStats(void)
+{
+	return &LpRxStats;
+}
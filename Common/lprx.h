@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    lprx.h
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Header file of LPUART deep sleep batched receive module.
+  ******************************************************************************
+  */
+
+#ifndef __CX32L003_LPRX_H
+#define __CX32L003_LPRX_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "cx32l003_hal.h"
+
+/*
+ * LPUART receive in deep sleep with batched wake-ups. The LPUART, clocked
+ * from LIRC or LXT in low power mode, keeps receiving while the core is in
+ * deep sleep. Every byte wakes the core only for the LPUART interrupt: the
+ * byte is pushed into a ring and, with the Cortex SLEEPONEXIT bit set, the
+ * core goes back to deep sleep on the interrupt return without ever running
+ * the application. LpRxWait() returns to the application only when one of
+ * the wake conditions is met:
+ *   delimiter: the byte LpRxConfigTypeDef.Delimiter was received
+ *   threshold: Threshold bytes or more are waiting in the ring
+ *   idle:      no byte for IdleTicks periods of the AWK clock
+ *   full:      one free byte is left in the ring, whatever the other conditions
+ *   overrun:   a byte was lost on a full ring
+ * The idle timeout uses the auto wake-up timer (AWK), which runs in deep sleep
+ * from LIRC or LXT. It is restarted by every byte and stopped when it expires.
+ * The LPUART is initialized by the application (HAL_LPUART_Init), the AWK is
+ * initialized with its clock and divider (HAL_AWK_Init), then LpRxInit() takes
+ * over both interrupts. LpRxUartIRQHandler() and LpRxAwkIRQHandler() must be
+ * called from LPUART_IRQHandler() and AWK_IRQHandler().
+ */
+
+/* Priority of the LPUART and AWK interrupts, they must not preempt each other */
+#define LPRX_IRQ_PRIORITY				PRIORITY_HIGH
+/* Delimiter value that never matches */
+#define LPRX_NO_DELIMITER				0x100U
+
+/* Wake-up events returned by LpRxWait() */
+#define LPRX_EVENT_DELIMITER		0x01U
+#define LPRX_EVENT_THRESHOLD		0x02U
+#define LPRX_EVENT_IDLE					0x04U
+#define LPRX_EVENT_OVERRUN			0x08U
+#define LPRX_EVENT_FULL					0x10U
+
+/* Wake conditions */
+typedef struct
+{
+	uint16_t Delimiter;						/* Byte that ends a message, or LPRX_NO_DELIMITER */
+	uint16_t Threshold;						/* Bytes in the ring that wake the application, below the ring size, 0 to disable */
+	uint16_t IdleTicks;						/* AWK clock periods of silence, 1 to 256, 0 to disable */
+} LpRxConfigTypeDef;
+
+/* Counters */
+typedef struct
+{
+	uint32_t Bytes;								/* Bytes stored in the ring */
+	uint32_t Wakeups;							/* Returns of LpRxWait() to the application */
+	uint32_t Errors;							/* Bytes dropped on framing or parity errors */
+	uint32_t Overruns;						/* Bytes dropped on a full ring */
+} LpRxStatsTypeDef;
+
+
+HAL_StatusTypeDef LpRxInit(LPUART_HandleTypeDef *hlpuart, AWK_HandleTypeDef *hawk, uint8_t *pBuffer, uint16_t size, const LpRxConfigTypeDef *config);
+void LpRxUartIRQHandler(void);
+void LpRxAwkIRQHandler(void);
+uint32_t LpRxWait(void);
+uint16_t LpRxRead(uint8_t *pData, uint16_t size);
+uint16_t LpRxGetCount(void);
+const LpRxStatsTypeDef *LpRxGetStats(void);
+#endif /* __CX32L003_LPRX_H */
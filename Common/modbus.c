@@ -0,0 +1,543 @@
+/**
+  ******************************************************************************
+  * @file    modbus.c
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Modbus RTU slave module, see modbus.h for the frame handling.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "modbus.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define MB_FC_READ_COILS				0x01U
+#define MB_FC_READ_HOLDING			0x03U
+#define MB_FC_READ_INPUT				0x04U
+#define MB_FC_WRITE_COIL				0x05U
+#define MB_FC_WRITE_REGISTER		0x06U
+#define MB_FC_WRITE_COILS				0x0FU
+#define MB_FC_WRITE_REGISTERS		0x10U
+
+#define MB_MIN_FRAME						4U			/* Address, function, CRC */
+#define MB_EXCEPTION						0x80U
+
+/* Private macro -------------------------------------------------------------*/
+#define MB_U16(p)								((uint16_t)(((uint16_t)(p)[0] << 8) | (p)[1]))
+#ifdef MB_DE_Pin
+	#define MB_DE_HIGH()					(MB_DE_GPIO_Port->ODSET = MB_DE_Pin)
+	#define MB_DE_LOW()						(MB_DE_GPIO_Port->ODCLR = MB_DE_Pin)
+#else
+	#define MB_DE_HIGH()
+	#define MB_DE_LOW()
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+/* Table driven CRC16/MODBUS, polynomial 0xA001 (reflected 0x8005) */
+static const uint16_t MbCrcTable[256] =
+{
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
+static UART_HandleTypeDef *MbUart = NULL;
+static BASETIM_HandleTypeDef *MbTimer = NULL;
+static const MbMapTypeDef *MbMap = NULL;
+static uint8_t MbAddress = 0;
+/* Request received and reply sent in place */
+static uint8_t MbFrame[MB_FRAME_SIZE];
+static uint16_t MbLength = 0;
+static uint16_t MbTxIndex = 0;
+static uint16_t MbTxLength = 0;
+/* Bad character (framing or parity error) or overrun in the current frame */
+static uint8_t MbFrameError = 0;
+/* Timer LOAD value, it overflows 3.5 characters later */
+static uint32_t MbReload = 0;
+static MbStatsTypeDef MbStats;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t MbCoilGet(uint16_t coil);
+static void MbCoilSet(uint16_t coil, uint8_t value);
+static uint16_t MbServe(uint16_t length);
+static void MbProcess(uint32_t start);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Reads a coil
+  * @param  coil: coil number, below CoilCount
+  * @retval 0 or 1
+  */
+static uint8_t MbCoilGet(uint16_t coil)
+{
+	return (uint8_t)((MbMap->pCoils[coil >> 3] >> (coil & 7U)) & 1U);
+}
+
+/**
+  * @brief  Writes a coil
+  * @param  coil: coil number, below CoilCount
+  * @param  value: 0 or 1
+  * @retval None
+  */
+static void MbCoilSet(uint16_t coil, uint8_t value)
+{
+	uint8_t mask = (uint8_t)(1U << (coil & 7U));
+
+	if(value != 0U)
+	{
+		MbMap->pCoils[coil >> 3] |= mask;
+	}
+	else
+	{
+		MbMap->pCoils[coil >> 3] &= (uint8_t)~mask;
+	}
+}
+
+/**
+  * @brief  Serves the request in MbFrame and builds the reply PDU over it
+  * @param  length: request length without the CRC
+  * @retval Reply length without the CRC
+  */
+static uint16_t MbServe(uint16_t length)
+{
+	uint8_t function = MbFrame[1];
+	uint16_t address = MB_U16(&MbFrame[2]);
+	uint16_t count = MB_U16(&MbFrame[4]);
+	uint8_t exception = 0;
+	uint16_t i;
+
+	switch(function)
+	{
+		case MB_FC_READ_COILS:
+			if((length != 6U) || (count == 0U) || (count > 2000U))
+			{
+				exception = MB_EX_ILLEGAL_VALUE;
+			}
+			else if((MbMap->pCoils == NULL) || ((uint32_t)address + count > MbMap->CoilCount))
+			{
+				exception = MB_EX_ILLEGAL_ADDRESS;
+			}
+			else
+			{
+				MbFrame[2] = (uint8_t)((count + 7U) >> 3);
+				for(i = 0; i < MbFrame[2]; i++)
+				{
+					MbFrame[3U + i] = 0;
+				}
+				for(i = 0; i < count; i++)
+				{
+					MbFrame[3U + (i >> 3)] |= (uint8_t)(MbCoilGet(address + i) << (i & 7U));
+				}
+				return (uint16_t)(3U + MbFrame[2]);
+			}
+			break;
+
+		case MB_FC_READ_HOLDING:
+		case MB_FC_READ_INPUT:
+		{
+			const uint16_t *table = (function == MB_FC_READ_HOLDING) ? MbMap->pHolding : MbMap->pInput;
+			uint16_t size = (function == MB_FC_READ_HOLDING) ? MbMap->HoldingCount : MbMap->InputCount;
+
+			if((length != 6U) || (count == 0U) || (count > 125U))
+			{
+				exception = MB_EX_ILLEGAL_VALUE;
+			}
+			else if((table == NULL) || ((uint32_t)address + count > size))
+			{
+				exception = MB_EX_ILLEGAL_ADDRESS;
+			}
+			else
+			{
+				MbFrame[2] = (uint8_t)(count << 1);
+				for(i = 0; i < count; i++)
+				{
+					MbFrame[3U + (i << 1)] = (uint8_t)(table[address + i] >> 8);
+					MbFrame[4U + (i << 1)] = (uint8_t)table[address + i];
+				}
+				return (uint16_t)(3U + MbFrame[2]);
+			}
+			break;
+		}
+
+		case MB_FC_WRITE_COIL:
+			/* count is the coil value here, the reply echoes the request */
+			if((length != 6U) || ((count != 0xFF00U) && (count != 0x0000U)))
+			{
+				exception = MB_EX_ILLEGAL_VALUE;
+			}
+			else if((MbMap->pCoils == NULL) || (address >= MbMap->CoilCount))
+			{
+				exception = MB_EX_ILLEGAL_ADDRESS;
+			}
+			else
+			{
+				MbCoilSet(address, (uint8_t)(count != 0U));
+				MbWriteCallback(function, address, 1);
+				return 6;
+			}
+			break;
+
+		case MB_FC_WRITE_REGISTER:
+			/* count is the register value here, the reply echoes the request */
+			if(length != 6U)
+			{
+				exception = MB_EX_ILLEGAL_VALUE;
+			}
+			else if((MbMap->pHolding == NULL) || (address >= MbMap->HoldingCount))
+			{
+				exception = MB_EX_ILLEGAL_ADDRESS;
+			}
+			else
+			{
+				MbMap->pHolding[address] = count;
+				MbWriteCallback(function, address, 1);
+				return 6;
+			}
+			break;
+
+		case MB_FC_WRITE_COILS:
+			if((length < 7U) || (count == 0U) || (count > 1968U) ||
+				 (MbFrame[6] != ((count + 7U) >> 3)) || (length != 7U + MbFrame[6]))
+			{
+				exception = MB_EX_ILLEGAL_VALUE;
+			}
+			else if((MbMap->pCoils == NULL) || ((uint32_t)address + count > MbMap->CoilCount))
+			{
+				exception = MB_EX_ILLEGAL_ADDRESS;
+			}
+			else
+			{
+				for(i = 0; i < count; i++)
+				{
+					MbCoilSet(address + i, (uint8_t)((MbFrame[7U + (i >> 3)] >> (i & 7U)) & 1U));
+				}
+				MbWriteCallback(function, address, count);
+				return 6;
+			}
+			break;
+
+		case MB_FC_WRITE_REGISTERS:
+			if((length < 7U) || (count == 0U) || (count > 123U) ||
+				 (MbFrame[6] != (count << 1)) || (length != 7U + MbFrame[6]))
+			{
+				exception = MB_EX_ILLEGAL_VALUE;
+			}
+			else if((MbMap->pHolding == NULL) || ((uint32_t)address + count > MbMap->HoldingCount))
+			{
+				exception = MB_EX_ILLEGAL_ADDRESS;
+			}
+			else
+			{
+				for(i = 0; i < count; i++)
+				{
+					MbMap->pHolding[address + i] = MB_U16(&MbFrame[7U + (i << 1)]);
+				}
+				MbWriteCallback(function, address, count);
+				return 6;
+			}
+			break;
+
+		default:
+			exception = MB_EX_ILLEGAL_FUNCTION;
+			break;
+	}
+
+	MbStats.Exceptions++;
+	MbFrame[1] = (uint8_t)(function | MB_EXCEPTION);
+	MbFrame[2] = exception;
+	return 3;
+}
+
+/**
+  * @brief  Checks the received frame, serves it and starts the reply
+  * @param  start: HAL_GetMicros() at the end of the silence
+  * @retval None
+  */
+static void MbProcess(uint32_t start)
+{
+	uint16_t length = MbLength;
+	uint16_t crc;
+
+	if((MbFrameError != 0U) || (length < MB_MIN_FRAME) || (MbCrc16(MbFrame, length) != 0U))
+	{
+		if(MbFrameError & 2U)
+		{
+			MbStats.Overruns++;
+		}
+		else
+		{
+			MbStats.CrcErrors++;
+		}
+		return;
+	}
+	if((MbFrame[0] != MbAddress) && (MbFrame[0] != 0U))
+	{
+		return;
+	}
+
+	MbStats.Frames++;
+	length = MbServe(length - 2U);
+	if(MbFrame[0] == 0U)
+	{
+		/* Broadcast, no reply */
+		return;
+	}
+
+	crc = MbCrc16(MbFrame, length);
+	MbFrame[length] = (uint8_t)crc;
+	MbFrame[length + 1U] = (uint8_t)(crc >> 8);
+	MbTxLength = length + 2U;
+	MbTxIndex = 1;
+
+	MB_DE_HIGH();
+	MbUart->TxByte(MbUart->Instance, MbFrame[0]);
+
+	/* Both points are read in this interrupt, a tick the SysTick handler has
+	   not counted yet is missing from both and cancels out */
+	MbStats.TurnaroundUs = HAL_GetMicros() - start;
+	if(MbStats.TurnaroundUs > MbStats.MaxTurnaroundUs)
+	{
+		MbStats.MaxTurnaroundUs = MbStats.TurnaroundUs;
+	}
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Starts the Modbus slave
+  * @note   The UART must be initialized, its interrupt is then owned by this
+  *         module. The timer clock is enabled in HAL_BASETIM_Base_MspInit().
+  * @param  huart: UART0 or UART1 handle
+  * @param  htim: TIM10 or TIM11 handle, Instance set, it is configured here
+  * @param  address: slave address 1 to 247
+  * @param  map: register map, kept by reference
+  * @retval HAL status
+  */
+HAL_StatusTypeDef MbInit(UART_HandleTypeDef *huart, BASETIM_HandleTypeDef *htim, uint8_t address, const MbMapTypeDef *map)
+{
+	uint32_t pclk = HAL_RCC_GetPCLKFreq();
+	uint32_t ticks;
+	IRQn_Type uart_irq = (huart->Instance == UART0) ? UART0_IRQn : UART1_IRQn;
+	IRQn_Type tim_irq = (htim->Instance == TIM10) ? TIM10_IRQn : TIM11_IRQn;
+
+	if((map == NULL) || (address == 0U) || (address > 247U) || (huart->Init.BaudRate == 0U))
+	{
+		return HAL_ERROR;
+	}
+
+	HAL_NVIC_DisableIRQ(uart_irq);
+	HAL_NVIC_DisableIRQ(tim_irq);
+
+	MbUart = huart;
+	MbTimer = htim;
+	MbMap = map;
+	MbAddress = address;
+	MbLength = 0;
+	MbTxLength = 0;
+	MbFrameError = 0;
+
+	/* 3.5 character times, fixed above 19200 bps */
+	if(huart->Init.BaudRate <= 19200U)
+	{
+		ticks = (pclk / (2U * huart->Init.BaudRate)) * (7U * MB_CHAR_BITS);
+	}
+	else
+	{
+		ticks = (pclk / 1000000U) * MB_T35_FAST_US;
+	}
+	MbReload = BASETIM_MAXCNTVALUE_32BIT - ticks + 1U;
+
+	htim->Init.GateEnable = BASETIM_GATE_DISABLE;
+	htim->Init.GateLevel = BASETIM_GATELEVEL_HIGH;
+	htim->Init.TogEnable = BASETIM_TOG_DISABLE;
+	htim->Init.CntTimSel = BASETIM_TIMER_SELECT;
+	htim->Init.AutoReload = BASETIM_AUTORELOAD_DISABLE;
+	htim->Init.MaxCntLevel = BASETIM_MAXCNTLEVEL_32BIT;
+	htim->Init.OneShot = BASETIM_ONESHOT_MODE;
+	htim->Init.Prescaler = BASETIM_PRESCALER_DIV1;
+	htim->Init.Period = MbReload;
+	if(HAL_BASETIM_Base_Init(htim) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+	__HAL_BASETIM_CLEAR_IT(htim);
+	__HAL_BASETIM_ENABLE_IT(htim);
+
+	/* 9 bit frames without parity: TB8 is the second stop bit */
+	if((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE))
+	{
+		SET_BIT(huart->Instance->SCON, UART_SCON_TB8);
+	}
+
+	MB_DE_LOW();
+	__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC | UART_FLAG_RXNE | UART_FLAG_FE);
+	__HAL_UART_ENABLE_IT(huart, UART_IT_TC | UART_IT_RXNE);
+
+	/* Same priority, the UART and timer handlers never preempt each other */
+	HAL_NVIC_SetPriority(uart_irq, MB_IRQ_PRIORITY);
+	HAL_NVIC_SetPriority(tim_irq, MB_IRQ_PRIORITY);
+	HAL_NVIC_EnableIRQ(uart_irq);
+	HAL_NVIC_EnableIRQ(tim_irq);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  UART interrupt service, call it from the UART IRQ handler
+  * @param  None
+  * @retval None
+  */
+void MbUartIRQHandler(void)
+{
+	UART_HandleTypeDef *huart = MbUart;
+
+	if(__HAL_UART_GET_FLAG(huart, UART_FLAG_RXNE))
+	{
+		uint8_t data;
+		/* The handler bound to the frame format checks the parity */
+		uint32_t error = huart->RxByte(huart->Instance, &data);
+
+		__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);
+		if(MbTxLength == 0U)
+		{
+			if(__HAL_UART_GET_FLAG(huart, UART_FLAG_FE))
+			{
+				__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_FE);
+				MbFrameError |= 1U;
+			}
+			else if(error == HAL_UART_ERROR_PARITY)
+			{
+				MbFrameError |= 1U;
+			}
+
+			if(MbLength < MB_FRAME_SIZE)
+			{
+				MbFrame[MbLength++] = data;
+			}
+			else
+			{
+				MbFrameError |= 2U;
+			}
+
+			/* Restart the silence timer */
+			MbTimer->Instance->CR &= ~BASETIM_CR_TR;
+			MbTimer->Instance->LOAD = MbReload;
+			MbTimer->Instance->CR |= BASETIM_CR_TR;
+		}
+	}
+
+	if(__HAL_UART_GET_FLAG(huart, UART_FLAG_TC))
+	{
+		__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC);
+		if(MbTxIndex < MbTxLength)
+		{
+			huart->TxByte(huart->Instance, MbFrame[MbTxIndex++]);
+		}
+		else if(MbTxLength != 0U)
+		{
+			/* Last byte on the wire, back to listening */
+			MB_DE_LOW();
+			MbTxLength = 0;
+			MbTxIndex = 0;
+		}
+	}
+}
+
+/**
+  * @brief  Timer interrupt service, call it from the TIM10 or TIM11 IRQ handler
+  * @note   The frame ends here, it is served and the reply started at once.
+  * @param  None
+  * @retval None
+  */
+void MbTimerIRQHandler(void)
+{
+	uint32_t start = HAL_GetMicros();
+
+	if(__HAL_BASETIM_GET_FLAG(MbTimer))
+	{
+		__HAL_BASETIM_CLEAR_IT(MbTimer);
+		__HAL_BASETIM_DISABLE(MbTimer);
+		if(MbLength != 0U)
+		{
+			MbProcess(start);
+		}
+		MbLength = 0;
+		MbFrameError = 0;
+	}
+}
+
+/**
+  * @brief  Returns the frame counters and the turnaround measurement
+  * @param  None
+  * @retval Statistics, updated from the interrupts
+  */
+const MbStatsTypeDef *MbGetStats(void)
+{
+	return &MbStats;
+}
+
+/**
+  * @brief  Computes the CRC16/MODBUS of a buffer
+  * @note   The CRC over a frame including its own CRC bytes is 0.
+  * @param  data: buffer
+  * @param  len: length in bytes
+  * @retval CRC, low byte is sent first
+  */
+uint16_t MbCrc16(const uint8_t *data, uint16_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	while(len-- != 0U)
+	{
+		crc = (crc >> 8) ^ MbCrcTable[(crc ^ *data++) & 0xFFU];
+	}
+	return crc;
+}
+
+/**
+  * @brief  Registers written by the master, called from the timer interrupt
+  * @param  function: function code 05, 06, 15 or 16
+  * @param  address: first coil or register written
+  * @param  count: number of coils or registers written
+  * @retval None
+  */
+__weak void MbWriteCallback(uint8_t function, uint16_t address, uint16_t count)
+{
+	/* Prevent unused argument(s) compilation warning */
+	UNUSED(function);
+	UNUSED(address);
+	UNUSED(count);
+	/* NOTE : This function Should not be modified, when the callback is needed,
+            the MbWriteCallback could be implemented in the user file
+   */
+}
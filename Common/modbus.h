@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file    modbus.h
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Header file of Modbus RTU slave module.
+  ******************************************************************************
+  */
+
+#ifndef __CX32L003_MODBUS_H
+#define __CX32L003_MODBUS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "cx32l003_hal.h"
+
+/*
+ * Modbus RTU slave on one UART, the frame end (3.5 character times of silence)
+ * is detected with a BASETIM (TIM10 or TIM11) in one shot mode restarted by
+ * every received byte. Everything runs from interrupts:
+ *   UART RX interrupt: byte stored in MbFrame, silence timer restarted
+ *   timer interrupt:   frame checked (CRC16, address), request served from
+ *                      the register map, reply built in place in MbFrame and
+ *                      its first byte sent
+ *   UART TX interrupt: next reply byte
+ * The turnaround, from the end of the silence to the first reply byte on the
+ * UART, is only the request processing, it is measured in microseconds with
+ * HAL_GetMicros() and kept in MbStats. The reply thus starts 3.5 character
+ * times plus TurnaroundUs after the last request byte.
+ * The bytes go through the TxByte and RxByte handlers HAL_UART_Init() binds to
+ * the frame format, they handle the 9th bit parity.
+ * Functions served: 01 read coils, 03 read holding registers, 04 read input
+ * registers, 05 write single coil, 06 write single register, 15 write multiple
+ * coils, 16 write multiple registers. Address 0 is broadcast, writes are done
+ * and no reply is sent.
+ * The UART is initialized by the application (HAL_UART_Init), then MbInit()
+ * configures the timer and takes over the UART interrupt. MbUartIRQHandler()
+ * and MbTimerIRQHandler() must be called from the UART and timer IRQ handlers.
+ */
+
+/* Largest RTU frame, address + PDU + CRC */
+#define MB_FRAME_SIZE					256
+/* Priority of both the UART and the timer interrupts, they must not preempt each other */
+#define MB_IRQ_PRIORITY				PRIORITY_HIGH
+/* Bits per character used for the silence time, 1 start + 8 data + 2 parity/stop */
+#define MB_CHAR_BITS					11U
+/* Fixed silence time in us above 19200 bps, as the specification requires */
+#define MB_T35_FAST_US				1750U
+
+/* Uncomment to drive a RS-485 transceiver DE pin high while replying */
+//#define MB_DE_GPIO_Port			GPIOD
+//#define MB_DE_Pin						GPIO_PIN_4
+
+/* Exception codes */
+#define MB_EX_ILLEGAL_FUNCTION		0x01U
+#define MB_EX_ILLEGAL_ADDRESS			0x02U
+#define MB_EX_ILLEGAL_VALUE				0x03U
+
+/* Register map served to the master, any table may be NULL with a 0 count */
+typedef struct
+{
+	uint16_t *pHolding;						/* Holding registers, read and write */
+	uint16_t HoldingCount;
+	const uint16_t *pInput;				/* Input registers, read only */
+	uint16_t InputCount;
+	uint8_t *pCoils;							/* Coils, packed 8 per byte, coil 0 is bit 0 of byte 0 */
+	uint16_t CoilCount;
+} MbMapTypeDef;
+
+/* Counters and timing */
+typedef struct
+{
+	uint32_t Frames;							/* Frames addressed to this slave */
+	uint32_t CrcErrors;						/* Frames dropped on CRC, framing or parity errors */
+	uint32_t Overruns;						/* Frames dropped for being longer than MB_FRAME_SIZE */
+	uint32_t Exceptions;					/* Exception replies */
+	uint32_t TurnaroundUs;				/* Last frame end to reply start, microseconds */
+	uint32_t MaxTurnaroundUs;			/* Largest TurnaroundUs */
+} MbStatsTypeDef;
+
+
+HAL_StatusTypeDef MbInit(UART_HandleTypeDef *huart, BASETIM_HandleTypeDef *htim, uint8_t address, const MbMapTypeDef *map);
+void MbUartIRQHandler(void);
+void MbTimerIRQHandler(void);
+const MbStatsTypeDef *MbGetStats(void);
+uint16_t MbCrc16(const uint8_t *data, uint16_t len);
+void MbWriteCallback(uint8_t function, uint16_t address, uint16_t count);
+#endif /* __CX32L003_MODBUS_H */
@@ -0,0 +1,354 @@
+/**
+  ******************************************************************************
+  * @file    tickless.c
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Tickless LPTIM time base module, see tickless.h for the counting scheme.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tickless.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define TICKLESS_PERIOD					0x10000U
+/* Longest sleep computed exactly, above it the sleep ends at the overflow anyway */
+#define TICKLESS_MAX_SLEEP_MS		((TICKLESS_PERIOD * 1000U) / TICKLESS_CLOCK_HZ + 1U)
+
+/* Private macro -------------------------------------------------------------*/
+#define TICKLESS_COUNTER()			(TicklessTimer.Instance->CNTVAL & LPTIM_LOAD_LOAD)
+
+/* Private variables ---------------------------------------------------------*/
+static LPTIM_HandleTypeDef TicklessTimer;
+/* Milliseconds folded in up to TicklessStart, TicklessMsHigh counts their wrap arounds */
+static volatile uint32_t TicklessMs = 0;
+static volatile uint32_t TicklessMsHigh = 0;
+/* Fraction of a millisecond carried, in 1/TICKLESS_CLOCK_HZ ms */
+static volatile uint32_t TicklessRem = 0;
+/* Counter value the unfolded ticks are counted from */
+static volatile uint32_t TicklessStart = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static void TicklessFold(uint32_t ticks);
+static uint32_t TicklessElapsed(void);
+static uint32_t TicklessNow(void);
+static uint32_t TicklessNowUs(uint32_t *pMs);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Adds LPTIM clocks to the millisecond count
+  * @param  ticks: LPTIM clocks, at most one period
+  * @retval None
+  */
+static void TicklessFold(uint32_t ticks)
+{
+	uint32_t x = TicklessRem + (ticks * 1000U);
+	uint32_t ms = TicklessMs + (x / TICKLESS_CLOCK_HZ);
+
+	if(ms < TicklessMs)
+	{
+		TicklessMsHigh++;
+	}
+	TicklessMs = ms;
+	TicklessRem = x % TICKLESS_CLOCK_HZ;
+}
+
+/**
+  * @brief  LPTIM clocks since TicklessStart, interrupts disabled by the caller
+  * @note   An overflow not served yet is accounted for.
+  * @param  None
+  * @retval LPTIM clocks
+  */
+static uint32_t TicklessElapsed(void)
+{
+	uint32_t count = TICKLESS_COUNTER();
+
+	if(__HAL_LPTIM_GET_FLAG(&TicklessTimer))
+	{
+		/* Wrapped, read again in case it wrapped after the first read */
+		return (TICKLESS_PERIOD - TicklessStart) + TICKLESS_COUNTER();
+	}
+	/* Counter rewrite still synchronizing */
+	if(count < TicklessStart)
+	{
+		return 0;
+	}
+	return count - TicklessStart;
+}
+
+/**
+  * @brief  Current tick, interrupts disabled by the caller
+  * @param  None
+  * @retval Tick value in milliseconds
+  */
+static uint32_t TicklessNow(void)
+{
+	return TicklessMs + ((TicklessRem + (TicklessElapsed() * 1000U)) / TICKLESS_CLOCK_HZ);
+}
+
+/**
+  * @brief  Current time in microseconds, interrupts disabled by the caller
+  * @param  pMs: milliseconds the microseconds count from
+  * @retval Microseconds since pMs, below 1000 * (65536 / TICKLESS_CLOCK_HZ + 1)
+  */
+static uint32_t TicklessNowUs(uint32_t *pMs)
+{
+	uint32_t x = TicklessRem + (TicklessElapsed() * 1000U);
+
+	*pMs = TicklessMs;
+	/* Split so that no product exceeds 32 bits */
+	return ((x / TICKLESS_CLOCK_HZ) * 1000U) + (((x % TICKLESS_CLOCK_HZ) * 1000U) / TICKLESS_CLOCK_HZ);
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Starts the LPTIM time base, overrides the SysTick one
+  * @note   Called by HAL_Init() and HAL_RCC_ClockConfig(), the LPTIM clock does
+  *         not depend on the system clock so it is only configured once.
+  * @param  TickPriority: LPTIM interrupt priority
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+	if(TickPriority >= (1UL << __NVIC_PRIO_BITS))
+	{
+		return HAL_ERROR;
+	}
+
+	if(TicklessTimer.Instance == NULL)
+	{
+		/* No periodic interrupt, SysTick only runs for HAL_DelayUs() */
+		SysTick->CTRL = 0;
+		SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+		SysTick->VAL = 0;
+		SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+		__HAL_RCC_LPTIM_CLK_ENABLE();
+		TicklessTimer.Instance = LPTIM;
+		TicklessTimer.Init.GateEnable = LPTIM_GATE_DISABLE;
+		TicklessTimer.Init.GateLevel = LPTIM_GATELEVEL_HIGH;
+		TicklessTimer.Init.ClkSel = TICKLESS_CLOCK_SOURCE;
+		TicklessTimer.Init.TogEnable = LPTIM_TOG_DISABLE;
+		TicklessTimer.Init.CntTimSel = LPTIM_TIMER_SELECT;
+		TicklessTimer.Init.AutoReload = LPTIM_AUTORELOAD_ENABLE;
+		TicklessTimer.Init.Period = 0;
+		if(HAL_LPTIM_Base_Init(&TicklessTimer) != HAL_OK)
+		{
+			TicklessTimer.Instance = NULL;
+			return HAL_ERROR;
+		}
+		while(__HAL_LPTIM_SYNC_FLAG(TicklessTimer.Instance));
+		TicklessTimer.Instance->LOAD = 0;
+		while(__HAL_LPTIM_SYNC_FLAG(TicklessTimer.Instance));
+		TicklessMs = 0;
+		TicklessMsHigh = 0;
+		TicklessRem = 0;
+		TicklessStart = 0;
+		__HAL_LPTIM_CLEAR_IT(&TicklessTimer);
+		HAL_LPTIM_Base_Start_IT(&TicklessTimer);
+	}
+
+	HAL_NVIC_SetPriority(LPTIM_IRQn, TickPriority);
+	uwTickPrio = TickPriority;
+	HAL_NVIC_EnableIRQ(LPTIM_IRQn);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  No periodic tick in the tickless time base
+  * @retval None
+  */
+void HAL_IncTick(void)
+{
+}
+
+/**
+  * @brief  Provides a tick value in millisecond read from the LPTIM counter
+  * @retval tick value
+  */
+uint32_t HAL_GetTick(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t tick;
+
+	__disable_irq();
+	tick = TicklessNow();
+	__set_PRIMASK(primask);
+
+	return tick;
+}
+
+/**
+  * @brief  Provides a timestamp in microsecond read from the LPTIM counter
+  * @note   The resolution is one LPTIM clock, 30.5 us from LXT.
+  * @retval timestamp in microsecond
+  */
+uint32_t HAL_GetMicros(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t ms;
+	uint32_t us;
+
+	__disable_irq();
+	us = TicklessNowUs(&ms);
+	__set_PRIMASK(primask);
+
+	return (ms * 1000U) + us;
+}
+
+/**
+  * @brief  Provides a timestamp in core cycles derived from the LPTIM counter
+  * @note   The resolution is one LPTIM clock, SysTick does not run in deep sleep.
+  * @retval timestamp in core cycles
+  */
+uint64_t HAL_GetCycles64(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t ms;
+	uint32_t high;
+	uint32_t us;
+
+	__disable_irq();
+	us = TicklessNowUs(&ms);
+	high = TicklessMsHigh;
+	__set_PRIMASK(primask);
+
+	return (((((uint64_t)high << 32) | ms) * 1000U) + us) * (SystemCoreClock / 1000000U);
+}
+
+/**
+  * @brief  Minimum delay in milliseconds, the core sleeps while waiting
+  * @note   Called from an interrupt handler, the delay is polled: a lower
+  *         priority LPTIM interrupt could not end the sleep.
+  * @param  Delay specifies the delay time length, in milliseconds.
+  * @retval None
+  */
+void HAL_Delay(uint32_t Delay)
+{
+	uint32_t tickstart = HAL_GetTick();
+	uint32_t wait = Delay;
+
+	/* Add a freq to guarantee minimum wait */
+	if (wait < HAL_MAX_DELAY)
+	{
+		wait += (uint32_t)(uwTickFreq);
+	}
+
+	while ((HAL_GetTick() - tickstart) < wait)
+	{
+		if(__get_IPSR() == 0U)
+		{
+			TicklessIdle(tickstart + wait, TICKLESS_SLEEP);
+		}
+	}
+}
+
+/**
+  * @brief  The LPTIM keeps counting, there is no tick interrupt to suspend
+  * @retval None
+  */
+void HAL_SuspendTick(void)
+{
+}
+
+/**
+  * @brief  The LPTIM keeps counting, there is no tick interrupt to resume
+  * @retval None
+  */
+void HAL_ResumeTick(void)
+{
+}
+
+/**
+  * @brief  LPTIM interrupt service, call it from LPTIM_IRQHandler()
+  * @param  None
+  * @retval None
+  */
+void TicklessIRQHandler(void)
+{
+	if(__HAL_LPTIM_GET_FLAG(&TicklessTimer))
+	{
+		__HAL_LPTIM_CLEAR_IT(&TicklessTimer);
+		TicklessFold(TICKLESS_PERIOD - TicklessStart);
+		/* Reloaded from BGLOAD */
+		TicklessStart = 0;
+	}
+}
+
+/**
+  * @brief  Idle hook, sleeps until the deadline or any interrupt
+  * @note   Returns at once if the deadline is within TICKLESS_MIN_SLEEP_TICKS,
+  *         the caller then polls. Returns early on any interrupt, the caller
+  *         checks its events and calls it again.
+  * @param  wakeTick: earliest pending deadline, a HAL_GetTick() value
+  * @param  mode: TICKLESS_SLEEP or TICKLESS_DEEPSLEEP
+  * @retval None
+  */
+void TicklessIdle(uint32_t wakeTick, uint32_t mode)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t remaining;
+	uint32_t target;
+	uint32_t elapsed;
+	uint32_t need;
+
+	__disable_irq();
+
+	/* An overflow is pending, let it be served first */
+	if(__HAL_LPTIM_GET_FLAG(&TicklessTimer))
+	{
+		__set_PRIMASK(primask);
+		return;
+	}
+
+	remaining = wakeTick - TicklessNow();
+	if((int32_t)remaining <= 0)
+	{
+		__set_PRIMASK(primask);
+		return;
+	}
+
+	if(remaining < TICKLESS_MAX_SLEEP_MS)
+	{
+		/* Clocks since TicklessStart at which the tick reaches wakeTick */
+		target = ((wakeTick - TicklessMs) * TICKLESS_CLOCK_HZ) - TicklessRem;
+		target = (target + 999U) / 1000U;
+		elapsed = TicklessElapsed();
+		need = target - elapsed;
+
+		if(need < TICKLESS_MIN_SLEEP_TICKS)
+		{
+			__set_PRIMASK(primask);
+			return;
+		}
+
+		if((TicklessStart + target) < TICKLESS_PERIOD)
+		{
+			/* Move the overflow to the deadline. The counter is read again right
+			   before the write, the clocks the write takes to reach the counter
+			   are counted as elapsed and left out of the new period. */
+			while(__HAL_LPTIM_SYNC_FLAG(TicklessTimer.Instance));
+			elapsed = TicklessElapsed();
+			need = target - elapsed;
+			TicklessFold(elapsed + TICKLESS_LOAD_LATENCY);
+			TicklessStart = (TICKLESS_PERIOD - need) + TICKLESS_LOAD_LATENCY;
+			TicklessTimer.Instance->LOAD = TicklessStart;
+			while(__HAL_LPTIM_SYNC_FLAG(TicklessTimer.Instance));
+		}
+	}
+
+	if(mode == TICKLESS_DEEPSLEEP)
+	{
+		HAL_PWR_EnterDEEPSLEEPMode();
+	}
+	else
+	{
+		HAL_PWR_EnterSLEEPMode(PWR_SLEEPENTRY_WFI);
+	}
+
+	/* The interrupt that woke the core runs here */
+	__set_PRIMASK(primask);
+}
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    tickless.h
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Header file of tickless LPTIM time base module.
+  ******************************************************************************
+  */
+
+#ifndef __CX32L003_TICKLESS_H
+#define __CX32L003_TICKLESS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "cx32l003_hal.h"
+
+/*
+ * Tickless HAL time base on the LPTIM, replacing the 1 ms SysTick interrupt.
+ * Adding tickless.c to a project overrides the weak HAL_InitTick(),
+ * HAL_IncTick(), HAL_GetTick(), HAL_Delay(), HAL_SuspendTick() and
+ * HAL_ResumeTick(), as well as HAL_GetMicros() and HAL_GetCycles64() which
+ * then have the LPTIM resolution. SysTick runs without interrupt, only for
+ * HAL_DelayUs().
+ * The LPTIM runs from LXT or LIRC, in deep sleep too, as a free running
+ * 16 bit counter reloaded with 0 (BGLOAD) on overflow. Its only interrupt is
+ * the overflow, every 65536 LPTIM clocks (2 s from LXT). HAL_GetTick() reads
+ * the counter and adds it to the milliseconds folded in at the last overflow,
+ * the fraction of a millisecond being carried so the count does not drift, so
+ * HAL_GetTick(), HAL_Delay() and every *_WaitOnFlagUntilTimeout() keep their
+ * semantics without any periodic interrupt.
+ * TicklessIdle() is the idle hook: given the earliest pending deadline as a
+ * HAL_GetTick() value, it shortens the current counter period so the overflow
+ * wakes the core at that deadline, then sleeps. Rewriting the counter restarts
+ * it: the TICKLESS_LOAD_LATENCY clocks the write takes to reach the counter are
+ * counted as elapsed, so only a difference between this value and the real
+ * latency, below one LPTIM clock, is lost per rewrite. The counter is only
+ * rewritten for a new deadline, for sleeps of TICKLESS_MIN_SLEEP_TICKS or more,
+ * longer sleeps simply end at the natural overflow.
+ * The LXT or LIRC oscillator is enabled by the application (HAL_RCC_OscConfig)
+ * before HAL_Init(). TicklessIRQHandler() must be called from LPTIM_IRQHandler().
+ */
+
+/* LPTIM clock, LPTIM_CLOCK_SOURCE_LXT or LPTIM_CLOCK_SOURCE_LIRC, and its frequency */
+#ifndef TICKLESS_CLOCK_SOURCE
+	#define TICKLESS_CLOCK_SOURCE		LPTIM_CLOCK_SOURCE_LXT
+	#define TICKLESS_CLOCK_HZ				LXT_VALUE
+#endif
+/* Shortest sleep worth rewriting the counter for, LPTIM clocks */
+#define TICKLESS_MIN_SLEEP_TICKS	32U
+/* LPTIM clocks from a LOAD write, once synchronized, to the counter reload */
+#define TICKLESS_LOAD_LATENCY			1U
+
+/* Sleep modes for TicklessIdle() */
+#define TICKLESS_SLEEP						0U		/* Core clock stopped, peripherals keep running */
+#define TICKLESS_DEEPSLEEP				1U		/* HIRC stopped, only LXT/LIRC peripherals keep running */
+
+
+void TicklessIRQHandler(void);
+void TicklessIdle(uint32_t wakeTick, uint32_t mode);
+#endif /* __CX32L003_TICKLESS_H */
@@ -0,0 +1,619 @@
+/**
+  ******************************************************************************
+  * @file    twheel.c
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Software timer wheel module, see twheel.h for the wheel layout.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "twheel.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define TW_WHEEL_SLOTS				(TW_LEVELS * TW_SLOTS)
+/* List indexes after the wheel slots */
+#define TW_INDEX_FAR					TW_WHEEL_SLOTS
+#define TW_INDEX_DUE					(TW_WHEEL_SLOTS + 1U)
+#define TW_INDEX_IDLE					0xFFU
+/* Wheel ticks covered by all the levels */
+#define TW_SPAN								(1UL << (TW_LEVELS * TW_SLOT_BITS))
+/* Counter value reloaded on overflow, the free running period is then 2^32 - 1 */
+#define TW_RELOAD							1U
+/* Shortest timer period programmed, PCLK cycles */
+#define TW_MIN_COUNTS					64U
+
+/* Private macro -------------------------------------------------------------*/
+#define TW_SLOT(tick, level)	(((tick) >> ((level) * TW_SLOT_BITS)) & (TW_SLOTS - 1U))
+
+/* Private variables ---------------------------------------------------------*/
+static BASETIM_HandleTypeDef *TwTimer = NULL;
+/* Wheel slots, far list and due list */
+static TwTimerTypeDef *TwLists[TW_WHEEL_SLOTS + 2U];
+/* Occupied slots of each level */
+static uint32_t TwBitmap[TW_LEVELS];
+/* Wheel tick up to which the slots are processed */
+static uint32_t TwWheelNow = 0;
+/* Wheel ticks folded in up to TwCountStart, fraction of a tick carried in PCLK cycles */
+static uint32_t TwBase = 0;
+static uint32_t TwRem = 0;
+/* Counter value the unfolded cycles are counted from */
+static uint32_t TwCountStart = TW_RELOAD;
+/* PCLK cycles per wheel tick, longest programmable delay in wheel ticks */
+static uint32_t TwTickCycles = 0;
+static uint32_t TwMaxTicks = 0;
+/* Wheel tick the timer interrupt is programmed for */
+static uint32_t TwWake = 0;
+static uint32_t TwArmed = 0;
+
+static const uint8_t TwDeBruijn[32] =
+{
+	0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+	31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t TwLowestBit(uint32_t bits);
+static void TwLink(TwTimerTypeDef *timer, uint32_t index);
+static void TwUnlink(TwTimerTypeDef *timer);
+static void TwQueue(TwTimerTypeDef *timer);
+static void TwRequeue(uint32_t index);
+static uint32_t TwNextEvent(uint32_t *pEvent);
+static void TwAdvance(uint32_t tick);
+static void TwUpdate(uint32_t now);
+static void TwFold(uint32_t cycles);
+static uint32_t TwElapsed(void);
+static uint32_t TwNow(void);
+static void TwProgram(void);
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Index of the lowest set bit
+  * @param  bits: non zero value
+  * @retval Bit index
+  */
+static uint32_t TwLowestBit(uint32_t bits)
+{
+	return TwDeBruijn[((bits & (0U - bits)) * 0x077CB531U) >> 27];
+}
+
+/**
+  * @brief  Links a timer at the head of a list
+  * @param  timer: timer not in any list
+  * @param  index: wheel slot, TW_INDEX_FAR or TW_INDEX_DUE
+  * @retval None
+  */
+static void TwLink(TwTimerTypeDef *timer, uint32_t index)
+{
+	TwTimerTypeDef *head = TwLists[index];
+
+	timer->pNext = head;
+	if(head != NULL)
+	{
+		head->ppPrev = &timer->pNext;
+	}
+	timer->ppPrev = &TwLists[index];
+	TwLists[index] = timer;
+	timer->Index = (uint8_t)index;
+
+	if(index < TW_WHEEL_SLOTS)
+	{
+		TwBitmap[index / TW_SLOTS] |= 1UL << (index % TW_SLOTS);
+	}
+}
+
+/**
+  * @brief  Removes a timer from its list
+  * @param  timer: timer in a list
+  * @retval None
+  */
+static void TwUnlink(TwTimerTypeDef *timer)
+{
+	uint32_t index = timer->Index;
+
+	*timer->ppPrev = timer->pNext;
+	if(timer->pNext != NULL)
+	{
+		timer->pNext->ppPrev = timer->ppPrev;
+	}
+	timer->Index = TW_INDEX_IDLE;
+
+	if((index < TW_WHEEL_SLOTS) && (TwLists[index] == NULL))
+	{
+		TwBitmap[index / TW_SLOTS] &= ~(1UL << (index % TW_SLOTS));
+	}
+}
+
+/**
+  * @brief  Puts a timer in the wheel slot of its expiry
+  * @note   The level is the lowest one whose slot contains the expiry and
+  *         TwWheelNow, the expiry is not before TwWheelNow.
+  * @param  timer: timer not in any list
+  * @retval None
+  */
+static void TwQueue(TwTimerTypeDef *timer)
+{
+	uint32_t diff = timer->Expiry ^ TwWheelNow;
+	uint32_t level = 0;
+
+	while((level < TW_LEVELS) && ((diff >> ((level + 1U) * TW_SLOT_BITS)) != 0U))
+	{
+		level++;
+	}
+
+	if(level == TW_LEVELS)
+	{
+		TwLink(timer, TW_INDEX_FAR);
+	}
+	else
+	{
+		TwLink(timer, (level * TW_SLOTS) + TW_SLOT(timer->Expiry, level));
+	}
+}
+
+/**
+  * @brief  Queues again every timer of a list, they move to lower levels
+  * @param  index: wheel slot or TW_INDEX_FAR
+  * @retval None
+  */
+static void TwRequeue(uint32_t index)
+{
+	TwTimerTypeDef *timer = TwLists[index];
+	TwTimerTypeDef *next;
+
+	TwLists[index] = NULL;
+	if(index < TW_WHEEL_SLOTS)
+	{
+		TwBitmap[index / TW_SLOTS] &= ~(1UL << (index % TW_SLOTS));
+	}
+
+	while(timer != NULL)
+	{
+		next = timer->pNext;
+		TwQueue(timer);
+		timer = next;
+	}
+}
+
+/**
+  * @brief  Finds the next wheel event after TwWheelNow
+  * @note   Every slot of a level is before every occupied slot of the levels
+  *         above, so the first occupied level gives the event.
+  * @param  pEvent: wheel tick of the event
+  * @retval 1 if there is an event, 0 if no timer is queued
+  */
+static uint32_t TwNextEvent(uint32_t *pEvent)
+{
+	uint32_t level;
+	uint32_t shift;
+	uint32_t bits;
+
+	for(level = 0; level < TW_LEVELS; level++)
+	{
+		shift = level * TW_SLOT_BITS;
+		bits = TwBitmap[level] & (0xFFFFFFFFU << TW_SLOT(TwWheelNow, level));
+		if(bits != 0U)
+		{
+			/* Start of the slot, the expiry itself on level 0 */
+			*pEvent = (TwWheelNow & ~((TW_SLOTS << shift) - 1U)) | (TwLowestBit(bits) << shift);
+			return 1U;
+		}
+	}
+
+	if(TwLists[TW_INDEX_FAR] != NULL)
+	{
+		*pEvent = (TwWheelNow | (TW_SPAN - 1U)) + 1U;
+		return 1U;
+	}
+
+	return 0U;
+}
+
+/**
+  * @brief  Processes the wheel event at a tick
+  * @note   Slots starting at the tick move down to lower levels, from the far
+  *         list down to level 1, then the level 0 slot expires to the due list.
+  * @param  tick: wheel tick of the event
+  * @retval None
+  */
+static void TwAdvance(uint32_t tick)
+{
+	uint32_t level;
+	uint32_t index;
+	TwTimerTypeDef *timer;
+
+	TwWheelNow = tick;
+
+	if(((tick & (TW_SPAN - 1U)) == 0U) && (TwLists[TW_INDEX_FAR] != NULL))
+	{
+		TwRequeue(TW_INDEX_FAR);
+	}
+
+	for(level = TW_LEVELS - 1U; level > 0U; level--)
+	{
+		index = (level * TW_SLOTS) + TW_SLOT(tick, level);
+		if(((tick & ((1UL << (level * TW_SLOT_BITS)) - 1U)) == 0U) && (TwLists[index] != NULL))
+		{
+			TwRequeue(index);
+		}
+	}
+
+	index = TW_SLOT(tick, 0U);
+	while((timer = TwLists[index]) != NULL)
+	{
+		TwUnlink(timer);
+		TwLink(timer, TW_INDEX_DUE);
+	}
+}
+
+/**
+  * @brief  Processes every wheel event up to the current tick
+  * @param  now: current wheel tick
+  * @retval None
+  */
+static void TwUpdate(uint32_t now)
+{
+	uint32_t event;
+
+	while(TwNextEvent(&event) && ((int32_t)(event - now) <= 0))
+	{
+		TwAdvance(event);
+	}
+	/* No slot starts in between */
+	TwWheelNow = now;
+
+	if(TwLists[TW_INDEX_DUE] != NULL)
+	{
+#if defined(TW_USE_PENDSV)
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+#endif
+	}
+}
+
+/**
+  * @brief  Adds timer counts to the wheel time
+  * @param  cycles: PCLK cycles
+  * @retval None
+  */
+static void TwFold(uint32_t cycles)
+{
+	TwBase += cycles / TwTickCycles;
+	TwRem += cycles % TwTickCycles;
+	if(TwRem >= TwTickCycles)
+	{
+		TwRem -= TwTickCycles;
+		TwBase++;
+	}
+}
+
+/**
+  * @brief  PCLK cycles since TwCountStart, interrupts disabled by the caller
+  * @note   An overflow not served yet is accounted for.
+  * @param  None
+  * @retval PCLK cycles
+  */
+static uint32_t TwElapsed(void)
+{
+	uint32_t count = __HAL_BASETIM_GET_COUNTER(TwTimer);
+
+	if(__HAL_BASETIM_GET_FLAG(TwTimer))
+	{
+		/* Wrapped, read again in case it wrapped after the first read */
+		return (0U - TwCountStart) + (__HAL_BASETIM_GET_COUNTER(TwTimer) - TW_RELOAD);
+	}
+	return count - TwCountStart;
+}
+
+/**
+  * @brief  Current wheel tick, interrupts disabled by the caller
+  * @param  None
+  * @retval Wheel tick
+  */
+static uint32_t TwNow(void)
+{
+	uint32_t cycles = TwElapsed();
+
+	return TwBase + (cycles / TwTickCycles) + (((TwRem + (cycles % TwTickCycles)) >= TwTickCycles) ? 1U : 0U);
+}
+
+/**
+  * @brief  Programs the timer interrupt for the next wheel event
+  * @note   The count is computed from a first reading while the counter runs.
+  *         The counter is then stopped to be rewritten: the cycles since that
+  *         reading and the TW_RESTART_CYCLES it stands still are folded in and
+  *         taken off the count.
+  * @param  None
+  * @retval None
+  */
+static void TwProgram(void)
+{
+	uint32_t event = 0;
+	uint32_t ticks;
+	uint32_t count;
+	uint32_t elapsed;
+	uint32_t late;
+
+	/* An overflow is pending, its interrupt programs the next one */
+	if(__HAL_BASETIM_GET_FLAG(TwTimer))
+	{
+		return;
+	}
+
+	TwArmed = TwNextEvent(&event);
+	TwWake = event;
+
+	elapsed = TwElapsed();
+	TwFold(elapsed);
+	ticks = event - TwBase;
+	if(!TwArmed || (((int32_t)ticks > 0) && (ticks >= TwMaxTicks)))
+	{
+		/* Free running period */
+		count = 0U - TW_RELOAD;
+	}
+	else if((int32_t)ticks <= 0)
+	{
+		/* Already due */
+		count = TW_MIN_COUNTS;
+	}
+	else
+	{
+		count = (ticks * TwTickCycles) - TwRem;
+		if(count < TW_MIN_COUNTS)
+		{
+			count = TW_MIN_COUNTS;
+		}
+	}
+
+	/* From here to the restart the counter stands still for about
+	   TW_RESTART_CYCLES, keep this path short and free of divisions */
+	TwTimer->Instance->CR &= ~BASETIM_CR_TR;
+	late = TwElapsed() - elapsed + TW_RESTART_CYCLES;
+	/* An overflow since the first reading is counted in late */
+	__HAL_BASETIM_CLEAR_IT(TwTimer);
+	TwRem += late;
+	while(TwRem >= TwTickCycles)
+	{
+		TwRem -= TwTickCycles;
+		TwBase++;
+	}
+	count = (count > (late + TW_MIN_COUNTS)) ? (count - late) : TW_MIN_COUNTS;
+
+	/* The counter overflows after 2^32 - LOAD cycles */
+	TwCountStart = 0U - count;
+	TwTimer->Instance->LOAD = TwCountStart;
+	TwTimer->Instance->CR |= BASETIM_CR_TR;
+}
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Starts the timer wheel, no timer is running
+  * @note   The timer interrupt is owned by this module. The timer clock is
+  *         enabled in HAL_BASETIM_Base_MspInit().
+  * @param  htim: TIM10 or TIM11 handle, Instance set, it is configured here
+  * @retval HAL status
+  */
+HAL_StatusTypeDef TwInit(BASETIM_HandleTypeDef *htim)
+{
+	IRQn_Type tim_irq;
+	uint32_t i;
+
+	if(htim == NULL)
+	{
+		return HAL_ERROR;
+	}
+	tim_irq = (htim->Instance == TIM10) ? TIM10_IRQn : TIM11_IRQn;
+
+	TwTickCycles = HAL_RCC_GetPCLKFreq() / TW_TICK_HZ;
+	if(TwTickCycles == 0U)
+	{
+		return HAL_ERROR;
+	}
+	TwMaxTicks = (0U - TW_RELOAD) / TwTickCycles;
+
+	HAL_NVIC_DisableIRQ(tim_irq);
+
+	TwTimer = htim;
+	for(i = 0; i < (TW_WHEEL_SLOTS + 2U); i++)
+	{
+		TwLists[i] = NULL;
+	}
+	for(i = 0; i < TW_LEVELS; i++)
+	{
+		TwBitmap[i] = 0;
+	}
+	TwWheelNow = 0;
+	TwBase = 0;
+	TwRem = 0;
+	TwCountStart = TW_RELOAD;
+	TwWake = 0;
+	TwArmed = 0;
+
+	/* Free running from TW_RELOAD until reprogrammed */
+	htim->Init.GateEnable = BASETIM_GATE_DISABLE;
+	htim->Init.GateLevel = BASETIM_GATELEVEL_HIGH;
+	htim->Init.TogEnable = BASETIM_TOG_DISABLE;
+	htim->Init.CntTimSel = BASETIM_TIMER_SELECT;
+	htim->Init.AutoReload = BASETIM_AUTORELOAD_ENABLE;
+	htim->Init.MaxCntLevel = BASETIM_MAXCNTLEVEL_32BIT;
+	htim->Init.OneShot = BASETIM_REPEAT_MODE;
+	htim->Init.Prescaler = BASETIM_PRESCALER_DIV1;
+	htim->Init.Period = TW_RELOAD;
+	if(HAL_BASETIM_Base_Init(htim) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+	__HAL_BASETIM_CLEAR_IT(htim);
+	HAL_BASETIM_Base_Start_IT(htim);
+
+	HAL_NVIC_SetPriority(tim_irq, TW_IRQ_PRIORITY);
+	HAL_NVIC_EnableIRQ(tim_irq);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Sets the callback of a timer, the timer is stopped
+  * @param  timer: timer
+  * @param  callback: function called on expiry, in the deferred context
+  * @param  pArg: callback argument
+  * @retval None
+  */
+void TwTimerInit(TwTimerTypeDef *timer, TwCallbackTypeDef callback, void *pArg)
+{
+	timer->pNext = NULL;
+	timer->ppPrev = NULL;
+	timer->Expiry = 0;
+	timer->Period = 0;
+	timer->Callback = callback;
+	timer->pArg = pArg;
+	timer->Index = TW_INDEX_IDLE;
+}
+
+/**
+  * @brief  Starts or restarts a timer
+  * @note   May be called from the callbacks and from interrupt handlers.
+  * @param  timer: timer set by TwTimerInit()
+  * @param  delay: wheel ticks to the first expiry
+  * @param  period: wheel ticks between the next expiries, 0 for one shot
+  * @retval None
+  */
+void TwStart(TwTimerTypeDef *timer, uint32_t delay, uint32_t period)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t now;
+
+	__disable_irq();
+
+	if(timer->Index != TW_INDEX_IDLE)
+	{
+		TwUnlink(timer);
+	}
+
+	now = TwNow();
+	TwUpdate(now);
+	timer->Expiry = now + delay;
+	timer->Period = period;
+	TwQueue(timer);
+
+	if(!TwArmed || ((int32_t)(timer->Expiry - TwWake) < 0))
+	{
+		TwProgram();
+	}
+
+	__set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Stops a timer, its callback is not called any more
+  * @note   The timer interrupt stays programmed, it just finds nothing to do.
+  * @param  timer: timer set by TwTimerInit()
+  * @retval None
+  */
+void TwStop(TwTimerTypeDef *timer)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if(timer->Index != TW_INDEX_IDLE)
+	{
+		TwUnlink(timer);
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Tells if a timer is running
+  * @note   A one shot timer stays running until its callback is called.
+  * @param  timer: timer set by TwTimerInit()
+  * @retval 1 if running, 0 if stopped
+  */
+uint32_t TwIsRunning(const TwTimerTypeDef *timer)
+{
+	return (timer->Index != TW_INDEX_IDLE) ? 1U : 0U;
+}
+
+/**
+  * @brief  Returns the wheel time
+  * @param  None
+  * @retval Wheel ticks since TwInit()
+  */
+uint32_t TwGetTime(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t now;
+
+	__disable_irq();
+	now = TwNow();
+	__set_PRIMASK(primask);
+
+	return now;
+}
+
+/**
+  * @brief  Runs the callbacks of the expired timers
+  * @note   Call it from the main loop, or from PendSV_Handler() with
+  *         TW_USE_PENDSV. Periodic timers are queued again before their
+  *         callback runs, which may stop or restart them.
+  * @param  None
+  * @retval None
+  */
+void TwProcess(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	TwTimerTypeDef *timer;
+	uint32_t now;
+
+	for(;;)
+	{
+		__disable_irq();
+		timer = TwLists[TW_INDEX_DUE];
+		if(timer == NULL)
+		{
+			__set_PRIMASK(primask);
+			break;
+		}
+		TwUnlink(timer);
+
+		if(timer->Period != 0U)
+		{
+			now = TwNow();
+			TwUpdate(now);
+			timer->Expiry += timer->Period;
+			/* Late by more than a period, restart from now */
+			if((int32_t)(timer->Expiry - now) < 0)
+			{
+				timer->Expiry = now;
+			}
+			TwQueue(timer);
+			if(!TwArmed || ((int32_t)(timer->Expiry - TwWake) < 0))
+			{
+				TwProgram();
+			}
+		}
+		__set_PRIMASK(primask);
+
+		timer->Callback(timer->pArg);
+	}
+}
+
+/**
+  * @brief  Timer interrupt service, call it from HAL_BASETIM_PeriodElapsedCallback()
+  * @param  htim: BASETIM handle passed to the callback
+  * @retval None
+  */
+void TwTimerElapsed(BASETIM_HandleTypeDef *htim)
+{
+	if(htim != TwTimer)
+	{
+		return;
+	}
+
+	/* Flag cleared by HAL_BASETIM_IRQHandler(), reloaded from BGLOAD */
+	TwFold(0U - TwCountStart);
+	TwCountStart = TW_RELOAD;
+
+	TwUpdate(TwNow());
+	TwProgram();
+}
@@ -0,0 +1,82 @@
+/**
+  ******************************************************************************
+  * @file    twheel.h
+  * @author  Application Team
+	* @Version V1.0.0
+  * @Date    1-April-2019
+  * @brief   Header file of software timer wheel module.
+  ******************************************************************************
+  */
+
+#ifndef __CX32L003_TWHEEL_H
+#define __CX32L003_TWHEEL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "cx32l003_hal.h"
+
+/*
+ * Hierarchical timer wheel for any number of one shot and periodic software
+ * timers, driven by one BASETIM (TIM10 or TIM11) interrupt.
+ * Time counts in wheel ticks of 1/TW_TICK_HZ s. A timer is kept in one slot
+ * of TW_LEVELS levels of TW_SLOTS slots: level l holds the timers expiring
+ * after the current time but within the same level l + 1 slot, at the slot of
+ * their expiry bits for level l. Timers further than the last level wait in a
+ * far list. Starting or stopping a timer is thus a list insertion or removal
+ * plus a bit in the level bitmap, whatever the number of timers.
+ * There is no periodic tick. The next event is the first occupied level 0
+ * slot (timers expire) or the start of the first occupied higher level slot
+ * (its timers move to lower levels), found from the bitmaps in TW_LEVELS
+ * steps. The BASETIM runs at PCLK and its LOAD is reprogrammed so the
+ * interrupt only comes at that event, or after 2^32 PCLK cycles when no timer
+ * runs. The timer counts are folded into the wheel time with the fraction of a
+ * tick carried. Rewriting LOAD stops the counter for a moment: these
+ * TW_RESTART_CYCLES are counted as elapsed too, so each reprogramming only
+ * adds the difference between this value and the real stop time, a few PCLK
+ * cycles, to the wheel time. The timer is only reprogrammed for a new event.
+ * The interrupt only moves expired timers to a due list. Their callbacks run
+ * in a deferred context, from TwProcess() called by the main loop or, with
+ * TW_USE_PENDSV, by PendSV_Handler() which the interrupt pends. Periodic
+ * timers are restarted from their previous expiry, so they do not drift either.
+ * TwInit() configures the timer, the application enables its clock in
+ * HAL_BASETIM_Base_MspInit(), calls HAL_BASETIM_IRQHandler() from the timer
+ * IRQ handler and TwTimerElapsed() from HAL_BASETIM_PeriodElapsedCallback().
+ */
+
+/* Wheel tick frequency, HAL_RCC_GetPCLKFreq() must be a multiple of it */
+#define TW_TICK_HZ						1000U
+/* Levels and slots per level, TW_LEVELS * TW_SLOT_BITS below 32 */
+#define TW_LEVELS							5U
+#define TW_SLOT_BITS					4U
+#define TW_SLOTS							(1U << TW_SLOT_BITS)
+/* Priority of the timer interrupt */
+#define TW_IRQ_PRIORITY				PRIORITY_LOW
+/* PCLK cycles the counter stands still in TwProgram(), estimated for PCLK = HCLK */
+#define TW_RESTART_CYCLES			40U
+
+/* Uncomment to run the callbacks from PendSV_Handler(), which must call TwProcess() */
+//#define TW_USE_PENDSV
+
+typedef void (*TwCallbackTypeDef)(void *pArg);
+
+/* Software timer, owned by the application, its fields are private */
+typedef struct TwTimer
+{
+	struct TwTimer *pNext;				/* Next timer in the same list */
+	struct TwTimer **ppPrev;			/* Pointer that points to this timer */
+	uint32_t Expiry;							/* Wheel tick of the next expiry */
+	uint32_t Period;							/* Wheel ticks between expiries, 0 for one shot */
+	TwCallbackTypeDef Callback;
+	void *pArg;
+	uint8_t Index;								/* List holding the timer */
+} TwTimerTypeDef;
+
+
+HAL_StatusTypeDef TwInit(BASETIM_HandleTypeDef *htim);
+void TwTimerInit(TwTimerTypeDef *timer, TwCallbackTypeDef callback, void *pArg);
+void TwStart(TwTimerTypeDef *timer, uint32_t delay, uint32_t period);
+void TwStop(TwTimerTypeDef *timer);
+uint32_t TwIsRunning(const TwTimerTypeDef *timer);
+uint32_t TwGetTime(void);
+void TwProcess(void);
+void TwTimerElapsed(BASETIM_HandleTypeDef *htim);
+#endif /* __CX32L003_TWHEEL_H */
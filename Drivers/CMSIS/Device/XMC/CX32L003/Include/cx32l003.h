@@ -1619,6 +1619,7 @@ typedef struct {															/*!< (@ 0x40004C00U) DBG Structure
 #define UART_SCON_REN											UART_SCON_REN_Msk
 #define UART_SCON_SM2_Pos                 (5UL)                     /*!< UART SCON: SM2 (Bit 5)                                */
 #define UART_SCON_SM2_Msk                 (0x20UL)                  /*!< UART SCON: SM2 (Bitfield-Mask: 0x01)                  */
+#define UART_SCON_SM2											UART_SCON_SM2_Msk
 #define UART_SCON_SM0_SM1_Pos             (6UL)                     /*!< UART SCON: SM0_SM1 (Bit 6)                            */
 #define UART_SCON_SM0_SM1_Msk             (0xc0UL)                  /*!< UART SCON: SM0_SM1 (Bitfield-Mask: 0x03)              */
 #define UART_SCON_SM0_SM1									UART_SCON_SM0_SM1_Msk
@@ -1634,9 +1635,11 @@ typedef struct {															/*!< (@ 0x40004C00U) DBG Structure
 /* =========================================================  SADDR  ========================================================= */
 #define UART_SADDR_SADDR_Pos              (0UL)                     /*!< UART SADDR: SADDR (Bit 0)                             */
 #define UART_SADDR_SADDR_Msk              (0xffUL)                  /*!< UART SADDR: SADDR (Bitfield-Mask: 0xff)               */
+#define UART_SADDR_SADDR									UART_SADDR_SADDR_Msk
 /* =========================================================  SADEN  ========================================================= */
 #define UART_SADEN_SADEN_Pos              (0UL)                     /*!< UART SADEN: SADEN (Bit 0)                             */
 #define UART_SADEN_SADEN_Msk              (0xffUL)                  /*!< UART SADEN: SADEN (Bitfield-Mask: 0xff)               */
+#define UART_SADEN_SADEN									UART_SADEN_SADEN_Msk
 /* =========================================================  INTSR  ========================================================= */
 #define UART_INTSR_RI_Pos                 (0UL)                     /*!< UART INTSR: RI (Bit 0)                                */
 #define UART_INTSR_RI_Msk                 (0x1UL)                   /*!< UART INTSR: RI (Bitfield-Mask: 0x01)                  */
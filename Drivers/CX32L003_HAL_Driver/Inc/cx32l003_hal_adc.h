@@ -112,6 +112,126 @@ typedef struct
 																					  This parameter can be a value between 0x0000 to 0x0fff */	
 }ADC_ThresholdConfTypeDef;
 
+/**
+  * @brief  ADC per channel sample FIFO definition
+  * @note   Head and Tail are free running, the buffer size is a power of two.
+  *         Head is only written by the interrupt, Tail by the reader.
+  */
+typedef struct
+{
+  uint16_t                      *pBuffer;               /*!< Sample storage                          */
+
+  uint16_t                      Mask;                   /*!< Buffer size - 1                         */
+
+  __IO uint16_t                 Head;                   /*!< Write index, owned by HAL_ADC_IRQHandler */
+
+  __IO uint16_t                 Tail;                   /*!< Read index, owned by HAL_ADC_ReadSamples */
+}ADC_FifoTypeDef;
+
+/**
+  * @brief  ADC oversampling configuration definition
+  * @note   Each sample is the hardware sum (RESULT_ACC) of Ratio conversions of one
+  *         channel, shifted right by RightShift. Samples then go through the optional
+  *         moving average and CIC decimator before being stored in pBlock.
+  *         With AverageLength above 1 the samples, 4095 * Ratio >> RightShift, must
+  *         fit in 16 bits.
+  *         CIC arithmetic is modulo 2^32: sample bits + CicOrder * log2(CicDecimation)
+  *         must not exceed 32.
+  *         Results are stored on 16 bits: 4095 * Ratio >> RightShift, and with the CIC
+  *         its bit count + CicOrder * log2(CicDecimation) - CicShift, must fit in 16 bits.
+  */
+typedef struct
+{
+  uint32_t Ratio;                     /*!< Conversions accumulated per sample.
+                                           This parameter can be a value between 1 and 256 */
+
+  uint32_t RightShift;                /*!< Right shift of the accumulated value, log2(Ratio) - n gives n extra bits.
+                                           This parameter can be a value between 0 and 8 */
+
+  uint32_t AverageLength;             /*!< Moving average window in samples, 1 disables it.
+                                           This parameter can be 1, 2, 4, 8 or 16 */
+
+  uint32_t CicOrder;                  /*!< CIC decimator order, 0 disables it.
+                                           This parameter can be a value between 0 and 3 */
+
+  uint32_t CicDecimation;             /*!< CIC decimation ratio, samples per output.
+                                           This parameter can be a value between 1 and 65535 */
+
+  uint32_t CicShift;                  /*!< Right shift of the CIC output, log2(CicDecimation) * CicOrder gives unity gain.
+                                           This parameter can be a value between 0 and 31 */
+
+  uint16_t *pBlock;                   /*!< Output storage of 2 * BlockLength results, filled as a ping pong buffer */
+
+  uint16_t BlockLength;               /*!< Results per block callback */
+}ADC_OversamplingInitTypeDef;
+
+/**
+  * @brief  ADC oversampling context definition, owned by the ADC interrupt once started
+  */
+typedef struct
+{
+  ADC_OversamplingInitTypeDef   Init;                   /*!< Oversampling parameters */
+
+  uint32_t                      AverageSum;             /*!< Sum of AverageHistory */
+
+  uint16_t                      AverageHistory[16];     /*!< Last AverageLength samples */
+
+  uint8_t                       AverageIndex;           /*!< Oldest sample of AverageHistory */
+
+  uint8_t                       AverageShift;           /*!< log2(AverageLength) */
+
+  uint16_t                      CicCount;               /*!< Samples since the last CIC output */
+
+  uint32_t                      Integrator[3];          /*!< CIC integrator stages */
+
+  uint32_t                      Comb[3];                /*!< CIC comb stages delay */
+
+  uint16_t                      BlockIndex;             /*!< Next result position in pBlock */
+
+  uint32_t                      SavedCR2;               /*!< CR2 fields overwritten by the start, restored by the stop */
+}ADC_OversamplingTypeDef;
+
+/**
+  * @brief  ADC analog watchdog configuration definition
+  */
+typedef struct
+{
+  uint32_t HighThreshold;             /*!< Level above which an ADC_WATCHDOG_EVENT_HIGH is reported.
+                                           This parameter can be a value between 0x0000 to 0x0fff */
+
+  uint32_t LowThreshold;              /*!< Level below which an ADC_WATCHDOG_EVENT_LOW is reported.
+                                           This parameter can be a value between 0x0000 to HighThreshold */
+
+  uint32_t Hysteresis;                /*!< Distance the level has to come back inside before ADC_WATCHDOG_EVENT_NORMAL.
+                                           This parameter can be a value between 0x0000 to HighThreshold - LowThreshold */
+}ADC_WatchdogInitTypeDef;
+
+/**
+  * @brief  ADC analog watchdog event definition
+  */
+typedef struct
+{
+  uint32_t Timestamp;                 /*!< HAL_ADC_WatchdogGetTimestamp() at the crossing */
+
+  uint16_t Value;                     /*!< Conversion result which crossed the threshold */
+
+  uint8_t  Type;                      /*!< Crossing type, a value of @ref ADC_Watchdog_Event */
+}ADC_WatchdogEventTypeDef;
+
+/**
+  * @brief  ADC analog watchdog context definition, owned by the ADC interrupt once started
+  */
+typedef struct
+{
+  ADC_WatchdogInitTypeDef       Init;                   /*!< Watchdog parameters */
+
+  __IO uint8_t                  Zone;                   /*!< Current zone of the level: ADC_WATCHDOG_EVENT_xxx */
+
+  __IO uint8_t                  EventPending;           /*!< Event holds a crossing not read by HAL_ADC_Watchdog_WaitEvent() */
+
+  ADC_WatchdogEventTypeDef      Event;                  /*!< Latest crossing */
+}ADC_WatchdogTypeDef;
+
 /** 
   * @brief  HAL ADC state machine: ADC states definition (bitfields)
   */ 
@@ -147,6 +267,14 @@ typedef struct
   __IO uint32_t                 State;                  /*!< ADC communication state (bitmap of ADC states) */
 
   __IO uint32_t                 ErrorCode;              /*!< ADC Error code */
+
+  ADC_FifoTypeDef               Fifo[8];                /*!< Continuous mode sample FIFO of each channel */
+
+  uint32_t                      FifoMask;               /*!< Channels owning a FIFO, combination of @ref ADC_ContinueChannelSel */
+
+  ADC_OversamplingTypeDef       *pOversampling;         /*!< Oversampling context, NULL when not running */
+
+  ADC_WatchdogTypeDef           *pWatchdog;             /*!< Analog watchdog context, NULL when not running */
 }ADC_HandleTypeDef;
 /**
   * @}
@@ -167,6 +295,7 @@ typedef struct
 #define HAL_ADC_ERROR_NONE                0x00U   /*!< No error                                              */
 #define HAL_ADC_ERROR_INTERNAL            0x01U   /*!< ADC IP internal error: if problem of clocking, 
                                                        enable/disable, erroneous state                       */
+#define HAL_ADC_ERROR_OVR                 0x02U   /*!< A channel FIFO was full, samples were dropped         */
 
 /**
   * @}
@@ -341,12 +470,27 @@ typedef struct
 
 #define ADC_INTFLAG_CHANNEL_ALL											(ADC_INTFLAG_CHANNEL0 | ADC_INTFLAG_CHANNEL1 | ADC_INTFLAG_CHANNEL2 | ADC_INTFLAG_CHANNEL3 | \
 																										ADC_INTFLAG_CHANNEL4 | ADC_INTFLAG_CHANNEL5 | ADC_INTFLAG_CHANNEL6 | ADC_INTFLAG_CHANNEL7)
+
+#define ADC_INTFLAG_ALL													(ADC_INTFLAG_CHANNEL_ALL | ADC_INTFLAG_CONTINUE | ADC_INTFLAG_RANGE_THRESHOLD | \
+																										 ADC_INTFLAG_HIGH_THRESHOLD | ADC_INTFLAG_LOW_THERSHOLD)
 /**
   * @}
   */
 
 
 
+/** @defgroup ADC_Watchdog_Event ADC analog watchdog events and zones
+  * @{
+  */
+#define ADC_WATCHDOG_EVENT_NORMAL										0x00U											/*!< Level came back between the thresholds */
+#define ADC_WATCHDOG_EVENT_HIGH											0x01U											/*!< Level went above HighThreshold */
+#define ADC_WATCHDOG_EVENT_LOW											0x02U											/*!< Level went below LowThreshold */
+
+/**
+  * @}
+  */
+
+
 /** @defgroup ADC_External_trigger_source1 ADC external trigger source 1 select
   * @{
   */	
@@ -708,6 +852,21 @@ typedef struct
                                  ((CHANNEL) == ADC_CHANNEL_7)            )
       
 #define IS_ADC_ALL_INSTANCE(INSTANCE) ((INSTANCE) == ADC)			
+
+#define IS_ADC_CONTINUE_CHANNEL(CHANNEL) (((CHANNEL) != 0U) && (((CHANNEL) & ((CHANNEL) - 1U)) == 0U) && \
+                                          (((CHANNEL) & ~ADC_CR2_CHEN) == 0U))
+
+#define IS_ADC_FIFO_SIZE(SIZE) (((SIZE) >= 2U) && (((SIZE) & ((SIZE) - 1U)) == 0U))
+
+#define IS_ADC_OVERSAMPLING_RATIO(RATIO) (((RATIO) >= 1U) && ((RATIO) <= 256U))
+
+#define IS_ADC_OVERSAMPLING_SHIFT(SHIFT) ((SHIFT) <= 8U)
+
+#define IS_ADC_OVERSAMPLING_AVERAGE(LENGTH) (((LENGTH) == 1U) || ((LENGTH) == 2U) || ((LENGTH) == 4U) || \
+                                             ((LENGTH) == 8U) || ((LENGTH) == 16U))
+
+#define IS_ADC_OVERSAMPLING_CIC(ORDER, DECIMATION, SHIFT) (((ORDER) <= 3U) && ((DECIMATION) >= 1U) && \
+                                                           ((DECIMATION) <= 0xFFFFU) && ((SHIFT) <= 31U))
 			
 /**
   * @}
@@ -755,6 +914,23 @@ HAL_StatusTypeDef       HAL_ADC_Stop_IT(ADC_HandleTypeDef* hadc);
 uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef* hadc, uint32_t channel);
 uint32_t HAL_ADC_GetAccValue(ADC_HandleTypeDef* hadc);
 
+/* Continuous mode sample FIFOs filled by HAL_ADC_IRQHandler */
+HAL_StatusTypeDef       HAL_ADC_ConfigFifo(ADC_HandleTypeDef* hadc, uint32_t Channel, uint16_t *pBuffer, uint16_t Size);
+uint16_t                HAL_ADC_ReadSamples(ADC_HandleTypeDef* hadc, uint32_t Channel, uint16_t *pData, uint16_t Size);
+uint16_t                HAL_ADC_GetSampleCount(ADC_HandleTypeDef* hadc, uint32_t Channel);
+
+/* Continuous mode oversampling on the conversion result accumulator */
+HAL_StatusTypeDef       HAL_ADC_Oversampling_Start_IT(ADC_HandleTypeDef* hadc, ADC_OversamplingTypeDef* hovs);
+HAL_StatusTypeDef       HAL_ADC_Oversampling_Stop_IT(ADC_HandleTypeDef* hadc);
+void                    HAL_ADC_OversamplingBlockCallback(ADC_HandleTypeDef* hadc, uint16_t *pBlock, uint16_t Length);
+
+/* Continuous mode analog watchdog with hysteresis */
+HAL_StatusTypeDef       HAL_ADC_Watchdog_Start_IT(ADC_HandleTypeDef* hadc, ADC_WatchdogTypeDef* hwdg);
+HAL_StatusTypeDef       HAL_ADC_Watchdog_Stop_IT(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef       HAL_ADC_Watchdog_WaitEvent(ADC_HandleTypeDef* hadc, ADC_WatchdogEventTypeDef* pEvent);
+void                    HAL_ADC_WatchdogCallback(ADC_HandleTypeDef* hadc, ADC_WatchdogEventTypeDef* pEvent);
+uint32_t                HAL_ADC_WatchdogGetTimestamp(ADC_HandleTypeDef* hadc);
+
 /* ADC IRQHandler and Callbacks used in non-blocking modes (Interruption) */
 void                    HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc);
 
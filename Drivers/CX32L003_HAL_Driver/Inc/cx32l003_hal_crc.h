@@ -63,6 +63,7 @@ typedef struct
 
 /* Exported constants --------------------------------------------------------*/
 #define CRC_DATA_ADDRESS	(CRC_BASE+0x80)
+#define CRC_SW_INIT_VALUE	(0xFFFFU)		/*!< Initial value used by HAL_CRC_SW_Calculate() */
 
 /* Exported macro ------------------------------------------------------------*/
 
@@ -130,6 +131,8 @@ void                  HAL_CRC_MspDeInit(CRC_HandleTypeDef *hcrc);
 uint32_t              HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint8_t pBuffer[], uint32_t BufferLength);
 uint32_t              HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint8_t pBuffer[], uint32_t BufferLength);
 ErrorStatus 					HAL_Get_CRC_RESULT_FLAG(CRC_HandleTypeDef *hcrc);
+uint32_t              HAL_CRC_SW_Accumulate(uint32_t Crc, const uint8_t pBuffer[], uint32_t BufferLength);
+uint32_t              HAL_CRC_SW_Calculate(const uint8_t pBuffer[], uint32_t BufferLength);
   
 /**
   * @}
@@ -121,7 +121,7 @@ typedef struct
   */
 
 #define HAL_FLASH_ERROR_NONE      0x00U  /*!< No error */
-//#define HAL_FLASH_ERROR_PROG      0x01U  /*!< Programming error, reserved for future*/
+#define HAL_FLASH_ERROR_PROG      0x01U  /*!< Programming error: target needs an erase or read back mismatch */
 #define HAL_FLASH_ERROR_ERASEWP   0x02U  /*!< Erase write protected area error */
 #define HAL_FLASH_ERROR_ERASEPC   0x04U  /*!< Erase area contained PC error */
 
@@ -288,6 +288,7 @@ typedef struct
   */
 /* IO operation functions *****************************************************/
 HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASH_ProgramBuffer(uint32_t Address, const uint8_t *pData, uint32_t Length);
 HAL_StatusTypeDef HAL_FLASH_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
 
 /* FLASH IRQ handler function */
@@ -86,10 +86,103 @@ typedef enum
 } I2CStatus;
 
 
+struct __I2C_HandleTypeDef;
+
+/** 
+  * @brief  I2C master interrupt transfer descriptor definition
+  * @note   TxSize bytes are written first, then RxSize bytes are read after a
+  *         repeated start. Either size may be 0 for a write or a read only transfer.
+  */ 
+typedef struct __I2C_TransferTypeDef
+{
+	uint8_t DevAddress;						/*!< Device address, the 7 bits address shifted left by one */
+
+	const uint8_t *pTxData;					/*!< Data to write, may be NULL when TxSize is 0 */
+
+	uint16_t TxSize;						/*!< Number of bytes to write */
+
+	uint8_t *pRxData;						/*!< Buffer for the read data, may be NULL when RxSize is 0 */
+
+	uint16_t RxSize;						/*!< Number of bytes to read */
+
+	uint32_t Timeout;						/*!< Maximum duration of the transfer in ms, checked by HAL_I2C_Master_CheckTimeout */
+
+	void (*XferCpltCallback)(struct __I2C_HandleTypeDef *hi2c, struct __I2C_TransferTypeDef *pXfer);
+											/*!< Called from the interrupt at the end of the transfer, may be NULL */
+
+	void *pContext;							/*!< User data for the callback */
+
+	__IO HAL_StatusTypeDef Status;			/*!< HAL_BUSY while running, then HAL_OK, HAL_ERROR or HAL_TIMEOUT */
+}I2C_TransferTypeDef;
+
+/** 
+  * @brief  I2C batch register access definition
+  */ 
+typedef struct
+{
+	uint8_t DevAddress;						/*!< Device address, the 7 bits address shifted left by one */
+
+	uint8_t Register;						/*!< Register address, written first */
+
+	uint8_t Direction;						/*!< I2C_Direction_Transmitter to write the register,
+											     I2C_Direction_Receiver to read it */
+
+	uint16_t Size;							/*!< Number of data bytes, not 0 for a read */
+
+	uint8_t *pData;							/*!< Data written to or read from the register */
+}I2C_BatchItemTypeDef;
+
+/** 
+  * @brief  I2C batch definition, a list of register accesses done back to back
+  */ 
+typedef struct __I2C_BatchTypeDef
+{
+	I2C_BatchItemTypeDef *pItems;			/*!< Register accesses, done in order */
+
+	uint16_t Count;							/*!< Number of items */
+
+	uint32_t Timeout;						/*!< Maximum duration of the whole batch in ms */
+
+	void (*BatchCpltCallback)(struct __I2C_HandleTypeDef *hi2c, struct __I2C_BatchTypeDef *pBatch);
+											/*!< Called from the interrupt at the end of the batch, may be NULL */
+
+	void *pContext;							/*!< User data for the callback */
+
+	__IO HAL_StatusTypeDef Status;			/*!< HAL_BUSY while running, then HAL_OK, HAL_ERROR or HAL_TIMEOUT */
+
+	__IO uint16_t Index;					/*!< Item in progress, the failed item on error */
+
+	I2C_TransferTypeDef Xfer;				/*!< Transfer of the current item, for internal usage */
+}I2C_BatchTypeDef;
+
+/** 
+  * @brief  I2C slave register map definition
+  * @note   The first byte written by the master after the address sets the
+  *         register pointer, the next bytes are written from there and reads
+  *         start there. The pointer is incremented after each byte.
+  */ 
+typedef struct
+{
+	uint8_t *pRegisters;					/*!< Register file in RAM */
+
+	const uint8_t *pWriteMask;				/*!< Writable bits of each register, 0x00 for a read only
+											     register, NULL when all the registers are read only */
+
+	uint16_t Size;							/*!< Number of registers, 1 to 256 */
+
+	__IO uint8_t Pointer;					/*!< Register pointer */
+
+	uint8_t WriteStart;						/*!< First register written by the current transaction */
+
+	__IO uint16_t WriteCount;				/*!< Registers written by the current transaction */
+
+	__IO uint8_t Phase;						/*!< Next written byte is the pointer or data, for internal usage */
+}I2C_RegMapTypeDef;
+
 /** 
   * @brief  I2C handle Structure definition  
   */ 
-typedef struct 
+typedef struct __I2C_HandleTypeDef
 {
 	I2C_TypeDef *Instance;
 	
@@ -106,6 +199,24 @@ typedef struct
                                              
   __IO uint32_t              ErrorCode;      /*!< I2C Error code                           */
 
+  I2C_TransferTypeDef        *pXfer;         /*!< Master interrupt transfer in progress     */
+
+  const uint8_t              *pTxBuffPtr;    /*!< Next byte to write                        */
+
+  uint8_t                    *pRxBuffPtr;    /*!< Next byte to read                         */
+
+  __IO uint16_t              XferCount;      /*!< Bytes left in the current phase           */
+
+  const uint8_t              *pTxBuffNext;   /*!< Data written after the register of a batch item */
+
+  uint16_t                   XferCountNext;  /*!< Bytes of pTxBuffNext                      */
+
+  I2C_BatchTypeDef           *pBatch;        /*!< Batch in progress                         */
+
+  I2C_RegMapTypeDef          *pRegMap;       /*!< Slave register map, NULL when not used    */
+
+  uint32_t                   XferTickstart;  /*!< Tick at the start of the transfer         */
+
  }I2C_HandleTypeDef;
 
 
@@ -126,6 +237,9 @@ typedef struct
   * @{
   */ 
 #define HAL_I2C_ERROR_NONE       0x00000000U    /*!< No error           */
+#define HAL_I2C_ERROR_BERR       0x00000001U    /*!< Bus error, unexpected status */
+#define HAL_I2C_ERROR_ARLO       0x00000002U    /*!< Arbitration lost   */
+#define HAL_I2C_ERROR_AF         0x00000004U    /*!< No acknowledge     */
 #define HAL_I2C_ERROR_TIMEOUT    0x00000020U    /*!< Timeout Error      */
 /**
   * @}
@@ -307,9 +421,16 @@ HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint8_t DevAdd
 HAL_StatusTypeDef HAL_I2C_Slave_Transmit(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_I2C_Slave_Receive(I2C_HandleTypeDef *hi2c, uint8_t *pData, uint16_t *Size);
 
+HAL_StatusTypeDef HAL_I2C_Master_Transfer_IT(I2C_HandleTypeDef *hi2c, I2C_TransferTypeDef *pXfer);
+HAL_StatusTypeDef HAL_I2C_Master_Batch_IT(I2C_HandleTypeDef *hi2c, I2C_BatchTypeDef *pBatch);
+HAL_StatusTypeDef HAL_I2C_Master_CheckTimeout(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Slave_RegMap_Start_IT(I2C_HandleTypeDef *hi2c, I2C_RegMapTypeDef *pRegMap);
+HAL_StatusTypeDef HAL_I2C_Slave_RegMap_Stop_IT(I2C_HandleTypeDef *hi2c);
+
 void HAL_I2C_IRQHandler(I2C_HandleTypeDef *hi2c);
 __weak void HAL_I2C_MasterCallback(I2C_HandleTypeDef *hi2c);
 __weak void HAL_I2C_SlaveCallback(I2C_HandleTypeDef *hi2c);
+__weak void HAL_I2C_RegMapWriteCallback(I2C_HandleTypeDef *hi2c, uint8_t Register, uint16_t Count);
 
 /**
   * @}
@@ -163,6 +163,10 @@ typedef struct
                                                        This parameter can be a value of @ref HAL_LPUART_StateTypeDef */
 
   __IO uint32_t                 ErrorCode;        /*!< LPUART Error code                    */
+
+  void                          (*TxByte)(LPUART_TypeDef *LPUARTx, uint8_t Data);     /*!< Writes one byte, bound to the frame format by HAL_LPUART_Init() */
+
+  uint32_t                      (*RxByte)(LPUART_TypeDef *LPUARTx, uint8_t *pData);   /*!< Reads one byte, returns a HAL_LPUART_ERROR_xxx code             */
 }LPUART_HandleTypeDef;
 
 /**
@@ -396,6 +400,9 @@ typedef struct
   */
 /* Initialization/de-initialization functions  **********************************/
 HAL_StatusTypeDef HAL_LPUART_Init(LPUART_HandleTypeDef *hlpuart);
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_Init(LPUART_HandleTypeDef *hlpuart, uint8_t Address, uint8_t BroadcastAddress);
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_EnterMuteMode(LPUART_HandleTypeDef *hlpuart);
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_ExitMuteMode(LPUART_HandleTypeDef *hlpuart);
 HAL_StatusTypeDef HAL_LPUART_DeInit (LPUART_HandleTypeDef *hlpuart);
 void HAL_LPUART_MspInit(LPUART_HandleTypeDef *hlpuart);
 void HAL_LPUART_MspDeInit(LPUART_HandleTypeDef *hlpuart);
@@ -408,6 +415,7 @@ void HAL_LPUART_MspDeInit(LPUART_HandleTypeDef *hlpuart);
   */
 /* IO operation functions *******************************************************/
 HAL_StatusTypeDef HAL_LPUART_Transmit(LPUART_HandleTypeDef *hlpuart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_SendAddress(LPUART_HandleTypeDef *hlpuart, uint8_t Address, uint32_t Timeout);
 HAL_StatusTypeDef HAL_LPUART_Receive(LPUART_HandleTypeDef *hlpuart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
 HAL_StatusTypeDef HAL_LPUART_Transmit_IT(LPUART_HandleTypeDef *hlpuart, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_LPUART_Receive_IT(LPUART_HandleTypeDef *hlpuart, uint8_t *pData, uint16_t Size);
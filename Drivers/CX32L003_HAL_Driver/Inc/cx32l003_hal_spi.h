@@ -69,6 +69,96 @@ typedef enum
   HAL_SPI_STATE_ERROR      = 0x06U     /*!< SPI error state                                    */
 }HAL_SPI_StateTypeDef;
 
+/**
+  * @brief  SPI bus device descriptor, one per chip select on a shared bus
+  */
+typedef struct
+{
+  GPIO_TypeDef               *CsPort;             /*!< GPIO port of the device chip select, driven low during a transfer */
+
+  uint16_t                   CsPin;               /*!< GPIO pin of the device chip select */
+
+  uint32_t                   CLKPolarity;         /*!< Serial clock steady state of the device.
+                                                       This parameter can be a value of @ref SPI_Clock_Polarity */
+
+  uint32_t                   CLKPhase;            /*!< Clock active edge of the device.
+                                                       This parameter can be a value of @ref SPI_Clock_Phase */
+
+  uint32_t                   BaudRatePrescaler;   /*!< SCK prescaler for the device.
+                                                       This parameter can be a value of @ref SPI_BaudRate_Prescaler */
+}SPI_DeviceTypeDef;
+
+struct __SPI_HandleTypeDef;
+
+/**
+  * @brief  SPI queued transfer descriptor, owned by the caller until its callback
+  */
+typedef struct __SPI_TransferTypeDef
+{
+  SPI_DeviceTypeDef              *pDevice;        /*!< Device addressed by the transfer */
+
+  const uint8_t                  *pTxData;        /*!< Data to send, NULL to send Fill */
+
+  uint8_t                        *pRxData;        /*!< Received data, NULL to discard it */
+
+  uint16_t                       Size;            /*!< Number of bytes, not 0 */
+
+  uint8_t                        Fill;            /*!< Byte sent when pTxData is NULL */
+
+  void                           (*XferCpltCallback)(struct __SPI_HandleTypeDef *hspi, struct __SPI_TransferTypeDef *pXfer);
+                                                  /*!< Called from the SPI interrupt once the chip select is released, may be NULL */
+
+  void                           *pContext;       /*!< User data for the callback */
+
+  struct __SPI_TransferTypeDef   *pNext;          /*!< Queue link, managed by the driver */
+}SPI_TransferTypeDef;
+
+/**
+  * @brief  SPI slave stream ring buffer definition
+  * @note   Head and Tail are free running, the buffer size is a power of two.
+  *         Head is only written by the producer, Tail by the consumer.
+  */
+typedef struct
+{
+  uint8_t                    *pBuffer;     /*!< Byte storage              */
+
+  uint16_t                   Mask;         /*!< Buffer size - 1           */
+
+  __IO uint16_t              Head;         /*!< Write index               */
+
+  __IO uint16_t              Tail;         /*!< Read index                */
+}SPI_RingTypeDef;
+
+/**
+  * @brief  SPI slave stream configuration definition
+  */
+typedef struct
+{
+  uint8_t                    *pRxBuffer;   /*!< Receive ring storage */
+
+  uint16_t                   RxSize;       /*!< Receive ring size, a power of two */
+
+  uint8_t                    *pTxBuffer;   /*!< Transmit ring storage, NULL to always send Idle */
+
+  uint16_t                   TxSize;       /*!< Transmit ring size, a power of two, ignored when pTxBuffer is NULL */
+
+  uint8_t                    Idle;         /*!< Byte sent when the transmit ring is empty */
+}SPI_SlaveStreamInitTypeDef;
+
+/**
+  * @brief  SPI slave stream context definition
+  */
+typedef struct
+{
+  SPI_SlaveStreamInitTypeDef Init;         /*!< Stream configuration */
+
+  SPI_RingTypeDef            RxRing;       /*!< Received bytes, filled by HAL_SPI_IRQHandler */
+
+  SPI_RingTypeDef            TxRing;       /*!< Bytes to send, drained by HAL_SPI_IRQHandler */
+
+  __IO uint16_t              FrameLength;  /*!< Bytes received since NSS went low */
+}SPI_SlaveStreamTypeDef;
+
 /**
   * @brief  SPI handle Structure definition
   */
@@ -83,6 +173,20 @@ typedef struct __SPI_HandleTypeDef
   __IO HAL_SPI_StateTypeDef  State;        /*!< SPI communication state */
  
   __IO uint32_t              ErrorCode;      /*!< SPI Error code                           */
+
+  SPI_TransferTypeDef        *pXferHead;   /*!< Transfer in progress, head of the interrupt queue */
+
+  SPI_TransferTypeDef        *pXferTail;   /*!< Last queued transfer */
+
+  SPI_DeviceTypeDef          *pDevice;     /*!< Device whose settings are programmed in CR, NULL for Init */
+
+  const uint8_t              *pTxBuffPtr;  /*!< Pointer to the next byte to send */
+
+  uint8_t                    *pRxBuffPtr;  /*!< Pointer to the next received byte */
+
+  uint16_t                   XferCount;    /*!< Bytes of the current transfer still to be received */
+
+  SPI_SlaveStreamTypeDef     *pSlave;      /*!< Slave stream context, NULL when not streaming */
 }SPI_HandleTypeDef;
 
 /**
@@ -238,6 +342,17 @@ HAL_StatusTypeDef HAL_SPI_Slave_Send_Data(SPI_HandleTypeDef *hspi, uint8_t RxDat
 HAL_StatusTypeDef HAL_SPI_Slave_Receive_Data(SPI_HandleTypeDef *hspi, uint8_t *pRxData);
 HAL_StatusTypeDef HAL_SPI_Set_NSS(SPI_HandleTypeDef *hspi, uint32_t NSS_Status);
 void LL_SPI_Master_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint16_t TxSize,uint8_t *pRxData, uint16_t RxSize);
+HAL_StatusTypeDef HAL_SPI_Master_Burst_TransmitReceive(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Master_Burst_Transmit(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Master_Burst_Receive(SPI_HandleTypeDef *hspi, uint8_t *pRxData, uint16_t Size, uint8_t Fill);
+HAL_StatusTypeDef HAL_SPI_Master_Queue_IT(SPI_HandleTypeDef *hspi, SPI_TransferTypeDef *pXfer);
+void HAL_SPI_IRQHandler(SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef HAL_SPI_Slave_Stream_Start_IT(SPI_HandleTypeDef *hspi, SPI_SlaveStreamTypeDef *hstream);
+HAL_StatusTypeDef HAL_SPI_Slave_Stream_Stop_IT(SPI_HandleTypeDef *hspi);
+uint16_t HAL_SPI_Slave_Stream_Write(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size);
+uint16_t HAL_SPI_Slave_Stream_Read(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size);
+void HAL_SPI_Slave_NSS_IRQHandler(SPI_HandleTypeDef *hspi);
+void HAL_SPI_Slave_FrameCpltCallback(SPI_HandleTypeDef *hspi, uint16_t Length);
 /**
   * @}
   */
@@ -287,6 +402,8 @@ uint32_t      HAL_SPI_Get_ErrorFlags(SPI_HandleTypeDef *hspi);
                                               ((PRESCALER) == SPI_BAUDRATEPRESCALER_128))
                                               
 #define IS_SPI_INSTANCE(INSTANCE)       ((INSTANCE) == SPI)
+
+#define IS_SPI_RING_SIZE(SIZE) (((SIZE) >= 2U) && (((SIZE) & ((SIZE) - 1U)) == 0U))
 /**
   * @}
   */
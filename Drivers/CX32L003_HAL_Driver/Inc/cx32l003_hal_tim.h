@@ -279,6 +279,36 @@ typedef enum
   HAL_TIM_ACTIVE_CHANNEL_CLEARED  = 0x00U     /*!< All active channels cleared */
 }HAL_TIM_ActiveChannel;
 
+/**
+  * @brief  TIM PWM sequencer configuration definition
+  * @note   A table holds one step per update event, a step being one sample per
+  *         sequenced channel in channel order (CCR1 first). On TIM1 each step
+  *         lasts Init.RepetitionCounter + 1 PWM periods.
+  */
+typedef struct
+{
+  uint32_t Channels;          /*!< Sequenced channels.
+                                   This parameter can be a combination of @ref HAL_TIM_ActiveChannel */
+
+  uint32_t Mode;              /*!< Behaviour at the end of a table with no table queued.
+                                   This parameter can be a value of @ref TIM_PWMSeq_Mode */
+}TIM_PWMSeqInitTypeDef;
+
+/**
+  * @brief  TIM PWM sequencer context definition, owned by the update interrupt once started
+  */
+typedef struct
+{
+  TIM_PWMSeqInitTypeDef       Init;          /*!< Sequencer parameters                      */
+  __IO uint32_t               *pCCR[4];      /*!< Sequenced CCRx registers                  */
+  uint32_t                    ChannelCount;  /*!< Samples per step                          */
+  const uint16_t              *pTable;       /*!< Table being played                        */
+  const uint16_t              *pSample;      /*!< First sample of the next step             */
+  const uint16_t              *pEnd;         /*!< End of the table being played             */
+  const uint16_t * __IO       pNextTable;    /*!< Table queued, NULL if none                */
+  __IO uint16_t               NextLength;    /*!< Steps of the table queued                 */
+}TIM_PWMSeqTypeDef;
+
 /**
   * @brief  TIM Time Base Handle Structure definition
   */
@@ -289,6 +319,7 @@ typedef struct
   HAL_TIM_ActiveChannel       Channel;       /*!< Active channel                    */
   HAL_LockTypeDef             Lock;          /*!< Locking object                    */
   __IO HAL_TIM_StateTypeDef   State;         /*!< TIM operation state               */
+  TIM_PWMSeqTypeDef           *pPWMSeq;      /*!< PWM sequencer context, NULL when not running */
 }TIM_HandleTypeDef;
 
 /**
@@ -451,6 +482,15 @@ typedef struct
   * @}
   */
 
+/** @defgroup TIM_PWMSeq_Mode TIM PWM sequencer Mode
+  * @{
+  */
+#define TIM_PWMSEQ_MODE_CONTINUOUS         0x00000000U   /*!< The table is played again             */
+#define TIM_PWMSEQ_MODE_SINGLE             0x00000001U   /*!< The sequencer stops on the last step  */
+/**
+  * @}
+  */
+
 /** @defgroup TIM_Input_Capture_Polarity TIM Input Capture Polarity
   * @{
   */
@@ -906,6 +946,11 @@ typedef struct
                                   ((CHANNEL) == TIM_CHANNEL_4) || \
                                   ((CHANNEL) == TIM_CHANNEL_ALL))
 
+#define IS_TIM_PWMSEQ_CHANNELS(CHANNELS) (((CHANNELS) != 0U) && (((CHANNELS) & ~0x0FU) == 0U))
+
+#define IS_TIM_PWMSEQ_MODE(MODE) (((MODE) == TIM_PWMSEQ_MODE_CONTINUOUS) || \
+                                  ((MODE) == TIM_PWMSEQ_MODE_SINGLE))
+
 #define IS_TIM_OPM_CHANNELS(CHANNEL) (((CHANNEL) == TIM_CHANNEL_1) || \
                                       ((CHANNEL) == TIM_CHANNEL_2))
 
@@ -1653,6 +1698,16 @@ HAL_StatusTypeDef HAL_TIM_PWMN_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channe
 HAL_StatusTypeDef HAL_TIM_PWMN_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
 
 HAL_StatusTypeDef HAL_TIM_ConfigBreakDeadTime(TIM_HandleTypeDef *htim, TIM_BreakDeadTimeConfigTypeDef *sBreakDeadTimeConfig);
+
+/* Timer PWM sequencer functions  ********************************************/
+HAL_StatusTypeDef HAL_TIM_PWMSeq_Start_IT(TIM_HandleTypeDef *htim, TIM_PWMSeqTypeDef *hseq, const uint16_t *pTable, uint16_t Length);
+HAL_StatusTypeDef HAL_TIM_PWMSeq_Stop_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWMSeq_Queue(TIM_HandleTypeDef *htim, const uint16_t *pTable, uint16_t Length);
+void HAL_TIM_PWMSeq_IRQHandler(TIM_HandleTypeDef *htim);
+void HAL_TIM_PWMSeq_TableCpltCallback(TIM_HandleTypeDef *htim, const uint16_t *pTable);
+#if defined(ARM_MATH_CM0PLUS)
+HAL_StatusTypeDef HAL_TIM_PWMSeq_SineTable(uint16_t *pTable, uint16_t Length, uint32_t ChannelCount, uint16_t Pulse, uint16_t Amplitude);
+#endif
 /**
   * @}
   */
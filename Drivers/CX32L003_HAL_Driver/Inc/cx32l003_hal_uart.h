@@ -122,6 +122,24 @@ typedef enum
                                                    Value is allowed for gState only */
 }HAL_UART_StateTypeDef;
 
+/** 
+  * @brief  UART ring buffer structure definition
+  * @note   The ring is a single-producer/single-consumer queue: Head is only
+  *         advanced by the producer and Tail only by the consumer, so no lock
+  *         is needed between the main loop and HAL_UART_IRQHandler().
+  *         Head and Tail are free running, Size must be a power of two.
+  */
+typedef struct
+{
+  uint8_t                       *pBuffer;         /*!< Pointer to the ring storage        */
+
+  uint16_t                      Mask;             /*!< Ring size minus one                */
+
+  __IO uint16_t                 Head;             /*!< Write index (producer side)        */
+
+  __IO uint16_t                 Tail;             /*!< Read index (consumer side)         */
+}UART_RingBuffTypeDef;
+
 /** 
   * @brief  UART handle Structure definition
   */
@@ -153,6 +171,16 @@ typedef struct
                                                        This parameter can be a value of @ref HAL_UART_StateTypeDef */
 
   __IO uint32_t                 ErrorCode;        /*!< UART Error code                    */
+
+  void                          (*TxByte)(UART_TypeDef *UARTx, uint8_t Data);     /*!< Writes one byte, bound to the frame format by HAL_UART_Init() */
+
+  uint32_t                      (*RxByte)(UART_TypeDef *UARTx, uint8_t *pData);   /*!< Reads one byte, returns a HAL_UART_ERROR_xxx code             */
+
+  UART_RingBuffTypeDef          TxRing;           /*!< UART Tx ring used in stream mode   */
+
+  UART_RingBuffTypeDef          RxRing;           /*!< UART Rx ring used in stream mode   */
+
+  __IO uint8_t                  TxRingActive;     /*!< Set while the Tx ring is draining  */
 }UART_HandleTypeDef;
 
 /**
@@ -171,6 +199,7 @@ typedef struct
 #define HAL_UART_ERROR_CONFIG								0x00000001U   /*!< Configure error     */
 #define HAL_UART_ERROR_PARITY        				0x00000002U   /*!< Parity error        */
 #define HAL_UART_ERROR_FE           				0x00000004U   /*!< Frame error         */
+#define HAL_UART_ERROR_ORE          				0x00000008U   /*!< Rx ring overrun     */
 
 /**
   * @}
@@ -331,7 +360,11 @@ typedef struct
 /* Initialization/de-initialization functions  **********************************/
 HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_MultiProcessor_Init(UART_HandleTypeDef *huart, uint8_t Address, uint8_t BroadcastAddress);
+HAL_StatusTypeDef HAL_UART_MultiProcessor_EnterMuteMode(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_MultiProcessor_ExitMuteMode(UART_HandleTypeDef *huart);
 HAL_StatusTypeDef HAL_UART_DeInit (UART_HandleTypeDef *huart);
+void HAL_UART_BindByteHandlers(UART_HandleTypeDef *huart);
 void HAL_UART_MspInit(UART_HandleTypeDef *huart);
 void HAL_UART_MspDeInit(UART_HandleTypeDef *huart);
 /**
@@ -343,6 +376,7 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef *huart);
   */
 /* IO operation functions *******************************************************/
 HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_MultiProcessor_SendAddress(UART_HandleTypeDef *huart, uint8_t Address, uint32_t Timeout);
 HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
 HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
@@ -366,6 +400,14 @@ extern HAL_StatusTypeDef UART_Single_Receive_IT(UART_HandleTypeDef *huart);
 void Naked_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size,IRQn_Type IRQn);
 void Naked_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
 void Naked_UART_IRQHandler(UART_HandleTypeDef *huart);
+
+/* Stream mode functions */
+HAL_StatusTypeDef HAL_UART_Stream_Start(UART_HandleTypeDef *huart, uint8_t *pTxBuff, uint16_t TxSize, uint8_t *pRxBuff, uint16_t RxSize);
+HAL_StatusTypeDef HAL_UART_Stream_Stop(UART_HandleTypeDef *huart);
+uint16_t HAL_UART_Write(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+uint16_t HAL_UART_Read(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+uint16_t HAL_UART_GetTxFree(UART_HandleTypeDef *huart);
+uint16_t HAL_UART_GetRxCount(UART_HandleTypeDef *huart);
 /**
   * @}
   */
@@ -405,6 +447,8 @@ uint32_t HAL_UART_GetError(UART_HandleTypeDef *huart);
   */
 #define IS_UART_BAUDRATE(BAUDRATE) ((BAUDRATE) < 230400U)
 
+#define IS_UART_RING_SIZE(SIZE)    (((SIZE) >= 2U) && (((SIZE) & ((SIZE) - 1U)) == 0U))
+
 /**
   * @}
   */
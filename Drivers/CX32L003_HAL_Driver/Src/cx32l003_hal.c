@@ -75,11 +75,25 @@
 __IO uint32_t uwTick;
 uint32_t uwTickPrio   = (1UL << __NVIC_PRIO_BITS); /* Invalid PRIO */
 HAL_TickFreqTypeDef uwTickFreq = HAL_TICK_FREQ_DEFAULT;  /* 1KHz */
+/* Core cycles of the SysTick periods counted in uwTick */
+static __IO uint64_t ullTickCycles;
+/* SystemCoreClock the cycles per microsecond were computed for */
+static uint32_t uwTickCoreClock;
+static uint32_t uwTickCyclesPerUs;
 
 /**
   * @}
   */
 /* Private function prototypes -----------------------------------------------*/
+/** @defgroup HAL_Private_Functions HAL Private Functions
+  * @{
+  */
+static uint32_t Tick_GetCycles(uint32_t *pTick, uint64_t *pBase);
+static uint32_t Tick_GetCyclesPerUs(void);
+/**
+  * @}
+  */
+
 /* Exported functions ---------------------------------------------------------*/
 
 /** @defgroup HAL_Exported_Functions HAL Exported Functions
@@ -307,6 +321,8 @@ __weak HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
     [..]  This section provides functions allowing to:
       (+) Provide a tick value in millisecond
       (+) Provide a blocking delay in millisecond
+      (+) Provide a timestamp in microsecond or in core cycles
+      (+) Provide a blocking delay in microsecond
       (+) Suspend the time base source interrupt
       (+) Resume the time base source interrupt
       (+) Get the HAL API driver version
@@ -332,6 +348,7 @@ __weak HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
 __weak void HAL_IncTick(void)
 {
   uwTick += uwTickFreq;
+  ullTickCycles += SysTick->LOAD + 1U;
 }
 
 /**
@@ -442,6 +459,74 @@ __weak void HAL_ResumeTick(void)
   SET_BIT(SysTick->CTRL, SysTick_CTRL_TICKINT_Msk);
 }
 
+/**
+  * @brief Provides a timestamp in microsecond.
+  * @note  uwTick is combined with the SysTick counter, the value is read again
+  *        if a tick interrupt came in between, so no interrupt is masked.
+  *        It wraps around every 2^32 microseconds, compute differences only.
+  *        Call it from thread mode or from priorities at or below the SysTick
+  *        one, above it the value can go back by one tick period.
+  * @note  This function is declared as __weak to be overwritten in case of other
+  *       implementations in user file.
+  * @retval timestamp in microsecond
+  */
+__weak uint32_t HAL_GetMicros(void)
+{
+  uint32_t tick;
+  uint64_t base;
+  uint32_t cycles = Tick_GetCycles(&tick, &base);
+
+  return (tick * 1000U) + (cycles / Tick_GetCyclesPerUs());
+}
+
+/**
+  * @brief Provides a timestamp in core cycles.
+  * @note  Read the same way as HAL_GetMicros(), with the same priority
+  *        restriction. It does not wrap around in practice and keeps counting
+  *        across HAL_SetTickFreq() changes.
+  * @note  This function is declared as __weak to be overwritten in case of other
+  *       implementations in user file.
+  * @retval timestamp in core cycles
+  */
+__weak uint64_t HAL_GetCycles64(void)
+{
+  uint32_t tick;
+  uint64_t base;
+  uint32_t cycles = Tick_GetCycles(&tick, &base);
+
+  return base + cycles;
+}
+
+/**
+  * @brief This function provides minimum delay (in microseconds) measured on
+  *        the SysTick counter.
+  * @note  The core cycles are counted, so the delay does not depend on the
+  *        flash wait states or on the compiler as a NOP loop would. It works
+  *        with interrupts masked and from interrupt handlers. An interrupt
+  *        preempting the delay for longer than a tick period only makes it longer.
+  * @note  This function is declared as __weak to be overwritten in case of other
+  *       implementations in user file.
+  * @param Delay specifies the delay time length, in microseconds, below
+  *        0xFFFFFFFF / (SystemCoreClock / 1000000).
+  * @retval None
+  */
+__weak void HAL_DelayUs(uint32_t Delay)
+{
+  uint32_t load = SysTick->LOAD;
+  uint32_t last = SysTick->VAL;
+  uint32_t cycles = Delay * Tick_GetCyclesPerUs();
+  uint32_t elapsed = 0;
+  uint32_t now;
+
+  while (elapsed < cycles)
+  {
+    now = SysTick->VAL;
+    /* The counter counts down and is reloaded with LOAD after 0 */
+    elapsed += (last >= now) ? (last - now) : (last + load + 1U - now);
+    last = now;
+  }
+}
+
 /**
   * @brief  Returns the HAL revision
   * @retval version 0xXYZR (8bits for each decimal, R for RC)
@@ -518,6 +603,71 @@ void HAL_GetUID(uint32_t *UID)
   * @}
   */ /* End of group HAL_Exported_Functions */
 
+/** @addtogroup HAL_Private_Functions
+  * @{
+  */
+
+/**
+  * @brief Reads uwTick and the SysTick counter consistently.
+  * @note  The pair is read again if the tick interrupt ran in between. A tick
+  *        interrupt pending but not served yet (the caller masks interrupts)
+  *        is accounted for here. A caller of higher priority than SysTick may
+  *        preempt the tick handler after the pending bit is cleared but before
+  *        HAL_IncTick() counts the period: it would then read one period less,
+  *        so the callers must not run above the SysTick priority.
+  * @param pTick uwTick value the cycles count from
+  * @param pBase core cycles up to pTick
+  * @retval core cycles since pTick, at most two tick periods
+  */
+static uint32_t Tick_GetCycles(uint32_t *pTick, uint64_t *pBase)
+{
+  uint32_t tick;
+  uint32_t load;
+  uint32_t val;
+  uint32_t cycles;
+
+  do
+  {
+    tick = uwTick;
+    *pBase = ullTickCycles;
+    load = SysTick->LOAD;
+    val = SysTick->VAL;
+    cycles = load - val;
+    /* The counter reached 0, once reloaded the period is over */
+    if (((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0U) && ((val = SysTick->VAL) != 0U))
+    {
+      cycles = (load + 1U) + (load - val);
+    }
+  } while (tick != uwTick);
+
+  *pTick = tick;
+  return cycles;
+}
+
+/**
+  * @brief Returns the core cycles per microsecond.
+  * @note  Computed again only when SystemCoreClock changes, to keep the
+  *        division out of HAL_DelayUs().
+  * @retval cycles per microsecond, at least 1
+  */
+static uint32_t Tick_GetCyclesPerUs(void)
+{
+  if (uwTickCoreClock != SystemCoreClock)
+  {
+    uwTickCoreClock = SystemCoreClock;
+    uwTickCyclesPerUs = SystemCoreClock / 1000000U;
+    if (uwTickCyclesPerUs == 0U)
+    {
+      uwTickCyclesPerUs = 1U;
+    }
+  }
+  return uwTickCyclesPerUs;
+}
+
+/**
+  * @}
+  */ /* End of group HAL_Private_Functions */
+
 #endif /* HAL_MODULE_ENABLED */
 /**
   * @}
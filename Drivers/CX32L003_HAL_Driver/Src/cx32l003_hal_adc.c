@@ -102,6 +102,43 @@
           (+++) Stop conversion and disable the ADC peripheral 
                 using function HAL_ADC_Stop_IT()
 
+        (++) ADC continuous conversion into sample FIFOs:
+          (+++) Give each scanned channel a FIFO using function
+                HAL_ADC_ConfigFifo() after HAL_ADC_Init(), the size must be
+                a power of two, HAL_ADC_DeInit() removes the FIFOs
+          (+++) Activate the ADC peripheral and start conversions
+                using function HAL_ADC_Start_IT()
+          (+++) HAL_ADC_IRQHandler() then reads the flags once and pushes
+                the result of each completed channel into its FIFO, channels
+                without FIFO still call HAL_ADC_MultiChannelx_ConvCpltCallback()
+          (+++) Retrieve blocks of samples using function HAL_ADC_ReadSamples(),
+                HAL_ADC_ERROR_OVR is set when a full FIFO dropped a sample
+
+        (++) ADC oversampling and decimation:
+          (+++) Initialize the ADC in continuous mode on a single channel
+          (+++) Fill the Init field of an ADC_OversamplingTypeDef and start
+                using function HAL_ADC_Oversampling_Start_IT(): the hardware
+                accumulates Ratio conversions in RESULT_ACC, so one interrupt
+                is taken per Ratio conversions only
+          (+++) Each accumulated value is shifted, averaged and CIC decimated
+                inline in HAL_ADC_IRQHandler(), results are delivered by blocks
+                to HAL_ADC_OversamplingBlockCallback()
+          (+++) Stop using function HAL_ADC_Oversampling_Stop_IT()
+
+        (++) ADC analog watchdog:
+          (+++) Initialize the ADC in continuous mode on a single channel
+          (+++) Fill the Init field of an ADC_WatchdogTypeDef and start using
+                function HAL_ADC_Watchdog_Start_IT(): the ADC converts in circle
+                mode and only the hardware threshold compare raises interrupts
+          (+++) Each crossing swaps the armed threshold, so the level has to come
+                back by Hysteresis before ADC_WATCHDOG_EVENT_NORMAL is reported
+          (+++) Crossings are reported to HAL_ADC_WatchdogCallback(), or
+                HAL_ADC_Watchdog_WaitEvent() sleeps until the next one. Suspend
+                the tick with HAL_SuspendTick() so that only crossings wake the
+                CPU, HAL_ADC_WatchdogGetTimestamp() can then be implemented on
+                LPTIM
+          (+++) Stop using function HAL_ADC_Watchdog_Stop_IT()
+
      [..]
 
     (@) Callback functions must be implemented in user program:
@@ -177,10 +214,30 @@
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+/* Continuous mode end of channel conversion callbacks, indexed by channel */
+static void (* const ADC_MultiChannelCallback[8])(ADC_HandleTypeDef* hadc) =
+{
+  HAL_ADC_MultiChannel0_ConvCpltCallback,
+  HAL_ADC_MultiChannel1_ConvCpltCallback,
+  HAL_ADC_MultiChannel2_ConvCpltCallback,
+  HAL_ADC_MultiChannel3_ConvCpltCallback,
+  HAL_ADC_MultiChannel4_ConvCpltCallback,
+  HAL_ADC_MultiChannel5_ConvCpltCallback,
+  HAL_ADC_MultiChannel6_ConvCpltCallback,
+  HAL_ADC_MultiChannel7_ConvCpltCallback
+};
+
 /* Private function prototypes -----------------------------------------------*/
 /** @defgroup ADC_Private_Functions ADC Private Functions
   * @{
   */
+static void ADC_Fifo_Reset(ADC_HandleTypeDef* hadc);
+static void ADC_Fifo_IT(ADC_HandleTypeDef* hadc);
+static void ADC_Oversampling_IT(ADC_HandleTypeDef* hadc);
+static HAL_StatusTypeDef ADC_Oversampling_CheckRange(const ADC_OversamplingInitTypeDef* Init);
+static void ADC_Watchdog_IT(ADC_HandleTypeDef* hadc);
+static void ADC_Watchdog_Arm(ADC_HandleTypeDef* hadc, uint8_t Zone);
+static uint32_t ADC_ChannelIndex(uint32_t Channel);
 /**
   * @}
   */
@@ -256,6 +313,10 @@ HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc)
     /* Allocate lock resource and initialize it */
     hadc->Lock = HAL_UNLOCKED;
     
+    hadc->pOversampling = NULL;
+    hadc->pWatchdog = NULL;
+    ADC_Fifo_Reset(hadc);
+    
     /* Init the low level hardware */
     HAL_ADC_MspInit(hadc);
   }
@@ -405,6 +466,10 @@ HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef* hadc)
     /* DeInit the low level hardware: GPIO, NVIC */
     HAL_ADC_MspDeInit(hadc);
     
+    hadc->pOversampling = NULL;
+    hadc->pWatchdog = NULL;
+    ADC_Fifo_Reset(hadc);
+    
     /* Set ADC error code to none */
     ADC_CLEAR_ERRORCODE(hadc);
     
@@ -466,6 +531,9 @@ __weak void HAL_ADC_MspDeInit(ADC_HandleTypeDef* hadc)
       (+) Start conversion and enable interruptions.
       (+) Stop conversion and disable interruptions.
       (+) Handle ADC interrupt request
+      (+) Collect continuous conversion results into per channel FIFOs.
+      (+) Oversample and decimate continuous conversion results.
+      (+) Monitor a channel against thresholds while the CPU sleeps.
 @endverbatim
   * @{
   */
@@ -945,6 +1013,386 @@ uint32_t HAL_ADC_GetAccValue(ADC_HandleTypeDef* hadc)
 
 
 
+/**
+  * @brief  Gives a channel a sample FIFO for continuous mode conversions.
+  * @note   While at least one FIFO is configured, HAL_ADC_IRQHandler() stores
+  *         the results itself instead of calling the channel callback.
+  *         Must be called after HAL_ADC_Init(), which removes the FIFOs when
+  *         coming from the reset state, and while no conversion is ongoing.
+  * @param  hadc: ADC handle
+  * @param  Channel: one of @ref ADC_ContinueChannelSel
+  * @param  pBuffer: sample storage, NULL to remove the FIFO of the channel
+  * @param  Size: number of samples of pBuffer, a power of two
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ADC_ConfigFifo(ADC_HandleTypeDef* hadc, uint32_t Channel, uint16_t *pBuffer, uint16_t Size)
+{
+  ADC_FifoTypeDef *fifo;
+
+  /* Check the parameters */
+  assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
+  assert_param(IS_ADC_CONTINUE_CHANNEL(Channel));
+
+  if((pBuffer != NULL) && !IS_ADC_FIFO_SIZE(Size))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(hadc);
+
+  if(HAL_IS_BIT_SET(hadc->State, HAL_ADC_STATE_BUSY))
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hadc);
+    return HAL_BUSY;
+  }
+
+  fifo = &hadc->Fifo[ADC_ChannelIndex(Channel)];
+  fifo->Head = 0U;
+  fifo->Tail = 0U;
+  if(pBuffer != NULL)
+  {
+    fifo->pBuffer = pBuffer;
+    fifo->Mask = Size - 1U;
+    SET_BIT(hadc->FifoMask, Channel);
+  }
+  else
+  {
+    CLEAR_BIT(hadc->FifoMask, Channel);
+    fifo->pBuffer = NULL;
+    fifo->Mask = 0U;
+  }
+
+  /* Process unlocked */
+  __HAL_UNLOCK(hadc);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Copies the oldest samples of a channel FIFO.
+  * @param  hadc: ADC handle
+  * @param  Channel: one of @ref ADC_ContinueChannelSel
+  * @param  pData: destination
+  * @param  Size: maximum number of samples to copy
+  * @retval Number of samples copied
+  */
+uint16_t HAL_ADC_ReadSamples(ADC_HandleTypeDef* hadc, uint32_t Channel, uint16_t *pData, uint16_t Size)
+{
+  ADC_FifoTypeDef *fifo = &hadc->Fifo[ADC_ChannelIndex(Channel)];
+  uint16_t tail = fifo->Tail;
+  uint16_t count = (uint16_t)(fifo->Head - tail);
+  uint16_t i;
+
+  if(count > Size)
+  {
+    count = Size;
+  }
+  for(i = 0U; i < count; i++)
+  {
+    pData[i] = fifo->pBuffer[(uint16_t)(tail + i) & fifo->Mask];
+  }
+
+  /* Release the slots only once they are copied */
+  fifo->Tail = tail + count;
+
+  return count;
+}
+
+/**
+  * @brief  Number of samples waiting in a channel FIFO.
+  * @param  hadc: ADC handle
+  * @param  Channel: one of @ref ADC_ContinueChannelSel
+  * @retval Number of samples
+  */
+uint16_t HAL_ADC_GetSampleCount(ADC_HandleTypeDef* hadc, uint32_t Channel)
+{
+  ADC_FifoTypeDef *fifo = &hadc->Fifo[ADC_ChannelIndex(Channel)];
+
+  return (uint16_t)(fifo->Head - fifo->Tail);
+}
+
+/**
+  * @brief  Starts continuous conversions oversampled by the result accumulator.
+  * @note   The channel selected by hadc->Init.ContinueChannelSel is converted
+  *         hovs->Init.Ratio times per sample, the ADC is restarted from the
+  *         end of continuous conversion interrupt. hovs must stay valid until
+  *         HAL_ADC_Oversampling_Stop_IT(). Configurations whose moving average
+  *         input or results do not fit in 16 bits, or whose CIC overflows
+  *         32 bits, are rejected.
+  * @param  hadc: ADC handle, initialized in continuous mode on a single channel
+  * @param  hovs: oversampling context with its Init field filled
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ADC_Oversampling_Start_IT(ADC_HandleTypeDef* hadc, ADC_OversamplingTypeDef* hovs)
+{
+  HAL_StatusTypeDef tmp_hal_status = HAL_OK;
+  uint32_t i;
+
+  /* Check the parameters */
+  assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
+  assert_param(IS_ADC_CONTINUE_CHANNEL(hadc->Init.ContinueChannelSel));
+
+  if((hovs == NULL) || (hovs->Init.pBlock == NULL) || (hovs->Init.BlockLength == 0U) ||
+     !IS_ADC_OVERSAMPLING_RATIO(hovs->Init.Ratio) ||
+     !IS_ADC_OVERSAMPLING_SHIFT(hovs->Init.RightShift) ||
+     !IS_ADC_OVERSAMPLING_AVERAGE(hovs->Init.AverageLength) ||
+     !IS_ADC_OVERSAMPLING_CIC(hovs->Init.CicOrder, hovs->Init.CicDecimation, hovs->Init.CicShift) ||
+     (hadc->Init.SingleContinueMode != ADC_MODE_CONTINUE) ||
+     (ADC_Oversampling_CheckRange(&hovs->Init) != HAL_OK))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(hadc);
+
+  /* Reset the filter chain */
+  hovs->AverageSum = 0U;
+  hovs->AverageIndex = 0U;
+  hovs->AverageShift = 0U;
+  while((1UL << hovs->AverageShift) < hovs->Init.AverageLength)
+  {
+    hovs->AverageShift++;
+  }
+  for(i = 0U; i < 16U; i++)
+  {
+    hovs->AverageHistory[i] = 0U;
+  }
+  for(i = 0U; i < 3U; i++)
+  {
+    hovs->Integrator[i] = 0U;
+    hovs->Comb[i] = 0U;
+  }
+  hovs->CicCount = 0U;
+  hovs->BlockIndex = 0U;
+
+  /* Ratio conversions per sequence, accumulated in RESULT_ACC */
+  hovs->SavedCR2 = READ_BIT(hadc->Instance->CR2, ADC_CR2_CIRCLE_MODE | ADC_CR2_ADCCNT);
+  MODIFY_REG(hadc->Instance->CR2, ADC_CR2_CIRCLE_MODE | ADC_CR2_ADCCNT, (hovs->Init.Ratio - 1U) << 8);
+  SET_BIT(hadc->Instance->CR1, ADC_CR1_RACC_EN | ADC_CR1_RACC_CLR);
+  CLEAR_BIT(hadc->Instance->CR1, ADC_CR1_RACC_CLR);
+
+  /* Enable the ADC peripheral */
+  tmp_hal_status = ADC_Enable(hadc);
+
+  if (tmp_hal_status == HAL_OK)
+  {
+    ADC_STATE_CLR_SET(hadc->State,
+                      HAL_ADC_STATE_READY | HAL_ADC_STATE_EOC,
+                      HAL_ADC_STATE_BUSY);
+
+    /* Reset ADC all error code fields */
+    ADC_CLEAR_ERRORCODE(hadc);
+
+    hadc->pOversampling = hovs;
+
+    /* Process unlocked */
+    __HAL_UNLOCK(hadc);
+
+    /* Only the end of sequence interrupts, never one per conversion */
+    __HAL_ADC_CLEAR_FLAG(hadc, ADC_INTFLAG_CHANNEL_ALL | ADC_INTFLAG_CONTINUE);
+    __HAL_ADC_DISABLE_IT(hadc, ADC_IT_CHANNEL0 | ADC_IT_CHANNEL1 | ADC_IT_CHANNEL2 | ADC_IT_CHANNEL3 |
+                               ADC_IT_CHANNEL4 | ADC_IT_CHANNEL5 | ADC_IT_CHANNEL6 | ADC_IT_CHANNEL7);
+    __HAL_ADC_ENABLE_IT(hadc, ADC_IT_CONTINUE);
+
+    if (ADC_IS_SOFTWARE_START(hadc))
+    {
+      /* Start ADC conversion with SW start */
+      SET_BIT(hadc->Instance->CR0, (ADC_CR0_START));
+    }
+  }
+  else
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hadc);
+  }
+
+  /* Return function status */
+  return tmp_hal_status;
+}
+
+/**
+  * @brief  Stops oversampled conversions, disables the ADC.
+  * @note   Results of an incomplete block are discarded.
+  * @param  hadc: ADC handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ADC_Oversampling_Stop_IT(ADC_HandleTypeDef* hadc)
+{
+  HAL_StatusTypeDef tmp_hal_status = HAL_OK;
+
+  /* Check the parameters */
+  assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
+
+  /* Process locked */
+  __HAL_LOCK(hadc);
+
+  tmp_hal_status = ADC_ConversionStatus_Reset(hadc);
+  __HAL_ADC_DISABLE_IT(hadc, ADC_IT_CONTINUE);
+  __HAL_ADC_CLEAR_FLAG(hadc, ADC_INTFLAG_CHANNEL_ALL | ADC_INTFLAG_CONTINUE);
+
+  /* Restore the sequence and accumulator settings of HAL_ADC_Init() */
+  if(hadc->pOversampling != NULL)
+  {
+    MODIFY_REG(hadc->Instance->CR2, ADC_CR2_CIRCLE_MODE | ADC_CR2_ADCCNT, hadc->pOversampling->SavedCR2);
+  }
+  MODIFY_REG(hadc->Instance->CR1, ADC_CR1_RACC_EN, hadc->Init.AutoAccumulation);
+  hadc->pOversampling = NULL;
+
+  if (tmp_hal_status == HAL_OK)
+  {
+    ADC_STATE_CLR_SET(hadc->State, HAL_ADC_STATE_BUSY, HAL_ADC_STATE_READY);
+  }
+
+  /* Process unlocked */
+  __HAL_UNLOCK(hadc);
+
+  return tmp_hal_status;
+}
+
+/**
+  * @brief  Starts the analog watchdog: continuous conversions, threshold interrupts only.
+  * @note   The channel selected by hadc->Init.ContinueChannelSel is converted in
+  *         circle mode. hwdg must stay valid until HAL_ADC_Watchdog_Stop_IT().
+  *         A level already outside the thresholds is reported at the first
+  *         conversion.
+  * @param  hadc: ADC handle, initialized in continuous mode on a single channel
+  * @param  hwdg: watchdog context with its Init field filled
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ADC_Watchdog_Start_IT(ADC_HandleTypeDef* hadc, ADC_WatchdogTypeDef* hwdg)
+{
+  HAL_StatusTypeDef tmp_hal_status = HAL_OK;
+
+  /* Check the parameters */
+  assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
+  assert_param(IS_ADC_CONTINUE_CHANNEL(hadc->Init.ContinueChannelSel));
+
+  if((hwdg == NULL) || (hwdg->Init.HighThreshold > ADC_HT_HT_Msk) ||
+     (hwdg->Init.LowThreshold > hwdg->Init.HighThreshold) ||
+     (hwdg->Init.Hysteresis > (hwdg->Init.HighThreshold - hwdg->Init.LowThreshold)) ||
+     (hadc->Init.SingleContinueMode != ADC_MODE_CONTINUE))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process locked */
+  __HAL_LOCK(hadc);
+
+  hwdg->EventPending = 0U;
+
+  /* Convert the channel forever */
+  MODIFY_REG(hadc->Instance->CR2, ADC_CR2_CIRCLE_MODE | ADC_CR2_ADCCNT, ADC_CR2_CIRCLE_MODE);
+
+  /* Enable the ADC peripheral */
+  tmp_hal_status = ADC_Enable(hadc);
+
+  if (tmp_hal_status == HAL_OK)
+  {
+    ADC_STATE_CLR_SET(hadc->State,
+                      HAL_ADC_STATE_READY | HAL_ADC_STATE_EOC | HAL_ADC_STATE_OUTRANGE,
+                      HAL_ADC_STATE_BUSY);
+
+    /* Reset ADC all error code fields */
+    ADC_CLEAR_ERRORCODE(hadc);
+
+    /* No end of conversion interrupt, the threshold compare does the work */
+    __HAL_ADC_DISABLE_IT(hadc, ADC_INTEN_CONT_ALL);
+    __HAL_ADC_CLEAR_FLAG(hadc, ADC_INTFLAG_ALL);
+    hadc->pWatchdog = hwdg;
+    hwdg->Zone = ADC_WATCHDOG_EVENT_NORMAL;
+    ADC_Watchdog_Arm(hadc, ADC_WATCHDOG_EVENT_NORMAL);
+
+    /* Process unlocked */
+    __HAL_UNLOCK(hadc);
+
+    if (ADC_IS_SOFTWARE_START(hadc))
+    {
+      /* Start ADC conversion with SW start */
+      SET_BIT(hadc->Instance->CR0, (ADC_CR0_START));
+    }
+  }
+  else
+  {
+    /* Process unlocked */
+    __HAL_UNLOCK(hadc);
+  }
+
+  /* Return function status */
+  return tmp_hal_status;
+}
+
+/**
+  * @brief  Stops the analog watchdog, disables the ADC.
+  * @param  hadc: ADC handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_ADC_Watchdog_Stop_IT(ADC_HandleTypeDef* hadc)
+{
+  HAL_StatusTypeDef tmp_hal_status = HAL_OK;
+
+  /* Check the parameters */
+  assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
+
+  /* Process locked */
+  __HAL_LOCK(hadc);
+
+  tmp_hal_status = ADC_ConversionStatus_Reset(hadc);
+  __HAL_ADC_DISABLE_IT(hadc, ADC_INTEN_CONT_ALL);
+  CLEAR_BIT(hadc->Instance->CR1, ADC_CR1_LTCMP | ADC_CR1_HTCMP | ADC_CR1_REGCMP);
+  __HAL_ADC_CLEAR_FLAG(hadc, ADC_INTFLAG_ALL);
+  hadc->pWatchdog = NULL;
+
+  if (tmp_hal_status == HAL_OK)
+  {
+    ADC_STATE_CLR_SET(hadc->State, HAL_ADC_STATE_BUSY, HAL_ADC_STATE_READY);
+  }
+
+  /* Process unlocked */
+  __HAL_UNLOCK(hadc);
+
+  return tmp_hal_status;
+}
+
+/**
+  * @brief  Sleeps until the analog watchdog reports a crossing.
+  * @note   Interrupts are masked between the check and WFI so a crossing
+  *         cannot be missed, any other interrupt only costs one loop.
+  * @param  hadc: ADC handle
+  * @param  pEvent: returns the crossing
+  * @retval HAL_ERROR if the watchdog is not running
+  */
+HAL_StatusTypeDef HAL_ADC_Watchdog_WaitEvent(ADC_HandleTypeDef* hadc, ADC_WatchdogEventTypeDef* pEvent)
+{
+  ADC_WatchdogTypeDef *hwdg = hadc->pWatchdog;
+
+  if(hwdg == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  for(;;)
+  {
+    __disable_irq();
+    if(hwdg->EventPending != 0U)
+    {
+      *pEvent = hwdg->Event;
+      hwdg->EventPending = 0U;
+      __enable_irq();
+      return HAL_OK;
+    }
+    /* A pending interrupt still ends WFI while masked */
+#ifdef HAL_PWR_MODULE_ENABLED
+    HAL_PWR_EnterSLEEPMode(PWR_SLEEPENTRY_WFI);
+#else
+    __WFI();
+#endif
+    __enable_irq();
+  }
+}
+
 /**
   * @brief  Handles ADC interrupt request  
   * @param  hadc: ADC handle
@@ -954,6 +1402,27 @@ void HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc)
 {
   /* Check the parameters */
   assert_param(IS_ADC_ALL_INSTANCE(hadc->Instance));
+
+	/* Analog watchdog */
+	if(hadc->pWatchdog != NULL)
+	{
+		ADC_Watchdog_IT(hadc);
+		return;
+	}
+
+	/* Oversampling on the result accumulator */
+	if(hadc->pOversampling != NULL)
+	{
+		ADC_Oversampling_IT(hadc);
+		return;
+	}
+
+	/* Continuous conversion into FIFOs */
+	if((hadc->FifoMask != 0U) && (hadc->Init.SingleContinueMode == ADC_MODE_CONTINUE))
+	{
+		ADC_Fifo_IT(hadc);
+		return;
+	}
   
   /* ========== Check End of Conversion flag ========== */
 	/* Update state machine on conversion status if not in error state */
@@ -1200,6 +1669,57 @@ void HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc)
 }
 
 
+/**
+  * @brief  Analog watchdog crossing callback in non blocking mode
+  * @param  hadc: ADC handle
+  * @param  pEvent: the crossing
+  * @retval None
+  */
+__weak void HAL_ADC_WatchdogCallback(ADC_HandleTypeDef* hadc, ADC_WatchdogEventTypeDef* pEvent)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hadc);
+  UNUSED(pEvent);
+  /* NOTE : This function should not be modified. When the callback is needed,
+            function HAL_ADC_WatchdogCallback must be implemented in the user file.
+   */
+}
+
+/**
+  * @brief  Time source of the analog watchdog events
+  * @note   Returns HAL_GetTick() by default. When the tick is suspended during
+  *         sleep, implement it in the user file on a running LPTIM, e.g. with
+  *         __HAL_LPTIM_GET_COUNTER().
+  * @param  hadc: ADC handle
+  * @retval Timestamp
+  */
+__weak uint32_t HAL_ADC_WatchdogGetTimestamp(ADC_HandleTypeDef* hadc)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hadc);
+  return HAL_GetTick();
+}
+
+/**
+  * @brief  Oversampling block complete callback in non blocking mode
+  * @note   The other half of the buffer is being filled meanwhile, the block
+  *         must be consumed before BlockLength more results are produced.
+  * @param  hadc: ADC handle
+  * @param  pBlock: first result of the completed block
+  * @param  Length: number of results in the block
+  * @retval None
+  */
+__weak void HAL_ADC_OversamplingBlockCallback(ADC_HandleTypeDef* hadc, uint16_t *pBlock, uint16_t Length)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hadc);
+  UNUSED(pBlock);
+  UNUSED(Length);
+  /* NOTE : This function should not be modified. When the callback is needed,
+            function HAL_ADC_OversamplingBlockCallback must be implemented in the user file.
+   */
+}
+
 /**
   * @brief  Continuous mode channel0 conversion complete callback in non blocking mode 
   * @param  hadc: ADC handle
@@ -1591,6 +2111,323 @@ uint32_t HAL_ADC_GetDiv(ADC_HandleTypeDef *hadc)
   * @{
   */
 
+/**
+  * @brief  Removes the sample FIFO of every channel.
+  * @param  hadc: ADC handle
+  * @retval None
+  */
+static void ADC_Fifo_Reset(ADC_HandleTypeDef* hadc)
+{
+  uint32_t i;
+
+  hadc->FifoMask = 0U;
+  for(i = 0U; i < 8U; i++)
+  {
+    hadc->Fifo[i].pBuffer = NULL;
+    hadc->Fifo[i].Mask = 0U;
+    hadc->Fifo[i].Head = 0U;
+    hadc->Fifo[i].Tail = 0U;
+  }
+}
+
+/**
+  * @brief  ADC interrupt service when channel FIFOs are configured.
+  * @note   MSKINTSR is read once: it already holds enabled sources only. Each
+  *         completed channel result is pushed into its FIFO, a channel without
+  *         FIFO gets its callback from ADC_MultiChannelCallback[].
+  * @param  hadc: ADC handle
+  * @retval None
+  */
+static void ADC_Fifo_IT(ADC_HandleTypeDef* hadc)
+{
+  uint32_t flags = hadc->Instance->MSKINTSR;
+  uint32_t pending = flags & ADC_INTFLAG_CHANNEL_ALL;
+  __IO uint32_t *result = &hadc->Instance->RESULT0;
+  ADC_FifoTypeDef *fifo = hadc->Fifo;
+  uint32_t channel = 0U;
+  uint16_t head;
+
+  /* Clear every flag being serviced with a single write */
+  WRITE_REG(hadc->Instance->INTCLR, flags);
+
+  while(pending != 0U)
+  {
+    if((pending & 0x1U) != 0U)
+    {
+      if(fifo->pBuffer != NULL)
+      {
+        head = fifo->Head;
+        if((uint16_t)(head - fifo->Tail) <= fifo->Mask)
+        {
+          fifo->pBuffer[head & fifo->Mask] = (uint16_t)*result;
+          fifo->Head = head + 1U;
+        }
+        else
+        {
+          SET_BIT(hadc->ErrorCode, HAL_ADC_ERROR_OVR);
+        }
+      }
+      else
+      {
+        ADC_MultiChannelCallback[channel](hadc);
+      }
+    }
+    pending >>= 1;
+    result++;
+    fifo++;
+    channel++;
+  }
+
+  if((flags & ADC_INTFLAG_CONTINUE) != 0U)
+  {
+    /* Disable ADC end of conversion interrupt */
+    __HAL_ADC_DISABLE_IT(hadc, ADC_IT_CONTINUE);
+
+    /* Set ADC state */
+    ADC_STATE_CLR_SET(hadc->State, HAL_ADC_STATE_BUSY, HAL_ADC_STATE_READY | HAL_ADC_STATE_EOC);
+
+    /* Conversion complete callback */
+    HAL_ADC_ConvCpltCallback(hadc);
+  }
+
+  if((flags & (ADC_INTFLAG_RANGE_THRESHOLD | ADC_INTFLAG_HIGH_THRESHOLD | ADC_INTFLAG_LOW_THERSHOLD)) != 0U)
+  {
+    /* Set ADC state */
+    SET_BIT(hadc->State, HAL_ADC_STATE_OUTRANGE);
+
+    /* Level out of window callback */
+    HAL_ADC_LevelOutOfRangeCallback(hadc);
+  }
+}
+
+/**
+  * @brief  Checks that the filter chain of an oversampling configuration can
+  *         not overflow.
+  * @note   Exact without the CIC, an upper bound with it.
+  * @param  Init: oversampling parameters, already range checked
+  * @retval HAL_OK if every stage fits
+  */
+static HAL_StatusTypeDef ADC_Oversampling_CheckRange(const ADC_OversamplingInitTypeDef* Init)
+{
+  uint32_t max = (0xFFFU * Init->Ratio) >> Init->RightShift;
+  uint32_t bits = 0U;
+  uint32_t log2 = 0U;
+
+  while((max >> bits) != 0U)
+  {
+    bits++;
+  }
+  /* The moving average history holds 16 bit samples */
+  if((Init->AverageLength > 1U) && (bits > 16U))
+  {
+    return HAL_ERROR;
+  }
+  if(Init->CicOrder != 0U)
+  {
+    while((1UL << log2) < Init->CicDecimation)
+    {
+      log2++;
+    }
+    /* Integrators and combs are 32 bit, the width before CicShift must fit */
+    bits += Init->CicOrder * log2;
+    if(bits > 32U)
+    {
+      return HAL_ERROR;
+    }
+    bits = (bits > Init->CicShift) ? (bits - Init->CicShift) : 0U;
+  }
+  /* Results are stored on 16 bits */
+  return (bits > 16U) ? HAL_ERROR : HAL_OK;
+}
+
+/**
+  * @brief  ADC interrupt service while oversampling.
+  * @note   Runs once per Ratio conversions. The next sequence is started first,
+  *         then the sample goes through the filter chain without any call, only
+  *         a completed block calls HAL_ADC_OversamplingBlockCallback().
+  * @param  hadc: ADC handle
+  * @retval None
+  */
+static void ADC_Oversampling_IT(ADC_HandleTypeDef* hadc)
+{
+  ADC_OversamplingTypeDef *hovs = hadc->pOversampling;
+  uint32_t flags = hadc->Instance->MSKINTSR;
+  uint32_t sample;
+  uint32_t delayed;
+  uint32_t stage;
+
+  WRITE_REG(hadc->Instance->INTCLR, flags);
+
+  if((flags & ADC_INTFLAG_CONTINUE) != 0U)
+  {
+    sample = hadc->Instance->RESULT_ACC >> hovs->Init.RightShift;
+
+    /* Clear the accumulator and start the next sequence right away */
+    SET_BIT(hadc->Instance->CR1, ADC_CR1_RACC_CLR);
+    CLEAR_BIT(hadc->Instance->CR1, ADC_CR1_RACC_CLR);
+    if (ADC_IS_SOFTWARE_START(hadc))
+    {
+      SET_BIT(hadc->Instance->CR0, (ADC_CR0_START));
+    }
+
+    /* Moving average */
+    if(hovs->AverageShift != 0U)
+    {
+      hovs->AverageSum += sample - hovs->AverageHistory[hovs->AverageIndex];
+      hovs->AverageHistory[hovs->AverageIndex] = (uint16_t)sample;
+      hovs->AverageIndex = (hovs->AverageIndex + 1U) & (hovs->Init.AverageLength - 1U);
+      sample = hovs->AverageSum >> hovs->AverageShift;
+    }
+
+    /* CIC decimator: integrators at the input rate, combs at the output rate */
+    if(hovs->Init.CicOrder != 0U)
+    {
+      for(stage = 0U; stage < hovs->Init.CicOrder; stage++)
+      {
+        hovs->Integrator[stage] += sample;
+        sample = hovs->Integrator[stage];
+      }
+      if(++hovs->CicCount < hovs->Init.CicDecimation)
+      {
+        return;
+      }
+      hovs->CicCount = 0U;
+      for(stage = 0U; stage < hovs->Init.CicOrder; stage++)
+      {
+        delayed = hovs->Comb[stage];
+        hovs->Comb[stage] = sample;
+        sample -= delayed;
+      }
+      sample >>= hovs->Init.CicShift;
+    }
+
+    hovs->Init.pBlock[hovs->BlockIndex] = (uint16_t)sample;
+    if(++hovs->BlockIndex == hovs->Init.BlockLength)
+    {
+      HAL_ADC_OversamplingBlockCallback(hadc, hovs->Init.pBlock, hovs->Init.BlockLength);
+    }
+    else if(hovs->BlockIndex == (2U * hovs->Init.BlockLength))
+    {
+      hovs->BlockIndex = 0U;
+      HAL_ADC_OversamplingBlockCallback(hadc, &hovs->Init.pBlock[hovs->Init.BlockLength], hovs->Init.BlockLength);
+    }
+  }
+
+  if((flags & (ADC_INTFLAG_RANGE_THRESHOLD | ADC_INTFLAG_HIGH_THRESHOLD | ADC_INTFLAG_LOW_THERSHOLD)) != 0U)
+  {
+    /* Set ADC state */
+    SET_BIT(hadc->State, HAL_ADC_STATE_OUTRANGE);
+
+    /* Level out of window callback */
+    HAL_ADC_LevelOutOfRangeCallback(hadc);
+  }
+}
+
+/**
+  * @brief  ADC interrupt service of the analog watchdog.
+  * @param  hadc: ADC handle
+  * @retval None
+  */
+static void ADC_Watchdog_IT(ADC_HandleTypeDef* hadc)
+{
+  ADC_WatchdogTypeDef *hwdg = hadc->pWatchdog;
+  uint32_t flags = hadc->Instance->MSKINTSR;
+  uint8_t zone = hwdg->Zone;
+
+  WRITE_REG(hadc->Instance->INTCLR, flags);
+
+  if((flags & ADC_INTFLAG_HIGH_THRESHOLD) != 0U)
+  {
+    /* Above HighThreshold, or back above LowThreshold + Hysteresis */
+    zone = (zone == ADC_WATCHDOG_EVENT_LOW) ? ADC_WATCHDOG_EVENT_NORMAL : ADC_WATCHDOG_EVENT_HIGH;
+  }
+  else if((flags & ADC_INTFLAG_LOW_THERSHOLD) != 0U)
+  {
+    /* Below LowThreshold, or back below HighThreshold - Hysteresis */
+    zone = (zone == ADC_WATCHDOG_EVENT_HIGH) ? ADC_WATCHDOG_EVENT_NORMAL : ADC_WATCHDOG_EVENT_LOW;
+  }
+  else
+  {
+    return;
+  }
+
+  if(zone == hwdg->Zone)
+  {
+    return;
+  }
+  ADC_Watchdog_Arm(hadc, zone);
+  hwdg->Zone = zone;
+
+  hwdg->Event.Timestamp = HAL_ADC_WatchdogGetTimestamp(hadc);
+  hwdg->Event.Value = (uint16_t)(&hadc->Instance->RESULT0)[ADC_ChannelIndex(hadc->Init.ContinueChannelSel)];
+  hwdg->Event.Type = zone;
+  hwdg->EventPending = 1U;
+
+  if(zone == ADC_WATCHDOG_EVENT_NORMAL)
+  {
+    CLEAR_BIT(hadc->State, HAL_ADC_STATE_OUTRANGE);
+  }
+  else
+  {
+    SET_BIT(hadc->State, HAL_ADC_STATE_OUTRANGE);
+  }
+
+  HAL_ADC_WatchdogCallback(hadc, &hwdg->Event);
+}
+
+/**
+  * @brief  Programs the thresholds watching the way out of a zone.
+  * @param  hadc: ADC handle
+  * @param  Zone: a value of @ref ADC_Watchdog_Event
+  * @retval None
+  */
+static void ADC_Watchdog_Arm(ADC_HandleTypeDef* hadc, uint8_t Zone)
+{
+  ADC_WatchdogInitTypeDef *init = &hadc->pWatchdog->Init;
+  uint32_t compare;
+  uint32_t it;
+
+  if(Zone == ADC_WATCHDOG_EVENT_HIGH)
+  {
+    WRITE_REG(hadc->Instance->LT, init->HighThreshold - init->Hysteresis);
+    compare = ADC_COMP_THRESHOLD_LOW;
+    it = ADC_IT_LOW_THRESHOLD;
+  }
+  else if(Zone == ADC_WATCHDOG_EVENT_LOW)
+  {
+    WRITE_REG(hadc->Instance->HT, init->LowThreshold + init->Hysteresis);
+    compare = ADC_COMP_THRESHOLD_HIGH;
+    it = ADC_IT_HIGH_THRESHOLD;
+  }
+  else
+  {
+    WRITE_REG(hadc->Instance->HT, init->HighThreshold);
+    WRITE_REG(hadc->Instance->LT, init->LowThreshold);
+    compare = ADC_COMP_THRESHOLD_HIGH | ADC_COMP_THRESHOLD_LOW;
+    it = ADC_IT_HIGH_THRESHOLD | ADC_IT_LOW_THRESHOLD;
+  }
+
+  MODIFY_REG(hadc->Instance->CR1, ADC_CR1_LTCMP | ADC_CR1_HTCMP | ADC_CR1_REGCMP, compare);
+  MODIFY_REG(hadc->Instance->INTEN, ADC_IT_RANGE_THRESHOLD | ADC_IT_HIGH_THRESHOLD | ADC_IT_LOW_THRESHOLD, it);
+}
+
+/**
+  * @brief  Converts a continuous mode channel bit into its number.
+  * @param  Channel: one of @ref ADC_ContinueChannelSel
+  * @retval Channel number 0 to 7
+  */
+static uint32_t ADC_ChannelIndex(uint32_t Channel)
+{
+  uint32_t index = 0U;
+
+  while((Channel > 1U) && (index < 7U))
+  {
+    Channel >>= 1;
+    index++;
+  }
+  return index;
+}
+
 /**
   * @brief  Enable the selected ADC.
   * @note   Prerequisite condition to use this function: ADC must be disabled
@@ -36,6 +36,9 @@
         (++) Lock and Unlock the FLASH interface
         (++) Erase function: Erase page, erase all pages
         (++) Program functions: half word, word and doubleword
+        (++) Buffer program function: HAL_FLASH_ProgramBuffer() programs any 
+             length with the widest store the alignment allows, unlocks each 
+             page once and skips bytes that already hold the target value
 				
       (#) Interrupts and flags management functions : this group 
           includes all needed functions to:
@@ -117,6 +120,9 @@ static	void 	FLASH_Program_Byte(uint32_t Address, uint8_t Data);
 static 	void 	FLASH_PageErase(uint32_t PageAddress);
 static 	void 	FLASH_MassErase(void);
 static 	void 	FLASH_SetErrorCode(void);
+static	HAL_StatusTypeDef FLASH_ProgramPage(uint32_t Address, const uint8_t *pData, uint32_t Length);
+static	uint32_t FLASH_ReadUnit(uint32_t Address, uint32_t Width);
+static	uint32_t FLASH_LoadUnit(const uint8_t *pData, uint32_t Width);
 /**
   * @}
   */
@@ -231,6 +237,63 @@ HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint
   return status;
 }
 
+/**
+  * @brief  Program a buffer of any length at a specified address
+  * @note   Each page is unlocked once, every unit then goes through the same
+  *         register sequence as HAL_FLASH_Program(). Aligned runs are programmed
+  *         by word, then halfword, then byte. Locations that
+  *         already hold the target value are skipped, so an interrupted update
+  *         can simply be restarted. Every programmed unit is read back.
+  * @note   FLASH should be previously erased: programming can only clear bits,
+  *         a location whose target needs a bit set back to 1 stops the procedure
+  *         with HAL_FLASH_ERROR_PROG.
+  *
+  * @param  Address:      Specifies the address to be programmed.
+  * @param  pData:        Pointer to the data to be programmed, no alignment needed
+  * @param  Length:       Number of bytes to be programmed
+  * 
+  * @retval HAL_StatusTypeDef HAL Status
+  */
+HAL_StatusTypeDef HAL_FLASH_ProgramBuffer(uint32_t Address, const uint8_t *pData, uint32_t Length)
+{
+  HAL_StatusTypeDef status = HAL_ERROR;
+  uint32_t chunk = 0U;
+
+  if((pData == NULL) || (Length == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(&pFlash);
+
+  pFlash.ErrorCode = HAL_FLASH_ERROR_NONE;
+
+	/* Wait for last operation to be completed */
+	status = FLASH_WaitForLastOperation(FLASH_TIMEOUT_VALUE);
+
+  while((status == HAL_OK) && (Length != 0U))
+  {
+    /* Never cross a page boundary within one unlocked run */
+    chunk = FLASH_PAGE_SIZE - (Address & (FLASH_PAGE_SIZE - 1U));
+    if(chunk > Length)
+    {
+      chunk = Length;
+    }
+
+    status = FLASH_ProgramPage(Address, pData, chunk);
+
+    Address += chunk;
+    pData += chunk;
+    Length -= chunk;
+  }
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(&pFlash);
+
+  return status;
+}
+
 /**
   * @brief  Perform a mass erase or erase the specified FLASH memory pages
   * @note   Default the FLASH memory is written protected against possible unwanted operation.
@@ -653,6 +716,170 @@ static void FLASH_PageErase(uint32_t PageAddress)
 }
 
 
+/**
+  * @brief  Program data which lies within one page, see HAL_FLASH_ProgramBuffer().
+  * @param  Address specify the address to be programmed.
+  * @param  pData   specify the data to be programmed.
+  * @param  Length  specify the number of bytes, Address + Length must not cross a page.
+  * @retval HAL Status
+  */
+static HAL_StatusTypeDef FLASH_ProgramPage(uint32_t Address, const uint8_t *pData, uint32_t Length)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t page = Address & ~(FLASH_PAGE_SIZE - 1U);
+  uint32_t end = Address + Length;
+  uint32_t width = 0U;
+  uint32_t current = 0U;
+  uint32_t target = 0U;
+  uint32_t index = 0U;
+  uint8_t opened = 0U;
+
+  while(Address < end)
+  {
+    /* Widest program width the alignment and the remaining length allow */
+    if(((Address & 0x3U) == 0U) && ((end - Address) >= 4U))
+    {
+      width = 4U;
+    }
+    else if(((Address & 0x1U) == 0U) && ((end - Address) >= 2U))
+    {
+      width = 2U;
+    }
+    else
+    {
+      width = 1U;
+    }
+
+    current = FLASH_ReadUnit(Address, width);
+    target = FLASH_LoadUnit(pData, width);
+
+    if(width != 1U)
+    {
+      /* A byte already holding a programmed value must not be programmed twice,
+         rewriting an erased byte with 0xFF is harmless. Go byte wide otherwise. */
+      for(index = 0U; index < width; index++)
+      {
+        if((((current ^ target) >> (8U * index)) & 0xFFU) == 0U)
+        {
+          if(((target >> (8U * index)) & 0xFFU) != 0xFFU)
+          {
+            width = 1U;
+            current &= 0xFFU;
+            target &= 0xFFU;
+            break;
+          }
+        }
+      }
+    }
+
+    if(current != target)
+    {
+      if((current & target) != target)
+      {
+        /* A bit would have to go from 0 to 1, the page needs an erase first */
+        pFlash.ErrorCode |= HAL_FLASH_ERROR_PROG;
+        status = HAL_ERROR;
+        break;
+      }
+
+      if(opened == 0U)
+      {
+        /* Unlock the page once for the whole run */
+        HAL_FLASH_OPERATION_Unlock(page);
+        opened = 1U;
+      }
+
+      /* Same sequence as FLASH_Program_Byte(): select program operation and
+         write the data before the registers are locked again */
+      __disable_irq();
+      __HAL_FLASH_REGISTER_UNLOCK;
+      MODIFY_REG(FLASH->CR, FLASH_CR_OP, FLASH_OP_PROGRAM);
+      if(width == 4U)
+      {
+        *(__IO uint32_t*)Address = target;
+      }
+      else if(width == 2U)
+      {
+        *(__IO uint16_t*)Address = (uint16_t)target;
+      }
+      else
+      {
+        *(__IO uint8_t*)Address = (uint8_t)target;
+      }
+      __HAL_FLASH_REGISTER_LOCK;
+      __enable_irq();
+
+			/* Wait for last operation to be completed */
+			status = FLASH_WaitForLastOperation(FLASH_TIMEOUT_VALUE);
+
+			/* If the program operation is completed, change operation to Read */
+			__disable_irq();	
+			__HAL_FLASH_REGISTER_UNLOCK;
+			CLEAR_BIT(FLASH->CR, FLASH_CR_OP);
+			__HAL_FLASH_REGISTER_LOCK;
+			__enable_irq();	
+
+      if(status != HAL_OK)
+      {
+        break;
+      }
+
+      if(FLASH_ReadUnit(Address, width) != target)
+      {
+        pFlash.ErrorCode |= HAL_FLASH_ERROR_PROG;
+        status = HAL_ERROR;
+        break;
+      }
+    }
+
+    Address += width;
+    pData += width;
+  }
+
+  if(opened != 0U)
+  {
+		HAL_FLASH_OPERATION_Lock(page);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Read a byte, halfword or word from FLASH.
+  * @param  Address specify the address to be read, aligned on Width.
+  * @param  Width   specify the access width in bytes: 1, 2 or 4.
+  * @retval Value read
+  */
+static uint32_t FLASH_ReadUnit(uint32_t Address, uint32_t Width)
+{
+  if(Width == 4U)
+  {
+    return *(__IO uint32_t*)Address;
+  }
+  else if(Width == 2U)
+  {
+    return *(__IO uint16_t*)Address;
+  }
+  return *(__IO uint8_t*)Address;
+}
+
+/**
+  * @brief  Assemble a little endian byte, halfword or word from a byte buffer.
+  * @param  pData   specify the source, no alignment needed.
+  * @param  Width   specify the number of bytes: 1, 2 or 4.
+  * @retval Assembled value
+  */
+static uint32_t FLASH_LoadUnit(const uint8_t *pData, uint32_t Width)
+{
+  uint32_t value = 0U;
+
+  while(Width-- != 0U)
+  {
+    value = (value << 8) | pData[Width];
+  }
+  return value;
+}
+
 /**
   * @brief  Set the specific FLASH error flag.
   * @retval None
@@ -27,12 +27,22 @@
 #define I2C_TIMEOUT_FLAG          10U         /*!< Timeout 10 ms             */
 #define I2C_TIMEOUT_BUSY_FLAG     20U             /*!< Timeout 20 ms             */
 
+#define I2C_REGMAP_PHASE_POINTER  0U          /*!< Next written byte is the register pointer */
+#define I2C_REGMAP_PHASE_DATA     1U          /*!< Next written byte is register data        */
+#define I2C_REGMAP_PHASE_IGNORE   2U          /*!< General call, written bytes are ignored   */
+
 /**
   * @}
   */
 
 
 /* Private function prototypes -----------------------------------------------*/
+static void I2C_Master_IT(I2C_HandleTypeDef *hi2c);
+static void I2C_Master_Phase(I2C_HandleTypeDef *hi2c);
+static void I2C_Master_Complete(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef Status);
+static void I2C_Master_End(I2C_HandleTypeDef *hi2c);
+static void I2C_Batch_Load(I2C_HandleTypeDef *hi2c);
+static void I2C_Slave_RegMap_IT(I2C_HandleTypeDef *hi2c);
 	
 	/** @addtogroup I2C_Exported_Functions
   * @{
@@ -101,6 +111,9 @@ HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
 	HAL_I2C_Clear_Interrupt_Flag(hi2c);
     
     hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->pXfer = NULL;
+    hi2c->pBatch = NULL;
+    hi2c->pRegMap = NULL;
     hi2c->State = HAL_I2C_STATE_READY;  
 	hi2c->PreviousState = HAL_I2C_STATE_NONE;
  
@@ -150,6 +163,9 @@ HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
 	HAL_I2C_MspDeInit(hi2c);
   
 	hi2c->ErrorCode     = HAL_I2C_ERROR_NONE;
+	hi2c->pXfer         = NULL;
+	hi2c->pBatch        = NULL;
+	hi2c->pRegMap       = NULL;
 	hi2c->State         = HAL_I2C_STATE_RESET;
 	//  hi2c->PreviousState = I2C_STATE_NONE;
 	hi2c->Mode          = HAL_I2C_MODE_NONE;	
@@ -718,6 +734,218 @@ HAL_StatusTypeDef HAL_I2C_Slave_Receive(I2C_HandleTypeDef *hi2c, uint8_t *pData,
 }
 
 
+/**
+  * @brief  Starts a master transfer in interrupt mode.
+  * @note   The transfer runs from HAL_I2C_IRQHandler(), I2C_IRQn must be enabled
+  *         in HAL_I2C_MspInit(). The bytes of pXfer->pTxData are written, then
+  *         after a repeated start pXfer->RxSize bytes are read, then a stop is sent.
+  *         pXfer->XferCpltCallback is called at the end with pXfer->Status set.
+  *         The descriptor and its buffers must stay valid until then.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @param  pXfer Pointer to the transfer descriptor
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2C_Master_Transfer_IT(I2C_HandleTypeDef *hi2c, I2C_TransferTypeDef *pXfer)
+{
+	if((pXfer == NULL) || ((pXfer->pTxData == NULL) && (pXfer->TxSize != 0U)) ||
+	   ((pXfer->pRxData == NULL) && (pXfer->RxSize != 0U)))
+	{
+		return HAL_ERROR;
+	}
+
+	if(hi2c->State != HAL_I2C_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+
+	hi2c->Mode      = HAL_I2C_MODE_MASTER;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	hi2c->pXfer     = pXfer;
+	hi2c->pBatch    = NULL;
+	hi2c->XferCountNext = 0U;
+	hi2c->XferTickstart = HAL_GetTick();
+	pXfer->Status   = HAL_BUSY;
+
+	I2C_Master_Phase(hi2c);
+	HAL_I2C_Start_Config(hi2c, ENABLE);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Starts a batch of register accesses in interrupt mode.
+  * @note   Each item writes its register address then writes or, after a repeated
+  *         start, reads its data. The items follow each other with repeated starts
+  *         and a single stop ends the batch. pBatch->BatchCpltCallback is called
+  *         once at the end with pBatch->Status set, on error pBatch->Index is the
+  *         failed item and the remaining items are not done.
+  *         The batch may be started again as is from its callback for periodic polling.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @param  pBatch Pointer to the batch
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2C_Master_Batch_IT(I2C_HandleTypeDef *hi2c, I2C_BatchTypeDef *pBatch)
+{
+	uint16_t i;
+
+	if((pBatch == NULL) || (pBatch->pItems == NULL) || (pBatch->Count == 0U))
+	{
+		return HAL_ERROR;
+	}
+	for(i = 0U; i < pBatch->Count; i++)
+	{
+		assert_param(IS_I2C_DIRECTION(pBatch->pItems[i].Direction));
+		if(((pBatch->pItems[i].pData == NULL) && (pBatch->pItems[i].Size != 0U)) ||
+		   ((pBatch->pItems[i].Direction == I2C_Direction_Receiver) && (pBatch->pItems[i].Size == 0U)))
+		{
+			return HAL_ERROR;
+		}
+	}
+
+	if(hi2c->State != HAL_I2C_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+
+	hi2c->Mode      = HAL_I2C_MODE_MASTER;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	hi2c->pBatch    = pBatch;
+	hi2c->pXfer     = &pBatch->Xfer;
+	hi2c->XferTickstart = HAL_GetTick();
+	pBatch->Status  = HAL_BUSY;
+	pBatch->Index   = 0U;
+	pBatch->Xfer.Timeout = pBatch->Timeout;
+	pBatch->Xfer.XferCpltCallback = NULL;
+
+	I2C_Batch_Load(hi2c);
+	HAL_I2C_Start_Config(hi2c, ENABLE);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Aborts the master interrupt transfer when it is longer than its Timeout.
+  * @note   To be called periodically, from the main loop or the SysTick callback.
+  *         On timeout the I2C is reset and the transfer completes with
+  *         HAL_TIMEOUT. The reset only releases the lines this I2C drives: a
+  *         slave still holding SDA low is not freed, the application has to
+  *         clock SCL (up to 9 pulses through GPIO) until it lets SDA go.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @retval HAL_TIMEOUT when the transfer was aborted, else HAL_OK
+  */
+HAL_StatusTypeDef HAL_I2C_Master_CheckTimeout(I2C_HandleTypeDef *hi2c)
+{
+	I2C_TransferTypeDef *pXfer;
+	uint32_t primask;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	pXfer = hi2c->pXfer;
+	if((pXfer == NULL) || ((HAL_GetTick() - hi2c->XferTickstart) <= pXfer->Timeout))
+	{
+		__set_PRIMASK(primask);
+		return HAL_OK;
+	}
+
+	__HAL_I2C_DISABLE(hi2c);
+	CLEAR_BIT(hi2c->Instance->CR, (I2C_CR_STA | I2C_CR_STO | I2C_CR_SI));
+	__HAL_I2C_ENABLE(hi2c);
+	HAL_NVIC_ClearPendingIRQ(I2C_IRQn);
+
+	hi2c->ErrorCode |= HAL_I2C_ERROR_TIMEOUT;
+	__set_PRIMASK(primask);
+
+	I2C_Master_Complete(hi2c, HAL_TIMEOUT);
+
+	return HAL_TIMEOUT;
+}
+
+/**
+  * @brief  Starts the slave register map emulation in interrupt mode.
+  * @note   The I2C must be initialized with the slave mode enabled and I2C_IRQn
+  *         enabled in HAL_I2C_MspInit(). Address match, register pointer, reads
+  *         and writes are all handled in HAL_I2C_IRQHandler(), the application is
+  *         only called through HAL_I2C_RegMapWriteCallback() at the end of each
+  *         transaction which wrote registers. Reads beyond Size return 0xFF and
+  *         writes beyond Size are ignored.
+  *         The master functions return HAL_BUSY until HAL_I2C_Slave_RegMap_Stop_IT().
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @param  pRegMap Pointer to the register map
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2C_Slave_RegMap_Start_IT(I2C_HandleTypeDef *hi2c, I2C_RegMapTypeDef *pRegMap)
+{
+	if((pRegMap == NULL) || (pRegMap->pRegisters == NULL) || (pRegMap->Size == 0U) || (pRegMap->Size > 256U) ||
+	   (hi2c->Init.slave != I2C_SLAVE_MODE_ENABLE))
+	{
+		return HAL_ERROR;
+	}
+
+	if(hi2c->State != HAL_I2C_STATE_READY)
+	{
+		return HAL_BUSY;
+	}
+
+	hi2c->State     = HAL_I2C_STATE_BUSY;
+	hi2c->Mode      = HAL_I2C_MODE_SLAVE;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+	pRegMap->Pointer    = 0U;
+	pRegMap->WriteCount = 0U;
+	pRegMap->Phase      = I2C_REGMAP_PHASE_POINTER;
+	hi2c->pRegMap       = pRegMap;
+
+	HAL_I2C_ACK_Config(hi2c, ENABLE);
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Stops the slave register map emulation.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_I2C_Slave_RegMap_Stop_IT(I2C_HandleTypeDef *hi2c)
+{
+	if(hi2c->pRegMap == NULL)
+	{
+		return HAL_ERROR;
+	}
+
+	hi2c->pRegMap = NULL;
+	hi2c->Mode    = HAL_I2C_MODE_NONE;
+	hi2c->State   = HAL_I2C_STATE_READY;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Register map write callback, called from the interrupt at the stop
+  *         or repeated start ending a transaction which wrote registers.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @param  Register First register written
+  * @param  Count Number of registers written, the pointer may wrap past 255
+  * @retval None
+  */
+__weak void HAL_I2C_RegMapWriteCallback(I2C_HandleTypeDef *hi2c, uint8_t Register, uint16_t Count)
+{
+  /* Prevent unused argument(s) compilation warning */
+	UNUSED(hi2c);
+	UNUSED(Register);
+	UNUSED(Count);
+
+  /* NOTE : This function Should not be modified, when the callback is needed,
+            the HAL_I2C_RegMapWriteCallback could be implemented in the user file
+   */
+}
+
 /**
   * @brief  This function handles I2C  interrupt request.
   * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
@@ -728,8 +956,18 @@ void HAL_I2C_IRQHandler(I2C_HandleTypeDef *hi2c)
 {
 	uint32_t CurrentMode  = hi2c->Mode;
 	
+	/* Master interrupt transfer */
+	if(hi2c->pXfer != NULL)
+	{
+		I2C_Master_IT(hi2c);
+	}
+	/* Slave register map */
+	else if(hi2c->pRegMap != NULL)
+	{
+		I2C_Slave_RegMap_IT(hi2c);
+	}
 	/* Master mode selected */	
-	if(CurrentMode == HAL_I2C_MODE_MASTER)	
+	else if(CurrentMode == HAL_I2C_MODE_MASTER)	
 	{
 		HAL_I2C_MasterCallback(hi2c);
 	}
@@ -775,6 +1013,308 @@ __weak void HAL_I2C_SlaveCallback(I2C_HandleTypeDef *hi2c)
 
 
 
+/**
+  * @}
+  */
+
+/** @defgroup I2C_Private_Functions I2C Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Selects the phase of the master transfer started by the next start condition.
+  * @note   The write phase comes first, a transfer without data to write begins
+  *         with the read phase.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @retval None
+  */
+static void I2C_Master_Phase(I2C_HandleTypeDef *hi2c)
+{
+	I2C_TransferTypeDef *pXfer = hi2c->pXfer;
+
+	if((pXfer->TxSize != 0U) || (pXfer->RxSize == 0U))
+	{
+		hi2c->State      = HAL_I2C_STATE_BUSY_TX;
+		hi2c->pTxBuffPtr = pXfer->pTxData;
+		hi2c->XferCount  = pXfer->TxSize;
+	}
+	else
+	{
+		hi2c->State      = HAL_I2C_STATE_BUSY_RX;
+		hi2c->pRxBuffPtr = pXfer->pRxData;
+		hi2c->XferCount  = pXfer->RxSize;
+	}
+}
+
+/**
+  * @brief  Prepares the transfer of the current batch item.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @retval None
+  */
+static void I2C_Batch_Load(I2C_HandleTypeDef *hi2c)
+{
+	I2C_BatchTypeDef *pBatch = hi2c->pBatch;
+	I2C_BatchItemTypeDef *pItem = &pBatch->pItems[pBatch->Index];
+	I2C_TransferTypeDef *pXfer = &pBatch->Xfer;
+
+	pXfer->DevAddress = pItem->DevAddress;
+	pXfer->pTxData    = &pItem->Register;
+	pXfer->TxSize     = 1U;
+	if(pItem->Direction == I2C_Direction_Receiver)
+	{
+		pXfer->pRxData = pItem->pData;
+		pXfer->RxSize  = pItem->Size;
+		hi2c->XferCountNext = 0U;
+	}
+	else
+	{
+		pXfer->pRxData = NULL;
+		pXfer->RxSize  = 0U;
+		/* The data follow the register address in the same write phase */
+		hi2c->pTxBuffNext   = pItem->pData;
+		hi2c->XferCountNext = pItem->Size;
+	}
+
+	I2C_Master_Phase(hi2c);
+}
+
+/**
+  * @brief  Ends the master transfer after its last byte, goes on with the
+  *         next batch item with a repeated start or sends the stop condition.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @retval None
+  */
+static void I2C_Master_End(I2C_HandleTypeDef *hi2c)
+{
+	I2C_BatchTypeDef *pBatch = hi2c->pBatch;
+
+	if((pBatch != NULL) && ((pBatch->Index + 1U) < pBatch->Count))
+	{
+		pBatch->Index++;
+		I2C_Batch_Load(hi2c);
+		SET_BIT(hi2c->Instance->CR, I2C_CR_STA);
+		CLEAR_BIT(hi2c->Instance->CR, I2C_CR_SI);
+		return;
+	}
+
+	HAL_I2C_Stop_Config(hi2c, ENABLE);
+	I2C_Master_Complete(hi2c, HAL_OK);
+}
+
+/**
+  * @brief  Ends the master transfer and calls its callback.
+  * @note   The stop condition, if any, must already be requested.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @param  Status Final status of the transfer
+  * @retval None
+  */
+static void I2C_Master_Complete(I2C_HandleTypeDef *hi2c, HAL_StatusTypeDef Status)
+{
+	I2C_TransferTypeDef *pXfer = hi2c->pXfer;
+	I2C_BatchTypeDef *pBatch = hi2c->pBatch;
+
+	/* Acknowledge its own address again when the slave mode is used */
+	if(hi2c->Init.slave == I2C_SLAVE_MODE_ENABLE)
+		SET_BIT(hi2c->Instance->CR, I2C_CR_AA);
+
+	hi2c->pXfer  = NULL;
+	hi2c->pBatch = NULL;
+	hi2c->Mode   = HAL_I2C_MODE_NONE;
+	hi2c->State  = HAL_I2C_STATE_READY;
+
+	pXfer->Status = Status;
+	if(pBatch != NULL)
+	{
+		pBatch->Status = Status;
+		if(pBatch->BatchCpltCallback != NULL)
+		{
+			pBatch->BatchCpltCallback(hi2c, pBatch);
+		}
+	}
+	else if(pXfer->XferCpltCallback != NULL)
+	{
+		pXfer->XferCpltCallback(hi2c, pXfer);
+	}
+}
+
+/**
+  * @brief  Master transfer state machine, one step per SI on the I2C status code.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @retval None
+  */
+static void I2C_Master_IT(I2C_HandleTypeDef *hi2c)
+{
+	I2C_TransferTypeDef *pXfer = hi2c->pXfer;
+	uint32_t i2c_flag = hi2c->Instance->SR;
+
+	switch(i2c_flag)
+	{
+		case I2C_FLAG_MASTER_TX_START:
+		case I2C_FLAG_MASTER_TX_RESTART:
+			if(hi2c->State == HAL_I2C_STATE_BUSY_TX)
+				hi2c->Instance->DATA = pXfer->DevAddress & (uint8_t)~I2C_Direction_Receiver;
+			else
+				hi2c->Instance->DATA = pXfer->DevAddress | I2C_Direction_Receiver;
+			CLEAR_BIT(hi2c->Instance->CR, (I2C_CR_STA | I2C_CR_SI));
+			break;
+
+		case I2C_FLAG_MASTER_TX_SLAW_ACK:
+		case I2C_FLAG_MASTER_TX_DATA_ACK:
+			if(hi2c->XferCount != 0U)
+			{
+				hi2c->XferCount--;
+				hi2c->Instance->DATA = *hi2c->pTxBuffPtr++;
+				CLEAR_BIT(hi2c->Instance->CR, I2C_CR_SI);
+			}
+			else if(hi2c->XferCountNext != 0U)
+			{
+				/* Register address sent, go on with the batch item data */
+				hi2c->pTxBuffPtr    = hi2c->pTxBuffNext;
+				hi2c->XferCount     = hi2c->XferCountNext - 1U;
+				hi2c->XferCountNext = 0U;
+				hi2c->Instance->DATA = *hi2c->pTxBuffPtr++;
+				CLEAR_BIT(hi2c->Instance->CR, I2C_CR_SI);
+			}
+			else if(pXfer->RxSize != 0U)
+			{
+				/* Write phase done, repeated start for the read phase */
+				hi2c->State      = HAL_I2C_STATE_BUSY_RX;
+				hi2c->pRxBuffPtr = pXfer->pRxData;
+				hi2c->XferCount  = pXfer->RxSize;
+				SET_BIT(hi2c->Instance->CR, I2C_CR_STA);
+				CLEAR_BIT(hi2c->Instance->CR, I2C_CR_SI);
+			}
+			else
+			{
+				I2C_Master_End(hi2c);
+			}
+			break;
+
+		case I2C_FLAG_MASTER_RX_SLAW_ACK:
+			/* Acknowledge all the bytes but the last one */
+			if(hi2c->XferCount > 1U)
+				SET_BIT(hi2c->Instance->CR, I2C_CR_AA);
+			else
+				CLEAR_BIT(hi2c->Instance->CR, I2C_CR_AA);
+			CLEAR_BIT(hi2c->Instance->CR, I2C_CR_SI);
+			break;
+
+		case I2C_FLAG_MASTER_RX_DATA_ACK:
+			*hi2c->pRxBuffPtr++ = (uint8_t)hi2c->Instance->DATA;
+			hi2c->XferCount--;
+			if(hi2c->XferCount > 1U)
+				SET_BIT(hi2c->Instance->CR, I2C_CR_AA);
+			else
+				CLEAR_BIT(hi2c->Instance->CR, I2C_CR_AA);
+			CLEAR_BIT(hi2c->Instance->CR, I2C_CR_SI);
+			break;
+
+		case I2C_FLAG_MASTER_RX_DATA_NOACK:
+			*hi2c->pRxBuffPtr++ = (uint8_t)hi2c->Instance->DATA;
+			hi2c->XferCount--;
+			I2C_Master_End(hi2c);
+			break;
+
+		case I2C_FLAG_MASTER_TX_SLAW_NOACK:
+		case I2C_FLAG_MASTER_TX_DATA_NOACK:
+		case I2C_FLAG_MASTER_RX_SLAW_NOACK:
+			hi2c->ErrorCode |= HAL_I2C_ERROR_AF;
+			HAL_I2C_Stop_Config(hi2c, ENABLE);
+			I2C_Master_Complete(hi2c, HAL_ERROR);
+			break;
+
+		case I2C_FLAG_MASTER_TX_LOST_SCL:
+			/* The bus is released, no stop condition */
+			hi2c->ErrorCode |= HAL_I2C_ERROR_ARLO;
+			CLEAR_BIT(hi2c->Instance->CR, (I2C_CR_STA | I2C_CR_SI));
+			I2C_Master_Complete(hi2c, HAL_ERROR);
+			break;
+
+		default:
+			hi2c->ErrorCode |= HAL_I2C_ERROR_BERR;
+			HAL_I2C_Stop_Config(hi2c, ENABLE);
+			I2C_Master_Complete(hi2c, HAL_ERROR);
+			break;
+	}
+}
+
+/**
+  * @brief  Slave register map state machine, one step per SI on the I2C status code.
+  * @note   AA stays set, every byte is acknowledged.
+  * @param  hi2c Pointer to a I2C_HandleTypeDef structure that contains
+  *                the configuration information for the specified I2C.
+  * @retval None
+  */
+static void I2C_Slave_RegMap_IT(I2C_HandleTypeDef *hi2c)
+{
+	I2C_RegMapTypeDef *pRegMap = hi2c->pRegMap;
+	uint32_t i2c_flag = hi2c->Instance->SR;
+	uint8_t data;
+	uint8_t mask;
+
+	switch(i2c_flag)
+	{
+		case I2C_FLAG_SLAVE_RX_SLAW_ACK:
+		case I2C_FLAG_SLAVE_RX_SA_LOST_SCL:
+			pRegMap->Phase = I2C_REGMAP_PHASE_POINTER;
+			pRegMap->WriteCount = 0U;
+			break;
+
+		case I2C_FLAG_SLAVE_RX_BROAD_ACK:
+		case I2C_FLAG_SLAVE_RX_BA_LOST_SCL:
+			pRegMap->Phase = I2C_REGMAP_PHASE_IGNORE;
+			break;
+
+		case I2C_FLAG_SLAVE_RX_SDATA_ACK:
+			data = (uint8_t)hi2c->Instance->DATA;
+			if(pRegMap->Phase == I2C_REGMAP_PHASE_POINTER)
+			{
+				pRegMap->Pointer    = data;
+				pRegMap->WriteStart = data;
+				pRegMap->Phase      = I2C_REGMAP_PHASE_DATA;
+			}
+			else
+			{
+				if(pRegMap->Pointer < pRegMap->Size)
+				{
+					mask = (pRegMap->pWriteMask != NULL) ? pRegMap->pWriteMask[pRegMap->Pointer] : 0x00U;
+					pRegMap->pRegisters[pRegMap->Pointer] = (pRegMap->pRegisters[pRegMap->Pointer] & (uint8_t)~mask) | (data & mask);
+				}
+				pRegMap->Pointer++;
+				pRegMap->WriteCount++;
+			}
+			break;
+
+		case I2C_FLAG_SLAVE_STOP_RESTART:
+			if(pRegMap->WriteCount != 0U)
+			{
+				HAL_I2C_RegMapWriteCallback(hi2c, pRegMap->WriteStart, pRegMap->WriteCount);
+				pRegMap->WriteCount = 0U;
+			}
+			pRegMap->Phase = I2C_REGMAP_PHASE_POINTER;
+			break;
+
+		case I2C_FLAG_SLAVE_TX_SLAW_ACK:
+		case I2C_FLAG_SLAVE_TX_LOST_SCL:
+		case I2C_FLAG_SLAVE_TX_DATA_ACK:
+			hi2c->Instance->DATA = (pRegMap->Pointer < pRegMap->Size) ? pRegMap->pRegisters[pRegMap->Pointer] : 0xFFU;
+			pRegMap->Pointer++;
+			break;
+
+		default:
+			/* Read ended by the master, general call data, bus error */
+			break;
+	}
+
+	SET_BIT(hi2c->Instance->CR, I2C_CR_AA);
+	CLEAR_BIT(hi2c->Instance->CR, I2C_CR_SI);
+}
+
 /**
   * @}
   */
@@ -35,6 +35,9 @@
     (#) For the LPUART asynchronous mode, initialize the LPUART registers by calling
         the HAL_LPUART_Init() API.
 
+    (#) For the LPUART multiprocessor mode, initialize the LPUART registers by calling 
+        the HAL_LPUART_MultiProcessor_Init() API.
+
      [..] 
        (@) The specific LPUART interrupts (Transmission complete interrupt, 
            RXNE interrupt and Error Interrupts) will be managed using the macros
@@ -142,6 +145,14 @@ static HAL_StatusTypeDef LPUART_Transmit_IT(LPUART_HandleTypeDef *hlpuart);
 static HAL_StatusTypeDef LPUART_Receive_IT(LPUART_HandleTypeDef *hlpuart);
 static HAL_StatusTypeDef LPUART_WaitOnFlagUntilTimeout(LPUART_HandleTypeDef *hlpuart, uint32_t Flag, FlagStatus Status, uint32_t Tickstart, uint32_t Timeout);
 static void LPUART_SetConfig (LPUART_HandleTypeDef *hlpuart);
+static void LPUART_SetByteHandlers(LPUART_HandleTypeDef *hlpuart);
+static void LPUART_TxByte(LPUART_TypeDef *LPUARTx, uint8_t Data);
+static void LPUART_TxByte_Even(LPUART_TypeDef *LPUARTx, uint8_t Data);
+static void LPUART_TxByte_Odd(LPUART_TypeDef *LPUARTx, uint8_t Data);
+static uint32_t LPUART_RxByte(LPUART_TypeDef *LPUARTx, uint8_t *pData);
+static uint32_t LPUART_RxByte_Even(LPUART_TypeDef *LPUARTx, uint8_t *pData);
+static uint32_t LPUART_RxByte_Odd(LPUART_TypeDef *LPUARTx, uint8_t *pData);
+static uint32_t LPUART_RxByte_Config(LPUART_TypeDef *LPUARTx, uint8_t *pData);
 
 /**
   * @}
@@ -169,6 +180,10 @@ static void LPUART_SetConfig (LPUART_HandleTypeDef *hlpuart);
     [..]
     The HAL_LPUART_Init() API follow respectively the LPUART asynchronous, configuration 
 		procedures (details for the procedures are available in reference manuals)
+    [..]
+    HAL_LPUART_MultiProcessor_Init() configures the 9-bit multiprocessor mode, the
+    hardware compares the address frames with the SADDR/SADEN registers so the 
+    CPU is only interrupted for the messages addressed to this node.
 
 @endverbatim
   * @{
@@ -214,6 +229,97 @@ HAL_StatusTypeDef HAL_LPUART_Init(LPUART_HandleTypeDef *hlpuart)
   return HAL_OK;
 }
 
+/**
+  * @brief  Initializes the LPUART in multiprocessor mode, the receiver only takes
+  *         an interrupt for address frames (9th bit set) matching the given 
+  *         or the broadcast address.
+  * @note   Init.WordLength must be LPUART_WORDLENGTH_9B and Init.Parity LPUART_PARITY_NONE,
+  *         the 9th bit is the address/data flag. The hardware matches:
+  *           given address:     Address on the bits set in BroadcastAddress,
+  *                              the other bits are don't care
+  *           broadcast address: BroadcastAddress, usually 0xFF
+  * @note   The receiver starts in mute mode. On the matching address byte call
+  *         HAL_LPUART_MultiProcessor_ExitMuteMode() to receive the data frames that
+  *         follow, then HAL_LPUART_MultiProcessor_EnterMuteMode() at the end of the 
+  *         message. Data frames are sent with the 9th bit cleared.
+  * @param  hlpuart: pointer to a LPUART_HandleTypeDef structure that contains
+  *                the configuration information for the specified LPUART module.
+  * @param  Address: LPUART node address
+  * @param  BroadcastAddress: LPUART broadcast address, it must include every bit set in Address
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_Init(LPUART_HandleTypeDef *hlpuart, uint8_t Address, uint8_t BroadcastAddress)
+{
+  /* Check the LPUART handle allocation */
+  if(hlpuart == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  /* The 9th bit is the address flag, it can not carry a parity bit */
+  if((hlpuart->Init.WordLength != LPUART_WORDLENGTH_9B) || (hlpuart->Init.Parity != LPUART_PARITY_NONE) ||
+     ((Address & (uint8_t)~BroadcastAddress) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  
+  if(hlpuart->gState == HAL_LPUART_STATE_RESET)
+  {  
+    /* Allocate lock resource and initialize it */
+    hlpuart->Lock = HAL_UNLOCKED;
+
+    /* Init the low level hardware */
+    HAL_LPUART_MspInit(hlpuart);
+  }
+
+  hlpuart->gState = HAL_LPUART_STATE_BUSY;
+  
+  /* Set the LPUART Communication parameters */
+  LPUART_SetConfig(hlpuart);
+
+  /* Set the given and broadcast addresses, send data frames and start muted */
+  WRITE_REG(hlpuart->Instance->SADDR, Address);
+  WRITE_REG(hlpuart->Instance->SADEN, BroadcastAddress);
+  CLEAR_BIT(hlpuart->Instance->SCON, LPUART_SCON_TB8);
+  SET_BIT(hlpuart->Instance->SCON, LPUART_SCON_SM2);
+
+  /* Enable the Peripheral */	
+  __HAL_LPUART_ENABLE(hlpuart);
+
+  /* Initialize the LPUART state */
+  hlpuart->ErrorCode = HAL_LPUART_ERROR_NONE;
+  hlpuart->gState= HAL_LPUART_STATE_READY;
+  hlpuart->RxState= HAL_LPUART_STATE_READY;
+  
+  return HAL_OK;
+}
+
+/**
+  * @brief  Enters the LPUART mute mode, only matching address frames are received.
+  * @param  hlpuart: pointer to a LPUART_HandleTypeDef structure that contains
+  *                the configuration information for the specified LPUART module.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_EnterMuteMode(LPUART_HandleTypeDef *hlpuart)
+{
+  SET_BIT(hlpuart->Instance->SCON, LPUART_SCON_SM2);
+  
+  return HAL_OK;
+}
+
+/**
+  * @brief  Exits the LPUART mute mode, every frame is received.
+  * @param  hlpuart: pointer to a LPUART_HandleTypeDef structure that contains
+  *                the configuration information for the specified LPUART module.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_ExitMuteMode(LPUART_HandleTypeDef *hlpuart)
+{
+  CLEAR_BIT(hlpuart->Instance->SCON, LPUART_SCON_SM2);
+  
+  return HAL_OK;
+}
+
 
 /**
   * @brief  DeInitializes the LPUART peripheral. 
@@ -365,36 +471,14 @@ HAL_StatusTypeDef HAL_LPUART_Transmit(LPUART_HandleTypeDef *hlpuart, uint8_t *pD
     while(hlpuart->TxXferCount > 0U)
     {
       hlpuart->TxXferCount--;
-      if(hlpuart->Init.WordLength == LPUART_WORDLENGTH_9B)
-      {
-        if(hlpuart->Init.Parity == LPUART_PARITY_EVEN)
-        {
-          MODIFY_REG(hlpuart->Instance->SCON, LPUART_SCON_TB8, ((ParityTable256[*pData] & LPUART_BIT0_Msk) << LPUART_SCON_TB8_Pos));
-        }
-        else if(hlpuart->Init.Parity == LPUART_PARITY_ODD)
-        {
-          MODIFY_REG(hlpuart->Instance->SCON, LPUART_SCON_TB8, (((~ParityTable256[*pData]) & LPUART_BIT0_Msk) << LPUART_SCON_TB8_Pos));
-        }				
-				
-        hlpuart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);	
+      /* TB8 is set by the handler bound to the frame format at init */
+      hlpuart->TxByte(hlpuart->Instance, *pData++);
 				
-        if(LPUART_WaitOnFlagUntilTimeout(hlpuart, LPUART_FLAG_TC, RESET, tickstart, Timeout) != HAL_OK) 
-        {
-          return HAL_TIMEOUT;
-        }		
-				__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_TC);		
-      }
-      else
+      if(LPUART_WaitOnFlagUntilTimeout(hlpuart, LPUART_FLAG_TC, RESET, tickstart, Timeout) != HAL_OK)
       {
-				/* uart 8bit communication doesn't support parity transmit */
-        hlpuart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);
-				
-        if(LPUART_WaitOnFlagUntilTimeout(hlpuart, LPUART_FLAG_TC, RESET, tickstart, Timeout) != HAL_OK)
-        {
-          return HAL_TIMEOUT;
-        }				
-				__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_TC);				
-      }
+        return HAL_TIMEOUT;
+      }		
+			__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_TC);		
     }
 		
     /* At end of Tx process, restore hlpuart->gState to Ready */
@@ -411,6 +495,52 @@ HAL_StatusTypeDef HAL_LPUART_Transmit(LPUART_HandleTypeDef *hlpuart, uint8_t *pD
   }
 }
 
+/**
+  * @brief  Sends one address frame (9th bit set) in multiprocessor mode.
+  * @note   Only the nodes whose given or broadcast address matches are 
+  *         interrupted, the data frames that follow are sent with the usual
+  *         transmit functions.
+  * @param  hlpuart: pointer to a LPUART_HandleTypeDef structure that contains
+  *                the configuration information for the specified LPUART module.
+  * @param  Address: address of the destination node
+  * @param  Timeout: Timeout duration  
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_LPUART_MultiProcessor_SendAddress(LPUART_HandleTypeDef *hlpuart, uint8_t Address, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  
+  /* Check that a Tx process is not already ongoing */
+  if(hlpuart->gState != HAL_LPUART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hlpuart);
+
+  hlpuart->gState = HAL_LPUART_STATE_BUSY_TX;
+
+  /* TC interrupt must be enabled to unmask TC flag for polling */
+  __HAL_LPUART_ENABLE_IT(hlpuart, LPUART_IT_TC);
+
+  SET_BIT(hlpuart->Instance->SCON, LPUART_SCON_TB8);
+  hlpuart->Instance->SBUF = Address;
+  if(LPUART_WaitOnFlagUntilTimeout(hlpuart, LPUART_FLAG_TC, RESET, HAL_GetTick(), Timeout) != HAL_OK)
+  {
+    status = HAL_TIMEOUT;
+  }
+  __HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_TC);
+  CLEAR_BIT(hlpuart->Instance->SCON, LPUART_SCON_TB8);
+
+  hlpuart->gState = HAL_LPUART_STATE_READY;
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(hlpuart);
+
+  return status;
+}
+
 
 /**
   * @brief  Receive an amount of data in blocking mode. 
@@ -423,7 +553,7 @@ HAL_StatusTypeDef HAL_LPUART_Transmit(LPUART_HandleTypeDef *hlpuart, uint8_t *pD
   */
 HAL_StatusTypeDef HAL_LPUART_Receive(LPUART_HandleTypeDef *hlpuart, uint8_t *pData, uint16_t Size, uint32_t Timeout)
 {
-  uint8_t tmp;
+  uint32_t error;
   uint32_t tickstart = 0U;
   
   /* Check that a Rx process is not already ongoing */
@@ -453,77 +583,23 @@ HAL_StatusTypeDef HAL_LPUART_Receive(LPUART_HandleTypeDef *hlpuart, uint8_t *pDa
     while(hlpuart->RxXferCount > 0U)
     {
       hlpuart->RxXferCount--;
-      if(hlpuart->Init.WordLength == LPUART_WORDLENGTH_9B)
-      {
-        if(LPUART_WaitOnFlagUntilTimeout(hlpuart, LPUART_FLAG_RXNE, RESET, tickstart, Timeout) != HAL_OK) 
-        {
-          return HAL_TIMEOUT;
-        }
-				__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_RXNE); 
-
-				tmp = (uint8_t)(hlpuart->Instance->SBUF & (uint8_t)0xFF); 
-				if(hlpuart->Init.Parity == LPUART_PARITY_NONE)
-				{
-						*pData++ = tmp&((uint8_t)0xFF);	
-				}
-				else if(hlpuart->Init.Parity == LPUART_PARITY_EVEN)
-				{
-					if((ParityTable256[tmp&((uint8_t)0xFF)]) == (((hlpuart->Instance->SCON & LPUART_SCON_RB8) >> LPUART_SCON_RB8_Pos) & LPUART_BIT0_Msk))	
-					{
-						*pData++ = tmp&((uint8_t)0xFF);
-					}
-					else
-					{
-						/* Rx error process, set hlpuart->RxState to Error */
-						hlpuart->RxState = HAL_LPUART_STATE_ERROR;
-						__HAL_UNLOCK(hlpuart);
-						return HAL_ERROR;						
-					}				
-				}
-				else if(hlpuart->Init.Parity == LPUART_PARITY_ODD)
-				{
-					if((ParityTable256[tmp&((uint8_t)0xFF)]) == ((~((hlpuart->Instance->SCON & LPUART_SCON_RB8) >> LPUART_SCON_RB8_Pos)) & LPUART_BIT0_Msk))	
-					{
-						*pData++ = tmp&((uint8_t)0xFF);
-					}	
-					else
-					{
-						/* Rx error process, set hlpuart->RxState to Error */
-						hlpuart->RxState = HAL_LPUART_STATE_ERROR;
-						__HAL_UNLOCK(hlpuart);
-						return HAL_ERROR;						
-					}							
-				}
-				else
-				{
-					/* Rx error process, set hlpuart->RxState to Error */
-					hlpuart->RxState = HAL_LPUART_STATE_ERROR;
-					__HAL_UNLOCK(hlpuart);
-					return HAL_ERROR;						
-				}
-      } 
-      else
+      if(LPUART_WaitOnFlagUntilTimeout(hlpuart, LPUART_FLAG_RXNE, RESET, tickstart, Timeout) != HAL_OK) 
       {
-        if(LPUART_WaitOnFlagUntilTimeout(hlpuart, LPUART_FLAG_RXNE, RESET, tickstart, Timeout) != HAL_OK)
-        {
-          return HAL_TIMEOUT;
-        }
-				__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_RXNE);
-				
-				/* uart 8bit communication doesn't support parity check */
-        if(hlpuart->Init.Parity != LPUART_PARITY_NONE)
-        {
-					/* Rx error process, set hlpuart->RxState to Error */
-					hlpuart->RxState = HAL_LPUART_STATE_ERROR;
-					__HAL_UNLOCK(hlpuart);
-					return HAL_ERROR;		
-        }
-        else
-        {
-          *pData++ = (uint8_t)(hlpuart->Instance->SBUF & (uint8_t)0xFF);
-        }
-
+        return HAL_TIMEOUT;
       }
+			__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_RXNE); 
+
+			/* Parity is checked by the handler bound to the frame format at init */
+			error = hlpuart->RxByte(hlpuart->Instance, pData);
+			if(error != HAL_LPUART_ERROR_NONE)
+			{
+				/* Rx error process, set hlpuart->RxState to Error */
+				hlpuart->RxState = HAL_LPUART_STATE_ERROR;
+				hlpuart->ErrorCode = error;
+				__HAL_UNLOCK(hlpuart);
+				return HAL_ERROR;
+			}
+			pData++;
     }
 
     /* At end of Rx process, restore hlpuart->RxState to Ready */
@@ -573,28 +649,9 @@ HAL_StatusTypeDef HAL_LPUART_Transmit_IT(LPUART_HandleTypeDef *hlpuart, uint8_t
     /* Enable the LPUART Transmit data Complete Interrupt */
     __HAL_LPUART_ENABLE_IT(hlpuart, LPUART_IT_TC);
 	
-		if(hlpuart->Init.WordLength == LPUART_WORDLENGTH_9B)
-		{
-			if(hlpuart->Init.Parity == LPUART_PARITY_EVEN)
-			{
-				MODIFY_REG(hlpuart->Instance->SCON, LPUART_SCON_TB8, ((ParityTable256[*pData] & LPUART_BIT0_Msk) << LPUART_SCON_TB8_Pos));
-			}
-			else if(hlpuart->Init.Parity == LPUART_PARITY_ODD)
-			{
-				MODIFY_REG(hlpuart->Instance->SCON, LPUART_SCON_TB8, (((~ParityTable256[*pData]) & LPUART_BIT0_Msk) << LPUART_SCON_TB8_Pos));
-			}				
-			
-			hlpuart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);	
-			hlpuart->pTxBuffPtr = pData;
-			hlpuart->TxXferCount--;			
-		}
-		else
-		{
-			/* uart 8bit communication doesn't support parity transmit */
-			hlpuart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);
-			hlpuart->pTxBuffPtr = pData;
-			hlpuart->TxXferCount--;
-		}				
+		hlpuart->TxByte(hlpuart->Instance, *pData++);
+		hlpuart->pTxBuffPtr = pData;
+		hlpuart->TxXferCount--;
 		
     return HAL_OK;
   }
@@ -1034,23 +1091,7 @@ static HAL_StatusTypeDef LPUART_Transmit_IT(LPUART_HandleTypeDef *hlpuart)
 			return HAL_OK;			
     }		
 		
-    if(hlpuart->Init.WordLength == LPUART_WORDLENGTH_9B)
-    {			
-			if(hlpuart->Init.Parity == LPUART_PARITY_EVEN)
-			{
-				MODIFY_REG(hlpuart->Instance->SCON, LPUART_SCON_TB8, ((ParityTable256[*hlpuart->pTxBuffPtr] & LPUART_BIT0_Msk) << LPUART_SCON_TB8_Pos));
-			}
-			else if(hlpuart->Init.Parity == LPUART_PARITY_ODD)
-			{
-				MODIFY_REG(hlpuart->Instance->SCON, LPUART_SCON_TB8, (((~ParityTable256[*hlpuart->pTxBuffPtr]) & LPUART_BIT0_Msk) << LPUART_SCON_TB8_Pos));
-			}				
-			
-			hlpuart->Instance->SBUF = (*hlpuart->pTxBuffPtr++ & (uint8_t)0xFF);	
-    } 
-    else
-    {
-      hlpuart->Instance->SBUF = (uint8_t)(*hlpuart->pTxBuffPtr++ & (uint8_t)0xFF);
-    }
+    hlpuart->TxByte(hlpuart->Instance, *hlpuart->pTxBuffPtr++);
     return HAL_OK;
   }
   else
@@ -1069,63 +1110,21 @@ static HAL_StatusTypeDef LPUART_Transmit_IT(LPUART_HandleTypeDef *hlpuart)
   */
 static HAL_StatusTypeDef LPUART_Receive_IT(LPUART_HandleTypeDef *hlpuart)
 {
-  uint8_t tmp;
+  uint32_t error;
   
 	/* Check that a Rx process is ongoing */
   if(hlpuart->RxState == HAL_LPUART_STATE_BUSY_RX) 
   {
 		__HAL_LPUART_CLEAR_FLAG(hlpuart, LPUART_FLAG_RXNE);		
-    if(hlpuart->Init.WordLength == LPUART_WORDLENGTH_9B)
+    error = hlpuart->RxByte(hlpuart->Instance, hlpuart->pRxBuffPtr);
+    if(error != HAL_LPUART_ERROR_NONE)
     {
-      if(hlpuart->Init.Parity == LPUART_PARITY_NONE)
-      {
-        *hlpuart->pRxBuffPtr++ = (uint8_t)(hlpuart->Instance->SBUF & (uint8_t)0xFF);
-      }
-      else if(hlpuart->Init.Parity == LPUART_PARITY_EVEN)
-      {
-				tmp = (uint8_t)(hlpuart->Instance->SBUF & (uint8_t)0xFF);	
-				if((ParityTable256[tmp&((uint8_t)0xFF)]) == (((hlpuart->Instance->SCON & LPUART_SCON_RB8) >> LPUART_SCON_RB8_Pos) & LPUART_BIT0_Msk))	
-				{
-					*hlpuart->pRxBuffPtr++ = tmp&((uint8_t)0xFF);
-				}
-				else
-				{
-					/* Rx error process, set hlpuart->RxState to Error */
-					hlpuart->RxState = HAL_LPUART_STATE_ERROR;		
-					hlpuart->ErrorCode = HAL_LPUART_ERROR_PARITY;					
-					return HAL_ERROR;	
-				}					
-      }
-      else if(hlpuart->Init.Parity == LPUART_PARITY_ODD)
-      {
-				tmp = (uint8_t)(hlpuart->Instance->SBUF & (uint8_t)0xFF);	
-				if((ParityTable256[tmp&((uint8_t)0xFF)]) == ((~((hlpuart->Instance->SCON & LPUART_SCON_RB8) >> LPUART_SCON_RB8_Pos)) & LPUART_BIT0_Msk))	
-				{
-					*hlpuart->pRxBuffPtr++ = tmp&((uint8_t)0xFF);
-				}
-				else
-				{
-					/* Rx error process, set hlpuart->RxState to Error */
-					hlpuart->RxState = HAL_LPUART_STATE_ERROR;	
-					hlpuart->ErrorCode = HAL_LPUART_ERROR_PARITY;							
-					return HAL_ERROR;	
-				}					
-      }			
-    }
-    else
-    {
-      if(hlpuart->Init.Parity != LPUART_PARITY_NONE)
-      {
-				/* Rx error process, set hlpuart->RxState to Error */
-				hlpuart->RxState = HAL_LPUART_STATE_ERROR;
-				hlpuart->ErrorCode = HAL_LPUART_ERROR_CONFIG;						
-				return HAL_ERROR;				
-      }
-      else
-      {
-        *hlpuart->pRxBuffPtr++ = (uint8_t)(hlpuart->Instance->SBUF & (uint8_t)0xFF);
-      }
+			/* Rx error process, set hlpuart->RxState to Error */
+			hlpuart->RxState = HAL_LPUART_STATE_ERROR;		
+			hlpuart->ErrorCode = error;
+			return HAL_ERROR;	
     }
+    hlpuart->pRxBuffPtr++;
 
     if(--hlpuart->RxXferCount == 0U)
     {
@@ -1147,6 +1146,123 @@ static HAL_StatusTypeDef LPUART_Receive_IT(LPUART_HandleTypeDef *hlpuart)
   }
 }
 
+/**
+  * @brief  Binds the byte handlers matching Init.WordLength and Init.Parity, 
+  *         the transfer loops and interrupt handlers then never test the frame
+  *         format again.
+  * @note   8 bit frames can not carry a parity bit, the receiver reports a 
+  *         HAL_LPUART_ERROR_CONFIG error if a parity is requested. In 9 bit mode 
+  *         without parity TB8 is left to the application (multiprocessor mode).
+  * @param  hlpuart: pointer to a LPUART_HandleTypeDef structure that contains
+  *                the configuration information for the specified LPUART module.
+  * @retval None
+  */
+static void LPUART_SetByteHandlers(LPUART_HandleTypeDef *hlpuart)
+{
+  if((hlpuart->Init.WordLength == LPUART_WORDLENGTH_9B) && (hlpuart->Init.Parity == LPUART_PARITY_EVEN))
+  {
+    hlpuart->TxByte = LPUART_TxByte_Even;
+    hlpuart->RxByte = LPUART_RxByte_Even;
+  }
+  else if((hlpuart->Init.WordLength == LPUART_WORDLENGTH_9B) && (hlpuart->Init.Parity == LPUART_PARITY_ODD))
+  {
+    hlpuart->TxByte = LPUART_TxByte_Odd;
+    hlpuart->RxByte = LPUART_RxByte_Odd;
+  }
+  else
+  {
+    hlpuart->TxByte = LPUART_TxByte;
+    hlpuart->RxByte = (hlpuart->Init.Parity == LPUART_PARITY_NONE) ? LPUART_RxByte : LPUART_RxByte_Config;
+  }
+}
+
+/**
+  * @brief  Writes one byte, 8 bit frames or 9 bit frames without parity.
+  * @param  LPUARTx: LPUART registers base address
+  * @param  Data: byte to be sent
+  * @retval None
+  */
+static void LPUART_TxByte(LPUART_TypeDef *LPUARTx, uint8_t Data)
+{
+  LPUARTx->SBUF = Data;
+}
+
+/**
+  * @brief  Writes one byte with its even parity bit in TB8.
+  * @param  LPUARTx: LPUART registers base address
+  * @param  Data: byte to be sent
+  * @retval None
+  */
+static void LPUART_TxByte_Even(LPUART_TypeDef *LPUARTx, uint8_t Data)
+{
+  LPUARTx->SCON = (LPUARTx->SCON & ~LPUART_SCON_TB8) | ((uint32_t)ParityTable256[Data] << LPUART_SCON_TB8_Pos);
+  LPUARTx->SBUF = Data;
+}
+
+/**
+  * @brief  Writes one byte with its odd parity bit in TB8.
+  * @param  LPUARTx: LPUART registers base address
+  * @param  Data: byte to be sent
+  * @retval None
+  */
+static void LPUART_TxByte_Odd(LPUART_TypeDef *LPUARTx, uint8_t Data)
+{
+  LPUARTx->SCON = (LPUARTx->SCON & ~LPUART_SCON_TB8) | ((uint32_t)(ParityTable256[Data] ^ LPUART_BIT0_Msk) << LPUART_SCON_TB8_Pos);
+  LPUARTx->SBUF = Data;
+}
+
+/**
+  * @brief  Reads one byte, no parity check.
+  * @param  LPUARTx: LPUART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_LPUART_ERROR_NONE
+  */
+static uint32_t LPUART_RxByte(LPUART_TypeDef *LPUARTx, uint8_t *pData)
+{
+  *pData = (uint8_t)LPUARTx->SBUF;
+  return HAL_LPUART_ERROR_NONE;
+}
+
+/**
+  * @brief  Reads one byte and checks its even parity bit in RB8.
+  * @param  LPUARTx: LPUART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_LPUART_ERROR_NONE or HAL_LPUART_ERROR_PARITY
+  */
+static uint32_t LPUART_RxByte_Even(LPUART_TypeDef *LPUARTx, uint8_t *pData)
+{
+  uint8_t tmp = (uint8_t)LPUARTx->SBUF;
+
+  *pData = tmp;
+  return ((ParityTable256[tmp] ^ (LPUARTx->SCON >> LPUART_SCON_RB8_Pos)) & LPUART_BIT0_Msk) * HAL_LPUART_ERROR_PARITY;
+}
+
+/**
+  * @brief  Reads one byte and checks its odd parity bit in RB8.
+  * @param  LPUARTx: LPUART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_LPUART_ERROR_NONE or HAL_LPUART_ERROR_PARITY
+  */
+static uint32_t LPUART_RxByte_Odd(LPUART_TypeDef *LPUARTx, uint8_t *pData)
+{
+  uint8_t tmp = (uint8_t)LPUARTx->SBUF;
+
+  *pData = tmp;
+  return ((ParityTable256[tmp] ^ (LPUARTx->SCON >> LPUART_SCON_RB8_Pos) ^ LPUART_BIT0_Msk) & LPUART_BIT0_Msk) * HAL_LPUART_ERROR_PARITY;
+}
+
+/**
+  * @brief  Reads one byte of an unsupported frame format (parity on 8 bit frames).
+  * @param  LPUARTx: LPUART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_LPUART_ERROR_CONFIG
+  */
+static uint32_t LPUART_RxByte_Config(LPUART_TypeDef *LPUARTx, uint8_t *pData)
+{
+  *pData = (uint8_t)LPUARTx->SBUF;
+  return HAL_LPUART_ERROR_CONFIG;
+}
+
 /**
   * @brief  Configures the LPUART peripheral. 
   * @param  hlpuart: pointer to a LPUART_HandleTypeDef structure that contains
@@ -1198,6 +1314,9 @@ static void LPUART_SetConfig(LPUART_HandleTypeDef *hlpuart)
 	{
 		//In Lower Power mode, baudrate is fixed at Fsclk/(4*LPUART_SCON.PRSC), LPUART_BAUDCR is meaningless.	
 	}
+
+  /*-------------------------- Byte handlers ---------------------------------*/
+  LPUART_SetByteHandlers(hlpuart);
 }
 
 /**
@@ -46,6 +46,41 @@
         Send data
       (#)  When sending data continuously, starting from the second byte of data, 
            the received data must be read before each byte of data is send
+      [..]
+        Burst transfer
+      (#)  For blocks of data in master mode use the burst functions, NSS is driven
+           low once before the first byte and high once after the last byte:
+          (++) HAL_SPI_Master_Burst_TransmitReceive() full duplex, one byte is
+               received for each byte sent
+          (++) HAL_SPI_Master_Burst_Transmit() send only, the received bytes are discarded
+          (++) HAL_SPI_Master_Burst_Receive() receive only, a fill byte is sent
+      [..]
+        Interrupt transfer queue
+      (#)  Several devices may share the bus in master mode, each one described by a
+           SPI_DeviceTypeDef (GPIO chip select, clock polarity and phase, prescaler).
+           The chip select pins are configured as GPIO outputs, high, by the user.
+      (#)  Fill a SPI_TransferTypeDef per transfer and pass it to HAL_SPI_Master_Queue_IT(),
+           it is started at once when the bus is idle or appended to the queue.
+           The descriptor and its buffers must stay valid until its XferCpltCallback.
+      (#)  Call HAL_SPI_IRQHandler() from SPI_IRQHandler(). The SPI has no interrupt
+           enable bit, SPI_IRQn is enabled in the NVIC by the driver while the queue
+           is running and disabled again when it is empty, only its priority is set
+           in HAL_SPI_MspInit().
+      (#)  The blocking functions return HAL_BUSY while the queue is running.
+      [..]
+        Slave streaming
+      (#)  Initialize the SPI in slave mode and fill the Init part of a
+           SPI_SlaveStreamTypeDef with the receive ring, the optional transmit ring
+           (both sizes a power of two) and the Idle byte sent when there is nothing
+           to transmit, then call HAL_SPI_Slave_Stream_Start_IT().
+      (#)  Call HAL_SPI_IRQHandler() from SPI_IRQHandler(). Each SPIF stores the
+           received byte and preloads the next byte to send in the same interrupt.
+      (#)  Queue data to send with HAL_SPI_Slave_Stream_Write() and fetch the received
+           data with HAL_SPI_Slave_Stream_Read(), both return the number of bytes moved.
+           A full receive ring sets HAL_SPI_ERROR_OVR and drops the byte.
+      (#)  For frame boundaries configure the NSS pin interrupt on the rising edge as
+           well and call HAL_SPI_Slave_NSS_IRQHandler() from HAL_GPIO_EXTI_Callback(),
+           HAL_SPI_Slave_FrameCpltCallback() then gives the length of each frame.
 
   @endverbatim
 
@@ -95,9 +130,17 @@
 /* Private typedef -----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
 #define SPI_WAIT_TIMEOUT       1024    /*1s*/  
+#define SPI_BURST_SPIN         256U    /* SR polls before the tick timeout is checked */
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+static HAL_StatusTypeDef SPI_WaitSPIF(SPI_TypeDef *SPIx);
+static HAL_StatusTypeDef SPI_Burst(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint8_t Fill);
+static HAL_StatusTypeDef SPI_Burst_Start(SPI_HandleTypeDef *hspi, HAL_SPI_StateTypeDef State);
+static void SPI_Burst_End(SPI_HandleTypeDef *hspi);
+static void SPI_Queue_Start(SPI_HandleTypeDef *hspi, SPI_TransferTypeDef *pXfer);
+static void SPI_Queue_IT(SPI_HandleTypeDef *hspi);
+static void SPI_Slave_IT(SPI_HandleTypeDef *hspi);
 
 /* Exported functions --------------------------------------------------------*/
 /** @defgroup SPI_Exported_Functions SPI Exported Functions
@@ -172,6 +215,11 @@ HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
  /* Enable the selected SPI peripheral */
   __HAL_SPI_ENABLE(hspi);
 
+  hspi->pXferHead = NULL;
+  hspi->pXferTail = NULL;
+  hspi->pDevice = NULL;
+  hspi->pSlave = NULL;
+
   hspi->State = HAL_SPI_STATE_READY;
 
   return HAL_OK;
@@ -199,6 +247,10 @@ HAL_StatusTypeDef HAL_SPI_DeInit(SPI_HandleTypeDef *hspi)
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC... */
   HAL_SPI_MspDeInit(hspi);
 
+  hspi->pXferHead = NULL;
+  hspi->pXferTail = NULL;
+  hspi->pDevice = NULL;
+  hspi->pSlave = NULL;
   hspi->ErrorCode = HAL_SPI_ERROR_NONE;
   hspi->State = HAL_SPI_STATE_RESET;
   /* Release Lock */
@@ -257,6 +309,24 @@ __weak void HAL_SPI_MspDeInit(SPI_HandleTypeDef *hspi)
     (#) APIs provided for these 2 transfer modes (send data or receive data )
          2Lines (full duplex) modes.
 
+    (#) Blocking burst APIs for the master mode, the whole transfer is done
+        with NSS low and without any per byte function call:
+        (++) HAL_SPI_Master_Burst_TransmitReceive()
+        (++) HAL_SPI_Master_Burst_Transmit()
+        (++) HAL_SPI_Master_Burst_Receive()
+
+    (#) Non-blocking queue for the master mode, the transfers are moved byte by
+        byte from the SPI interrupt and each one has its completion callback:
+        (++) HAL_SPI_Master_Queue_IT()
+        (++) HAL_SPI_IRQHandler()
+
+    (#) Non-blocking streaming for the slave mode through receive and transmit rings:
+        (++) HAL_SPI_Slave_Stream_Start_IT()
+        (++) HAL_SPI_Slave_Stream_Stop_IT()
+        (++) HAL_SPI_Slave_Stream_Write()
+        (++) HAL_SPI_Slave_Stream_Read()
+        (++) HAL_SPI_Slave_NSS_IRQHandler()
+
 @endverbatim
   * @{
   */
@@ -361,26 +431,119 @@ HAL_StatusTypeDef HAL_SPI_Master_Send_Data(SPI_HandleTypeDef *hspi, uint8_t TxDa
   */
 HAL_StatusTypeDef HAL_SPI_Master_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint16_t TxSize,uint8_t *pRxData, uint16_t RxSize)
 {
-	uint16_t count = 0;
-	uint8_t data = 0;
-	HAL_SPI_Set_NSS(hspi,SPI_NSS_MODE_LOW);
-	
-	for(count = 0;count < TxSize; count++)
-	{
-		HAL_SPI_Master_Send_Data(hspi, pTxData[count]);
-		HAL_SPI_Master_Receive_Data(hspi, &data);
-	}
+  HAL_StatusTypeDef status;
 
-	data = 0;
-	for(count = 0;count < RxSize; count++)
-	{
-		HAL_SPI_Master_Send_Data(hspi, data);
-		HAL_SPI_Master_Receive_Data(hspi, &pRxData[count]);
-	}
-	
-	HAL_SPI_Set_NSS(hspi,SPI_NSS_MODE_HIGH);
-	
-	return HAL_OK;
+  if(((pTxData == NULL) && (TxSize != 0U)) || ((pRxData == NULL) && (RxSize != 0U)))
+  {
+    return HAL_ERROR;
+  }
+
+  status = SPI_Burst_Start(hspi, HAL_SPI_STATE_BUSY_TX_RX);
+  if(status != HAL_OK)
+  {
+    return status;
+  }
+
+  /* Command phase, the received bytes are discarded */
+  status = SPI_Burst(hspi, pTxData, NULL, TxSize, 0x00U);
+  if(status == HAL_OK)
+  {
+    /* Data phase, 0x00 is sent for each received byte */
+    status = SPI_Burst(hspi, NULL, pRxData, RxSize, 0x00U);
+  }
+
+  SPI_Burst_End(hspi);
+
+  return status;
+}
+
+/**
+  * @brief  Full duplex burst transfer in blocking mode, one byte is received
+  *         for each byte sent.
+  * @note   NSS is driven low before the first byte and high after the last byte.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pTxData pointer to transmission data buffer
+  * @param  pRxData pointer to reception data buffer, may be the same as pTxData
+  * @param  Size amount of data to be sent and received
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_Master_Burst_TransmitReceive(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData, uint16_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  if((pTxData == NULL) || (pRxData == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  status = SPI_Burst_Start(hspi, HAL_SPI_STATE_BUSY_TX_RX);
+  if(status == HAL_OK)
+  {
+    status = SPI_Burst(hspi, pTxData, pRxData, Size, 0x00U);
+    SPI_Burst_End(hspi);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Transmit only burst transfer in blocking mode, the received
+  *         bytes are discarded.
+  * @note   NSS is driven low before the first byte and high after the last byte.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pTxData pointer to transmission data buffer
+  * @param  Size amount of data to be sent
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_Master_Burst_Transmit(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint16_t Size)
+{
+  HAL_StatusTypeDef status;
+
+  if((pTxData == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  status = SPI_Burst_Start(hspi, HAL_SPI_STATE_BUSY_TX);
+  if(status == HAL_OK)
+  {
+    status = SPI_Burst(hspi, pTxData, NULL, Size, 0x00U);
+    SPI_Burst_End(hspi);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Receive only burst transfer in blocking mode, the Fill byte is
+  *         sent to clock in each received byte.
+  * @note   NSS is driven low before the first byte and high after the last byte.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pRxData pointer to reception data buffer
+  * @param  Size amount of data to be received
+  * @param  Fill byte sent on MOSI while receiving, usually 0x00 or 0xFF
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_Master_Burst_Receive(SPI_HandleTypeDef *hspi, uint8_t *pRxData, uint16_t Size, uint8_t Fill)
+{
+  HAL_StatusTypeDef status;
+
+  if((pRxData == NULL) || (Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  status = SPI_Burst_Start(hspi, HAL_SPI_STATE_BUSY_RX);
+  if(status == HAL_OK)
+  {
+    status = SPI_Burst(hspi, NULL, pRxData, Size, Fill);
+    SPI_Burst_End(hspi);
+  }
+
+  return status;
 }
 
 
@@ -420,6 +583,296 @@ void LL_SPI_Master_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, ui
 	hspi->Instance->SSN = SPI_NSS_MODE_HIGH;
 	
 }
+/**
+  * @brief  Queue a transfer to be done in interrupt mode.
+  * @note   The transfer is started at once when the bus is idle, else it is
+  *         appended to the queue. May be called from a transfer callback.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pXfer pointer to the transfer descriptor, it must stay valid
+  *               until its XferCpltCallback is called
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_Master_Queue_IT(SPI_HandleTypeDef *hspi, SPI_TransferTypeDef *pXfer)
+{
+  uint32_t primask;
+
+  if((pXfer == NULL) || (pXfer->pDevice == NULL) || (pXfer->Size == 0U))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Check the parameters */
+  assert_param(IS_SPI_CPOL(pXfer->pDevice->CLKPolarity));
+  assert_param(IS_SPI_CPHA(pXfer->pDevice->CLKPhase));
+  assert_param(IS_SPI_BAUDRATE_PRESCALER(pXfer->pDevice->BaudRatePrescaler));
+
+  pXfer->pNext = NULL;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+
+  if(hspi->pXferHead != NULL)
+  {
+    hspi->pXferTail->pNext = pXfer;
+    hspi->pXferTail = pXfer;
+  }
+  else if((hspi->State == HAL_SPI_STATE_READY) && (hspi->Lock == HAL_UNLOCKED))
+  {
+    hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+    hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+    hspi->pXferHead = pXfer;
+    hspi->pXferTail = pXfer;
+
+    /* A byte left unread by a previous single byte transfer would raise
+       the interrupt at once, reading DATA clears SPIF */
+    if((hspi->Instance->SR & SPI_FLAG_SPIF) != 0U)
+    {
+      (void)hspi->Instance->DATA;
+    }
+    HAL_NVIC_ClearPendingIRQ(SPI_IRQn);
+    HAL_NVIC_EnableIRQ(SPI_IRQn);
+
+    SPI_Queue_Start(hspi, pXfer);
+  }
+  else
+  {
+    __set_PRIMASK(primask);
+    return HAL_BUSY;
+  }
+
+  __set_PRIMASK(primask);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Handle SPI interrupt request.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @retval None
+  */
+void HAL_SPI_IRQHandler(SPI_HandleTypeDef *hspi)
+{
+  if(hspi->pSlave != NULL)
+  {
+    SPI_Slave_IT(hspi);
+  }
+  else if(hspi->pXferHead != NULL)
+  {
+    SPI_Queue_IT(hspi);
+  }
+}
+
+/**
+  * @brief  Start slave streaming in interrupt mode.
+  * @note   The first byte of the transmit ring, or Idle, is loaded at once.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  hstream pointer to the stream context, its Init part filled,
+  *               it must stay valid until HAL_SPI_Slave_Stream_Stop_IT()
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_Slave_Stream_Start_IT(SPI_HandleTypeDef *hspi, SPI_SlaveStreamTypeDef *hstream)
+{
+  if((hstream == NULL) || (hstream->Init.pRxBuffer == NULL) || !IS_SPI_RING_SIZE(hstream->Init.RxSize) ||
+     ((hstream->Init.pTxBuffer != NULL) && !IS_SPI_RING_SIZE(hstream->Init.TxSize)) ||
+     (hspi->Init.Mode != SPI_MODE_SLAVE))
+  {
+    return HAL_ERROR;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(hspi);
+
+  if(hspi->State != HAL_SPI_STATE_READY)
+  {
+    __HAL_UNLOCK(hspi);
+    return HAL_BUSY;
+  }
+  hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+  hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+
+  hstream->RxRing.pBuffer = hstream->Init.pRxBuffer;
+  hstream->RxRing.Mask = hstream->Init.RxSize - 1U;
+  hstream->RxRing.Head = 0U;
+  hstream->RxRing.Tail = 0U;
+  /* Without a transmit buffer Head == Tail always and Idle is sent */
+  hstream->TxRing.pBuffer = hstream->Init.pTxBuffer;
+  hstream->TxRing.Mask = (hstream->Init.pTxBuffer != NULL) ? (hstream->Init.TxSize - 1U) : 0U;
+  hstream->TxRing.Head = 0U;
+  hstream->TxRing.Tail = 0U;
+  hstream->FrameLength = 0U;
+
+  if((hspi->Instance->SR & SPI_FLAG_SPIF) != 0U)
+  {
+    (void)hspi->Instance->DATA;
+  }
+  hspi->Instance->DATA = hstream->Init.Idle;
+
+  hspi->pSlave = hstream;
+  HAL_NVIC_ClearPendingIRQ(SPI_IRQn);
+  HAL_NVIC_EnableIRQ(SPI_IRQn);
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(hspi);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stop slave streaming.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_SPI_Slave_Stream_Stop_IT(SPI_HandleTypeDef *hspi)
+{
+  if(hspi->pSlave == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  HAL_NVIC_DisableIRQ(SPI_IRQn);
+  hspi->pSlave = NULL;
+  hspi->State = HAL_SPI_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queue bytes to be sent by the slave stream.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pData pointer to the data to send
+  * @param  Size number of bytes
+  * @retval Number of bytes queued, less than Size when the transmit ring is full,
+  *         0 when the slave stream is not started
+  */
+uint16_t HAL_SPI_Slave_Stream_Write(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size)
+{
+  SPI_RingTypeDef *ring;
+  uint16_t head;
+  uint16_t count;
+  uint16_t i;
+
+  if((hspi->pSlave == NULL) || (hspi->pSlave->TxRing.pBuffer == NULL))
+  {
+    return 0U;
+  }
+  ring = &hspi->pSlave->TxRing;
+  head = ring->Head;
+
+  count = (uint16_t)(ring->Mask + 1U - (uint16_t)(head - ring->Tail));
+  if(count > Size)
+  {
+    count = Size;
+  }
+  for(i = 0U; i < count; i++)
+  {
+    ring->pBuffer[(uint16_t)(head + i) & ring->Mask] = pData[i];
+  }
+
+  /* Publish the bytes only once they are stored */
+  __DMB();
+  ring->Head = head + count;
+
+  return count;
+}
+
+/**
+  * @brief  Copy the oldest bytes received by the slave stream.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pData destination
+  * @param  Size maximum number of bytes to copy
+  * @retval Number of bytes copied, 0 when the slave stream is not started
+  */
+uint16_t HAL_SPI_Slave_Stream_Read(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size)
+{
+  SPI_RingTypeDef *ring;
+  uint16_t tail;
+  uint16_t count;
+  uint16_t i;
+
+  if(hspi->pSlave == NULL)
+  {
+    return 0U;
+  }
+  ring = &hspi->pSlave->RxRing;
+  tail = ring->Tail;
+  count = (uint16_t)(ring->Head - tail);
+
+  if(count > Size)
+  {
+    count = Size;
+  }
+  for(i = 0U; i < count; i++)
+  {
+    pData[i] = ring->pBuffer[(uint16_t)(tail + i) & ring->Mask];
+  }
+
+  /* Release the slots only once they are copied */
+  __DMB();
+  ring->Tail = tail + count;
+
+  return count;
+}
+
+/**
+  * @brief  Handle the NSS rising edge, the end of a slave frame.
+  * @note   To be called from the GPIO interrupt of the NSS pin. A byte whose
+  *         SPIF is still pending is stored first, so the frame length is right
+  *         whatever the priority of the GPIO interrupt.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @retval None
+  */
+void HAL_SPI_Slave_NSS_IRQHandler(SPI_HandleTypeDef *hspi)
+{
+  SPI_SlaveStreamTypeDef *hstream = hspi->pSlave;
+  uint32_t primask;
+  uint16_t length;
+
+  if(hstream == NULL)
+  {
+    return;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if((hspi->Instance->SR & SPI_FLAG_SPIF) != 0U)
+  {
+    SPI_Slave_IT(hspi);
+    HAL_NVIC_ClearPendingIRQ(SPI_IRQn);
+  }
+  length = hstream->FrameLength;
+  hstream->FrameLength = 0U;
+  __set_PRIMASK(primask);
+
+  if(length != 0U)
+  {
+    HAL_SPI_Slave_FrameCpltCallback(hspi, length);
+  }
+}
+
+/**
+  * @brief  Slave frame complete callback.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  Length number of bytes exchanged while NSS was low
+  * @retval None
+  */
+__weak void HAL_SPI_Slave_FrameCpltCallback(SPI_HandleTypeDef *hspi, uint16_t Length)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(hspi);
+  UNUSED(Length);
+  /* NOTE : This function should not be modified, when the callback is needed,
+            the HAL_SPI_Slave_FrameCpltCallback should be implemented in the user file
+  */
+}
+
 /**
   * @brief  Slave Receive one data .
   * @param  hspi: pointer to a SPI_HandleTypeDef structure that contains
@@ -549,6 +1002,306 @@ uint32_t  HAL_SPI_Get_ErrorFlags(SPI_HandleTypeDef *hspi)
   * @}
   */
 
+/**
+  * @}
+  */
+
+/** @defgroup SPI_Private_Functions SPI Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Wait for SPIF with the SPI_WAIT_TIMEOUT tick timeout.
+  * @param  SPIx SPI registers base address
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPI_WaitSPIF(SPI_TypeDef *SPIx)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while((SPIx->SR & SPI_FLAG_SPIF) == 0U)
+  {
+    if((HAL_GetTick() - tickstart) > SPI_WAIT_TIMEOUT)
+    {
+      return HAL_TIMEOUT;
+    }
+  }
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Lock the handle and drive NSS low for a burst transaction.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  State busy state of the transaction
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPI_Burst_Start(SPI_HandleTypeDef *hspi, HAL_SPI_StateTypeDef State)
+{
+  /* Process Locked */
+  __HAL_LOCK(hspi);
+
+  if(hspi->State != HAL_SPI_STATE_READY)
+  {
+    __HAL_UNLOCK(hspi);
+    return HAL_BUSY;
+  }
+  hspi->State = State;
+  hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+
+  /* A byte left unread by a previous single byte transfer would be taken
+     as the first received byte, reading DATA clears SPIF */
+  if((hspi->Instance->SR & SPI_FLAG_SPIF) != 0U)
+  {
+    (void)hspi->Instance->DATA;
+  }
+
+  hspi->Instance->SSN = SPI_NSS_MODE_LOW;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Drive NSS high and release the handle at the end of a burst transaction.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @retval None
+  */
+static void SPI_Burst_End(SPI_HandleTypeDef *hspi)
+{
+  hspi->Instance->SSN = SPI_NSS_MODE_HIGH;
+
+  hspi->State = HAL_SPI_STATE_READY;
+  /* Process Unlocked */
+  __HAL_UNLOCK(hspi);
+}
+
+/**
+  * @brief  Program the device settings, select it and send the first byte of a queued transfer.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pXfer pointer to the transfer descriptor
+  * @retval None
+  */
+static void SPI_Queue_Start(SPI_HandleTypeDef *hspi, SPI_TransferTypeDef *pXfer)
+{
+  SPI_DeviceTypeDef *pDevice = pXfer->pDevice;
+
+  /* CR is only rewritten when the device changes */
+  if(pDevice != hspi->pDevice)
+  {
+    __HAL_SPI_DISABLE(hspi);
+    WRITE_REG(hspi->Instance->CR, (SPI_MODE_MASTER | pDevice->CLKPolarity | pDevice->CLKPhase | pDevice->BaudRatePrescaler));
+    __HAL_SPI_ENABLE(hspi);
+    hspi->pDevice = pDevice;
+  }
+
+  pDevice->CsPort->ODCLR = pDevice->CsPin;
+
+  hspi->pTxBuffPtr = pXfer->pTxData;
+  hspi->pRxBuffPtr = pXfer->pRxData;
+  hspi->XferCount = pXfer->Size;
+
+  if(hspi->pTxBuffPtr != NULL)
+  {
+    hspi->Instance->DATA = *hspi->pTxBuffPtr++;
+  }
+  else
+  {
+    hspi->Instance->DATA = pXfer->Fill;
+  }
+}
+
+/**
+  * @brief  Queue interrupt routine, one byte per SPIF.
+  * @note   The next byte is written as soon as the received one is read so
+  *         that the bus is idle for the shortest time. At the end of a transfer
+  *         the next one is started before the callback of the finished one.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @retval None
+  */
+static void SPI_Queue_IT(SPI_HandleTypeDef *hspi)
+{
+  SPI_TransferTypeDef *pXfer = hspi->pXferHead;
+  uint8_t data;
+
+  /* Reading DATA clears SPIF */
+  data = (uint8_t)hspi->Instance->DATA;
+
+  if(--hspi->XferCount != 0U)
+  {
+    if(hspi->pTxBuffPtr != NULL)
+    {
+      hspi->Instance->DATA = *hspi->pTxBuffPtr++;
+    }
+    else
+    {
+      hspi->Instance->DATA = pXfer->Fill;
+    }
+    if(hspi->pRxBuffPtr != NULL)
+    {
+      *hspi->pRxBuffPtr++ = data;
+    }
+    return;
+  }
+
+  if(hspi->pRxBuffPtr != NULL)
+  {
+    *hspi->pRxBuffPtr = data;
+  }
+  pXfer->pDevice->CsPort->ODSET = pXfer->pDevice->CsPin;
+
+  hspi->pXferHead = pXfer->pNext;
+  if(hspi->pXferHead != NULL)
+  {
+    SPI_Queue_Start(hspi, hspi->pXferHead);
+  }
+  else
+  {
+    hspi->pXferTail = NULL;
+    HAL_NVIC_DisableIRQ(SPI_IRQn);
+
+    /* Restore the Init settings for the blocking functions */
+    __HAL_SPI_DISABLE(hspi);
+    WRITE_REG(hspi->Instance->CR, (hspi->Init.Mode | hspi->Init.CLKPolarity | hspi->Init.CLKPhase | hspi->Init.BaudRatePrescaler));
+    __HAL_SPI_ENABLE(hspi);
+    hspi->pDevice = NULL;
+
+    hspi->State = HAL_SPI_STATE_READY;
+  }
+
+  if(pXfer->XferCpltCallback != NULL)
+  {
+    pXfer->XferCpltCallback(hspi, pXfer);
+  }
+}
+
+/**
+  * @brief  Slave stream interrupt routine, one byte per SPIF.
+  * @note   The next byte to send is written right after the received one is
+  *         read, before it is stored, as the master may clock it at once.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @retval None
+  */
+static void SPI_Slave_IT(SPI_HandleTypeDef *hspi)
+{
+  SPI_SlaveStreamTypeDef *hstream = hspi->pSlave;
+  SPI_RingTypeDef *ring;
+  uint16_t index;
+  uint8_t data;
+
+  /* Reading DATA clears SPIF */
+  data = (uint8_t)hspi->Instance->DATA;
+
+  ring = &hstream->TxRing;
+  index = ring->Tail;
+  if(index != ring->Head)
+  {
+    hspi->Instance->DATA = ring->pBuffer[index & ring->Mask];
+    ring->Tail = index + 1U;
+  }
+  else
+  {
+    hspi->Instance->DATA = hstream->Init.Idle;
+  }
+
+  ring = &hstream->RxRing;
+  index = ring->Head;
+  if((uint16_t)(index - ring->Tail) <= ring->Mask)
+  {
+    ring->pBuffer[index & ring->Mask] = data;
+    /* Make the byte visible before publishing the new head */
+    __DMB();
+    ring->Head = index + 1U;
+  }
+  else
+  {
+    hspi->ErrorCode |= HAL_SPI_ERROR_OVR;
+  }
+
+  hstream->FrameLength++;
+}
+
+/**
+  * @brief  Burst transfer inner loop.
+  * @note   Each mode has its own loop so that the per byte work is only
+  *         DATA write, SR poll, DATA read. SR is polled back to back and the
+  *         tick timeout is only checked when SPIF is late by SPI_BURST_SPIN polls.
+  * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+  *               the configuration information for SPI module.
+  * @param  pTxData transmission buffer, NULL to send Fill
+  * @param  pRxData reception buffer, NULL to discard the received bytes
+  * @param  Size amount of data
+  * @param  Fill byte sent when pTxData is NULL
+  * @retval HAL status
+  */
+static HAL_StatusTypeDef SPI_Burst(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint8_t Fill)
+{
+  SPI_TypeDef *SPIx = hspi->Instance;
+  const uint8_t *pEnd;
+  uint32_t spin;
+
+  if(pRxData == NULL)
+  {
+    pEnd = pTxData + Size;
+    while(pTxData != pEnd)
+    {
+      SPIx->DATA = *pTxData++;
+      spin = SPI_BURST_SPIN;
+      while((SPIx->SR & SPI_FLAG_SPIF) == 0U)
+      {
+        if((--spin == 0U) && (SPI_WaitSPIF(SPIx) != HAL_OK))
+        {
+          hspi->ErrorCode |= HAL_SPI_ERROR_FLAG;
+          return HAL_TIMEOUT;
+        }
+      }
+      (void)SPIx->DATA;
+    }
+  }
+  else if(pTxData == NULL)
+  {
+    pEnd = pRxData + Size;
+    while(pRxData != pEnd)
+    {
+      SPIx->DATA = Fill;
+      spin = SPI_BURST_SPIN;
+      while((SPIx->SR & SPI_FLAG_SPIF) == 0U)
+      {
+        if((--spin == 0U) && (SPI_WaitSPIF(SPIx) != HAL_OK))
+        {
+          hspi->ErrorCode |= HAL_SPI_ERROR_FLAG;
+          return HAL_TIMEOUT;
+        }
+      }
+      *pRxData++ = (uint8_t)SPIx->DATA;
+    }
+  }
+  else
+  {
+    pEnd = pTxData + Size;
+    while(pTxData != pEnd)
+    {
+      SPIx->DATA = *pTxData++;
+      spin = SPI_BURST_SPIN;
+      while((SPIx->SR & SPI_FLAG_SPIF) == 0U)
+      {
+        if((--spin == 0U) && (SPI_WaitSPIF(SPIx) != HAL_OK))
+        {
+          hspi->ErrorCode |= HAL_SPI_ERROR_FLAG;
+          return HAL_TIMEOUT;
+        }
+      }
+      *pRxData++ = (uint8_t)SPIx->DATA;
+    }
+  }
+
+  return HAL_OK;
+}
+
 /**
   * @}
   */
@@ -30,6 +30,7 @@
   *           + Stop the Complementary PWM.
   *           + Start the Complementary PWM and enable interrupts.
   *           + Stop the Complementary PWM and disable interrupts.	
+  *           + PWM sequencer, CCRx written from sample tables on update events
   @verbatim
   ==============================================================================
                       ##### TIMER Generic features #####
@@ -86,6 +87,8 @@
            (++) Input Capture :  HAL_TIM_IC_Start(), HAL_TIM_IC_Start_IT()
            (++) Output Compare : HAL_TIM_OC_Start(), HAL_TIM_OC_Start_IT()
            (++) PWM generation : HAL_TIM_PWM_Start()
+           (++) PWM sequencer : HAL_TIM_PWM_Start() or HAL_TIM_PWMN_Start() on each
+                channel, then HAL_TIM_PWMSeq_Start_IT()
            (++) One-pulse mode output : HAL_TIM_OnePulse_Start(), HAL_TIM_OnePulse_Start_IT()
            (++) Encoder mode output : HAL_TIM_Encoder_Start(), HAL_TIM_Encoder_Start_IT().
 
@@ -96,6 +99,9 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "cx32l003_hal.h"
+#if defined(ARM_MATH_CM0PLUS)
+#include "arm_math.h"
+#endif
 
 /** @addtogroup CX32L003_HAL_Driver
   * @{
@@ -129,6 +135,7 @@ static void TIM_ETR_SetConfig(TIM_TypeDef* TIMx, uint32_t TIM_ExtTRGPrescaler, u
 static void TIM_ITRx_SetConfig(TIM_TypeDef* TIMx, uint16_t InputTriggerSource);
 static void TIM_SlaveTimer_SetConfig(TIM_HandleTypeDef *htim, TIM_SlaveConfigTypeDef * sSlaveConfig);
 static void TIM_CCxNChannelCmd(TIM_TypeDef* TIMx, uint32_t Channel, uint32_t ChannelNState);
+static void TIM_PWMSeq_TableEnd(TIM_HandleTypeDef *htim);
 
 /**
   * @}
@@ -188,6 +195,8 @@ HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim)
     /* Allocate lock resource and initialize it */
     htim->Lock = HAL_UNLOCKED;
     
+    htim->pPWMSeq = NULL;
+    
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     HAL_TIM_Base_MspInit(htim);
   }
@@ -222,6 +231,8 @@ HAL_StatusTypeDef HAL_TIM_Base_DeInit(TIM_HandleTypeDef *htim)
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_Base_MspDeInit(htim);
 
+  htim->pPWMSeq = NULL;
+
   /* Change TIM state */
   htim->State = HAL_TIM_STATE_RESET;
 
@@ -399,6 +410,8 @@ HAL_StatusTypeDef HAL_TIM_OC_Init(TIM_HandleTypeDef* htim)
     /* Allocate lock resource and initialize it */
     htim->Lock = HAL_UNLOCKED;
     
+    htim->pPWMSeq = NULL;
+    
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     HAL_TIM_OC_MspInit(htim);
   }
@@ -433,6 +446,8 @@ HAL_StatusTypeDef HAL_TIM_OC_DeInit(TIM_HandleTypeDef *htim)
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC*/
   HAL_TIM_OC_MspDeInit(htim);
 
+  htim->pPWMSeq = NULL;
+
   /* Change TIM state */
   htim->State = HAL_TIM_STATE_RESET;
 
@@ -690,6 +705,7 @@ HAL_StatusTypeDef HAL_TIM_OC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
     (+) Stop the Complementary PWM.
     (+) Start the Complementary PWM and enable interrupts.
     (+) Stop the Complementary PWM and disable interrupts.
+    (+) Play PWM sample tables on update events (PWM sequencer).
 
 @endverbatim
   * @{
@@ -723,6 +739,8 @@ HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim)
     /* Allocate lock resource and initialize it */
     htim->Lock = HAL_UNLOCKED;
     
+    htim->pPWMSeq = NULL;
+
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     HAL_TIM_PWM_MspInit(htim);
   }
@@ -757,6 +775,8 @@ HAL_StatusTypeDef HAL_TIM_PWM_DeInit(TIM_HandleTypeDef *htim)
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_PWM_MspDeInit(htim);
 
+  htim->pPWMSeq = NULL;
+
   /* Change TIM state */
   htim->State = HAL_TIM_STATE_RESET;
 
@@ -1176,6 +1196,217 @@ HAL_StatusTypeDef HAL_TIM_PWMN_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel
   return HAL_OK;
 }
 
+/**
+  * @brief  Starts the PWM sequencer, the CCRx of the sequenced channels are
+  *         written from pTable, one step per update event.
+  * @note   The channels are configured by HAL_TIM_PWM_ConfigChannel(), which
+  *         enables the CCRx preload, and their outputs are started by
+  *         HAL_TIM_PWM_Start() or HAL_TIM_PWMN_Start(). The update interrupt
+  *         writes each step one update event ahead, so a step takes effect on
+  *         a period boundary. hseq and the tables must stay valid until
+  *         HAL_TIM_PWMSeq_Stop_IT() or the end of a single table.
+  * @param  htim : TIM PWM handle
+  * @param  hseq : sequencer context with its Init field filled
+  * @param  pTable : Length steps of one sample per sequenced channel
+  * @param  Length : number of steps
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_TIM_PWMSeq_Start_IT(TIM_HandleTypeDef *htim, TIM_PWMSeqTypeDef *hseq, const uint16_t *pTable, uint16_t Length)
+{
+  uint32_t channel;
+  uint32_t count = 0U;
+
+  /* Check the parameters */
+  assert_param(IS_TIM_INSTANCE(htim->Instance));
+
+  if((hseq == NULL) || (pTable == NULL) || (Length == 0U) ||
+     !IS_TIM_PWMSEQ_CHANNELS(hseq->Init.Channels) || !IS_TIM_PWMSEQ_MODE(hseq->Init.Mode))
+  {
+    return HAL_ERROR;
+  }
+  if(htim->pPWMSeq != NULL)
+  {
+    return HAL_BUSY;
+  }
+
+  __HAL_LOCK(htim);
+
+  for(channel = 0U; channel < 4U; channel++)
+  {
+    if((hseq->Init.Channels & (1UL << channel)) != 0U)
+    {
+      hseq->pCCR[count++] = &htim->Instance->CCR1 + channel;
+    }
+  }
+  hseq->ChannelCount = count;
+  hseq->pTable = pTable;
+  hseq->pSample = pTable;
+  hseq->pEnd = pTable + ((uint32_t)Length * count);
+  hseq->pNextTable = NULL;
+  hseq->NextLength = 0U;
+
+  __HAL_TIM_DISABLE_IT(htim, TIM_IT_UPDATE);
+  htim->pPWMSeq = hseq;
+
+  /* First step loaded now by an update event, the second one is preloaded */
+  HAL_TIM_PWMSeq_IRQHandler(htim);
+  htim->Instance->EGR = TIM_EGR_UG;
+  if(htim->pPWMSeq != NULL)
+  {
+    HAL_TIM_PWMSeq_IRQHandler(htim);
+  }
+  __HAL_TIM_CLEAR_IT(htim, TIM_IT_UPDATE);
+
+  if(htim->pPWMSeq != NULL)
+  {
+    __HAL_TIM_ENABLE_IT(htim, TIM_IT_UPDATE);
+  }
+  __HAL_TIM_ENABLE(htim);
+
+  __HAL_UNLOCK(htim);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Stops the PWM sequencer, the outputs keep the last step written.
+  * @param  htim : TIM PWM handle
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_TIM_PWMSeq_Stop_IT(TIM_HandleTypeDef *htim)
+{
+  /* Check the parameters */
+  assert_param(IS_TIM_INSTANCE(htim->Instance));
+
+  __HAL_LOCK(htim);
+
+  __HAL_TIM_DISABLE_IT(htim, TIM_IT_UPDATE);
+  __HAL_TIM_CLEAR_IT(htim, TIM_IT_UPDATE);
+  htim->pPWMSeq = NULL;
+
+  __HAL_UNLOCK(htim);
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queues the table played after the current one.
+  * @note   The switch happens on the step boundary that ends the current table,
+  *         without glitch, then HAL_TIM_PWMSeq_TableCpltCallback() reports the
+  *         completed table, which may be refilled and queued again (ping pong).
+  * @param  htim : TIM PWM handle
+  * @param  pTable : Length steps of one sample per sequenced channel
+  * @param  Length : number of steps
+  * @retval HAL status, HAL_BUSY while a table is already queued
+  */
+HAL_StatusTypeDef HAL_TIM_PWMSeq_Queue(TIM_HandleTypeDef *htim, const uint16_t *pTable, uint16_t Length)
+{
+  TIM_PWMSeqTypeDef *hseq = htim->pPWMSeq;
+
+  if((hseq == NULL) || (pTable == NULL) || (Length == 0U))
+  {
+    return HAL_ERROR;
+  }
+  if(hseq->pNextTable != NULL)
+  {
+    return HAL_BUSY;
+  }
+
+  /* The interrupt takes the table once the pointer is set */
+  hseq->NextLength = Length;
+  hseq->pNextTable = pTable;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  PWM sequencer update interrupt, writes the next step.
+  * @note   Called by HAL_TIM_IRQHandler(). For the shortest path, the TIMx IRQ
+  *         handler may call it alone when only the update interrupt is used.
+  *         It costs about 45 cycles for 4 channels, about 80 with the
+  *         exception entry and exit (estimated from the instruction count,
+  *         no flash wait state), so at 24 MHz the CPU is saturated near
+  *         300 kHz of update events: keep them below about 100 kHz (a third
+  *         of the CPU) and use Init.RepetitionCounter on TIM1 to hold each
+  *         step for several PWM periods.
+  * @param  htim : TIM PWM handle
+  * @retval None
+  */
+void HAL_TIM_PWMSeq_IRQHandler(TIM_HandleTypeDef *htim)
+{
+  TIM_PWMSeqTypeDef *hseq = htim->pPWMSeq;
+  const uint16_t *sample = hseq->pSample;
+
+  htim->Instance->SR = ~TIM_SR_UIF;
+
+  switch(hseq->ChannelCount)
+  {
+    case 4U:
+      *hseq->pCCR[3] = sample[3];
+      /* fall through */
+    case 3U:
+      *hseq->pCCR[2] = sample[2];
+      /* fall through */
+    case 2U:
+      *hseq->pCCR[1] = sample[1];
+      /* fall through */
+    default:
+      *hseq->pCCR[0] = sample[0];
+    break;
+  }
+
+  sample += hseq->ChannelCount;
+  if(sample != hseq->pEnd)
+  {
+    hseq->pSample = sample;
+  }
+  else
+  {
+    TIM_PWMSeq_TableEnd(htim);
+  }
+}
+
+#if defined(ARM_MATH_CM0PLUS)
+/**
+  * @brief  Fills a PWM sequencer table with sine waves computed by arm_sin_q15().
+  * @note   Sample = Pulse + Amplitude * sin(2 * pi * (step / Length + channel / ChannelCount)),
+  *         so 2 channels are in antiphase and 3 channels 120 degrees apart. Pulse
+  *         + Amplitude must not exceed the timer period. Needs the CMSIS-DSP
+  *         arm_sin_q15.c and arm_common_tables.c in the project.
+  * @param  pTable : Length * ChannelCount samples
+  * @param  Length : number of steps of one sine period
+  * @param  ChannelCount : samples per step, 1 to 4
+  * @param  Pulse : CCRx value of the sine axis
+  * @param  Amplitude : sine amplitude in CCRx counts, at most Pulse
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_TIM_PWMSeq_SineTable(uint16_t *pTable, uint16_t Length, uint32_t ChannelCount, uint16_t Pulse, uint16_t Amplitude)
+{
+  uint32_t step;
+  uint32_t channel;
+  uint32_t phase;
+  int32_t sine;
+
+  if((pTable == NULL) || (Length == 0U) || (ChannelCount == 0U) || (ChannelCount > 4U) || (Amplitude > Pulse))
+  {
+    return HAL_ERROR;
+  }
+
+  for(step = 0U; step < Length; step++)
+  {
+    for(channel = 0U; channel < ChannelCount; channel++)
+    {
+      /* arm_sin_q15() maps [0, 0x8000) to [0, 2 * pi) */
+      phase = ((step * 0x8000U) / Length) + ((channel * 0x8000U) / ChannelCount);
+      sine = arm_sin_q15((q15_t)(phase & 0x7FFFU));
+      *pTable++ = (uint16_t)((int32_t)Pulse + ((((int32_t)Amplitude * sine) + 0x4000) >> 15));
+    }
+  }
+
+  return HAL_OK;
+}
+#endif /* ARM_MATH_CM0PLUS */
+
 
 /**
   * @}
@@ -1230,6 +1461,8 @@ HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef *htim)
     /* Allocate lock resource and initialize it */
     htim->Lock = HAL_UNLOCKED;
     
+    htim->pPWMSeq = NULL;
+    
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     HAL_TIM_IC_MspInit(htim);
   }
@@ -1264,6 +1497,8 @@ HAL_StatusTypeDef HAL_TIM_IC_DeInit(TIM_HandleTypeDef *htim)
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_IC_MspDeInit(htim);
 
+  htim->pPWMSeq = NULL;
+
   /* Change TIM state */
   htim->State = HAL_TIM_STATE_RESET;
 
@@ -1530,6 +1765,8 @@ HAL_StatusTypeDef HAL_TIM_OnePulse_Init(TIM_HandleTypeDef *htim, uint32_t OnePul
     /* Allocate lock resource and initialize it */
     htim->Lock = HAL_UNLOCKED;
     
+    htim->pPWMSeq = NULL;
+    
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     HAL_TIM_OnePulse_MspInit(htim);
   }
@@ -1570,6 +1807,8 @@ HAL_StatusTypeDef HAL_TIM_OnePulse_DeInit(TIM_HandleTypeDef *htim)
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_OnePulse_MspDeInit(htim);
 
+  htim->pPWMSeq = NULL;
+
   /* Change TIM state */
   htim->State = HAL_TIM_STATE_RESET;
 
@@ -1827,6 +2066,8 @@ HAL_StatusTypeDef HAL_TIM_Encoder_Init(TIM_HandleTypeDef *htim,  TIM_Encoder_Ini
     /* Allocate lock resource and initialize it */
     htim->Lock = HAL_UNLOCKED;
     
+    htim->pPWMSeq = NULL;
+    
     /* Init the low level hardware : GPIO, CLOCK, NVIC */
     HAL_TIM_Encoder_MspInit(htim);
   }
@@ -1901,6 +2142,8 @@ HAL_StatusTypeDef HAL_TIM_Encoder_DeInit(TIM_HandleTypeDef *htim)
   /* DeInit the low level hardware: GPIO, CLOCK, NVIC */
   HAL_TIM_Encoder_MspDeInit(htim);
 
+  htim->pPWMSeq = NULL;
+
   /* Change TIM state */
   htim->State = HAL_TIM_STATE_RESET;
 
@@ -2149,6 +2392,12 @@ HAL_StatusTypeDef HAL_TIM_Encoder_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Chan
 uint8_t  mode_1;
 void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
 {
+  /* PWM sequencer step */
+  if((htim->pPWMSeq != NULL) && (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE) != RESET))
+  {
+    HAL_TIM_PWMSeq_IRQHandler(htim);
+  }
+
   /* Capture compare 1 event */	
   if(__HAL_TIM_GET_FLAG(htim, TIM_FLAG_CC1) != RESET)
   {
@@ -3370,6 +3619,23 @@ __weak void HAL_TIM_ErrorCallback(TIM_HandleTypeDef *htim)
    */
 }
 
+/**
+  * @brief  PWM sequencer table completed callback, called from the update interrupt
+  * @param  htim : TIM handle
+  * @param  pTable : table whose last step was written, free to be refilled
+  *         once another table is playing
+  * @retval None
+  */
+__weak void HAL_TIM_PWMSeq_TableCpltCallback(TIM_HandleTypeDef *htim, const uint16_t *pTable)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(htim);
+  UNUSED(pTable);
+  /* NOTE : This function Should not be modified, when the callback is needed,
+            the HAL_TIM_PWMSeq_TableCpltCallback could be implemented in the user file
+   */
+}
+
 /**
   * @}
   */
@@ -4313,6 +4579,39 @@ static void TIM_CCxNChannelCmd(TIM_TypeDef* TIMx, uint32_t Channel, uint32_t Cha
   TIMx->CCER |=  (uint32_t)(ChannelNState << Channel);
 }
 
+/**
+  * @brief  Moves the PWM sequencer to its next table once the last step of
+  *         the current one is written.
+  * @param  htim : TIM handle, sequencer running
+  * @retval None
+  */
+static void TIM_PWMSeq_TableEnd(TIM_HandleTypeDef *htim)
+{
+  TIM_PWMSeqTypeDef *hseq = htim->pPWMSeq;
+  const uint16_t *done = hseq->pTable;
+  const uint16_t *next = hseq->pNextTable;
+
+  if(next != NULL)
+  {
+    hseq->pTable = next;
+    hseq->pSample = next;
+    hseq->pEnd = next + ((uint32_t)hseq->NextLength * hseq->ChannelCount);
+    hseq->pNextTable = NULL;
+  }
+  else if(hseq->Init.Mode == TIM_PWMSEQ_MODE_CONTINUOUS)
+  {
+    hseq->pSample = done;
+  }
+  else
+  {
+    /* The last step stays on the outputs */
+    __HAL_TIM_DISABLE_IT(htim, TIM_IT_UPDATE);
+    htim->pPWMSeq = NULL;
+  }
+
+  HAL_TIM_PWMSeq_TableCpltCallback(htim, done);
+}
+
 /**
   * @}
   */
@@ -38,6 +38,9 @@
     (#) For the UART Half duplex mode, initialize the UART registers by calling 
         the HAL_HalfDuplex_Init() API.
 
+    (#) For the UART multiprocessor mode, initialize the UART registers by calling 
+        the HAL_UART_MultiProcessor_Init() API.
+
      [..] 
        (@) The specific UART interrupts (Transmission complete interrupt, 
             RXNE interrupt and Error Interrupts) will be managed using the macros
@@ -70,6 +73,19 @@
        (+) In case of transfer Error, HAL_UART_ErrorCallback() function is executed and user can 
             add his own code by customization of function pointer HAL_UART_ErrorCallback
 
+     *** Stream mode IO operation ***
+     ================================
+     [..]
+       (+) Attach a Tx and a Rx ring (sizes must be a power of two) with 
+            HAL_UART_Stream_Start(), HAL_UART_IRQHandler() then fills the Rx ring
+            and drains the Tx ring in the background
+       (+) Queue data with HAL_UART_Write(), it returns the number of bytes 
+            accepted and never waits for the wire
+       (+) Fetch received data with HAL_UART_Read(), bytes arriving while the Rx 
+            ring is full are dropped and flagged with HAL_UART_ERROR_ORE
+       (+) Detach the rings with HAL_UART_Stream_Stop()
+       (+) Utilities/UartRingSim runs this driver on a PC to check the rings
+
      *** UART HAL driver macros list ***
      =============================================
      [..]
@@ -144,6 +160,15 @@ static const uint8_t ParityTable256[256] =
  HAL_StatusTypeDef UART_Receive_IT(UART_HandleTypeDef *huart);
 static HAL_StatusTypeDef UART_WaitOnFlagUntilTimeout(UART_HandleTypeDef *huart, uint32_t Flag, FlagStatus Status, uint32_t Tickstart, uint32_t Timeout);
 static void UART_SetConfig (UART_HandleTypeDef *huart);
+static void UART_Stream_IT(UART_HandleTypeDef *huart, uint32_t isrflags);
+static void UART_SetByteHandlers(UART_HandleTypeDef *huart);
+static void UART_TxByte(UART_TypeDef *UARTx, uint8_t Data);
+static void UART_TxByte_Even(UART_TypeDef *UARTx, uint8_t Data);
+static void UART_TxByte_Odd(UART_TypeDef *UARTx, uint8_t Data);
+static uint32_t UART_RxByte(UART_TypeDef *UARTx, uint8_t *pData);
+static uint32_t UART_RxByte_Even(UART_TypeDef *UARTx, uint8_t *pData);
+static uint32_t UART_RxByte_Odd(UART_TypeDef *UARTx, uint8_t *pData);
+static uint32_t UART_RxByte_Config(UART_TypeDef *UARTx, uint8_t *pData);
 /**
   * @}
   */
@@ -171,6 +196,10 @@ static void UART_SetConfig (UART_HandleTypeDef *huart);
     The HAL_UART_Init() and HAL_HalfDuplex_Init() APIs follow respectively the 
 		UART asynchronous, UART Half duplex, configuration procedures (details for the 
 		procedures are available in reference manuals)
+    [..]
+    HAL_UART_MultiProcessor_Init() configures the 9-bit multiprocessor mode, the
+    hardware compares the address frames with the SADDR/SADEN registers so the 
+    CPU is only interrupted for the messages addressed to this node.
 
 @endverbatim
   * @{
@@ -200,6 +229,11 @@ HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
     HAL_UART_MspInit(huart);
   }
 
+  /* Detach the rings of a stream mode session that was not stopped */
+  huart->TxRing.pBuffer = NULL;
+  huart->RxRing.pBuffer = NULL;
+  huart->TxRingActive = 0U;
+
   huart->gState = HAL_UART_STATE_BUSY;
   
   /* Set the UART Communication parameters */
@@ -236,6 +270,11 @@ HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart)
     HAL_UART_MspInit(huart);
   }
 
+  /* Detach the rings of a stream mode session that was not stopped */
+  huart->TxRing.pBuffer = NULL;
+  huart->RxRing.pBuffer = NULL;
+  huart->TxRingActive = 0U;
+
   huart->gState = HAL_UART_STATE_BUSY;
 
   /* Set the UART Communication parameters */
@@ -255,6 +294,98 @@ HAL_StatusTypeDef HAL_HalfDuplex_Init(UART_HandleTypeDef *huart)
   return HAL_OK;
 }
 
+/**
+  * @brief  Initializes the UART in multiprocessor mode, the receiver only takes
+  *         an interrupt for address frames (9th bit set) matching the given 
+  *         or the broadcast address.
+  * @note   Init.WordLength must be UART_WORDLENGTH_9B and Init.Parity UART_PARITY_NONE,
+  *         the 9th bit is the address/data flag. The hardware matches:
+  *           given address:     Address on the bits set in BroadcastAddress,
+  *                              the other bits are don't care
+  *           broadcast address: BroadcastAddress, usually 0xFF
+  * @note   The receiver starts in mute mode. On the matching address byte call
+  *         HAL_UART_MultiProcessor_ExitMuteMode() to receive the data frames that
+  *         follow, then HAL_UART_MultiProcessor_EnterMuteMode() at the end of the 
+  *         message. Data frames are sent with the 9th bit cleared.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  Address: UART node address
+  * @param  BroadcastAddress: UART broadcast address, it must include every bit set in Address
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_MultiProcessor_Init(UART_HandleTypeDef *huart, uint8_t Address, uint8_t BroadcastAddress)
+{
+  /* Check the UART handle allocation */
+  if(huart == NULL)
+  {
+    return HAL_ERROR;
+  }
+
+  /* The 9th bit is the address flag, it can not carry a parity bit */
+  if((huart->Init.WordLength != UART_WORDLENGTH_9B) || (huart->Init.Parity != UART_PARITY_NONE) ||
+     ((Address & (uint8_t)~BroadcastAddress) != 0U))
+  {
+    return HAL_ERROR;
+  }
+  
+  if(huart->gState == HAL_UART_STATE_RESET)
+  {  
+    /* Allocate lock resource and initialize it */
+    huart->Lock = HAL_UNLOCKED;
+
+    /* Init the low level hardware */
+    HAL_UART_MspInit(huart);
+  }
+
+  /* Detach the rings of a stream mode session that was not stopped */
+  huart->TxRing.pBuffer = NULL;
+  huart->RxRing.pBuffer = NULL;
+  huart->TxRingActive = 0U;
+
+  huart->gState = HAL_UART_STATE_BUSY;
+  
+  /* Set the UART Communication parameters */
+  UART_SetConfig(huart);
+
+  /* Set the given and broadcast addresses, send data frames and start muted */
+  WRITE_REG(huart->Instance->SADDR, Address);
+  WRITE_REG(huart->Instance->SADEN, BroadcastAddress);
+  CLEAR_BIT(huart->Instance->SCON, UART_SCON_TB8);
+  SET_BIT(huart->Instance->SCON, UART_SCON_SM2);
+  /* Initialize the UART state */
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  huart->gState= HAL_UART_STATE_READY;
+  huart->RxState= HAL_UART_STATE_READY;
+  
+  return HAL_OK;
+}
+
+/**
+  * @brief  Enters the UART mute mode, only matching address frames are received.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_MultiProcessor_EnterMuteMode(UART_HandleTypeDef *huart)
+{
+  SET_BIT(huart->Instance->SCON, UART_SCON_SM2);
+  
+  return HAL_OK;
+}
+
+/**
+  * @brief  Exits the UART mute mode, every frame is received.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_MultiProcessor_ExitMuteMode(UART_HandleTypeDef *huart)
+{
+  CLEAR_BIT(huart->Instance->SCON, UART_SCON_SM2);
+  
+  return HAL_OK;
+}
+
 
 /**
   * @brief  DeInitializes the UART peripheral. 
@@ -278,6 +409,10 @@ HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart)
   /* DeInit the low level hardware */
   HAL_UART_MspDeInit(huart);
 
+  huart->TxRing.pBuffer = NULL;
+  huart->RxRing.pBuffer = NULL;
+  huart->TxRingActive = 0U;
+
   huart->ErrorCode = HAL_UART_ERROR_NONE;
   huart->gState = HAL_UART_STATE_RESET;
   huart->RxState = HAL_UART_STATE_RESET;
@@ -288,6 +423,20 @@ HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart)
   return HAL_OK;
 }
 
+/**
+  * @brief  Binds the byte handlers of a handle to its frame format.
+  * @note   HAL_UART_Init() and the other init functions already do it. This is
+  *         only needed for a handle whose registers are configured by the 
+  *         application itself, before it is used with the HAL functions.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval None
+  */
+void HAL_UART_BindByteHandlers(UART_HandleTypeDef *huart)
+{
+  UART_SetByteHandlers(huart);
+}
+
 /**
   * @brief  UART MSP Init.
   * @param  huart: pointer to a UART_HandleTypeDef structure that contains
@@ -355,6 +504,12 @@ __weak void HAL_UART_MspDeInit(UART_HandleTypeDef *huart)
         (++) HAL_UART_Receive_IT()
         (++) HAL_UART_IRQHandler()
 
+    (#) Stream mode APIs with Interrupt are:
+        (++) HAL_UART_Stream_Start()
+        (++) HAL_UART_Stream_Stop()
+        (++) HAL_UART_Write()
+        (++) HAL_UART_Read()
+
     (#) A set of Transfer Complete Callbacks are provided in non blocking mode:
         (++) HAL_UART_TxCpltCallback()
         (++) HAL_UART_RxCpltCallback()
@@ -409,35 +564,14 @@ HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, u
     while(huart->TxXferCount > 0U)
     {
       huart->TxXferCount--;
-      if(huart->Init.WordLength == UART_WORDLENGTH_9B)
-      {			
-				if(huart->Init.Parity == UART_PARITY_EVEN)
-				{
-					MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, ((ParityTable256[*pData] & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-				}
-				else if(huart->Init.Parity == UART_PARITY_ODD)
-				{
-					MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, (((~ParityTable256[*pData]) & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-				}						
-					
-        huart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);	
+      /* TB8 is set by the handler bound to the frame format at init */
+      huart->TxByte(huart->Instance, *pData++);
 				
-        if(UART_WaitOnFlagUntilTimeout(huart, UART_FLAG_TC, RESET, tickstart, Timeout) != HAL_OK)
-        {
-          return HAL_TIMEOUT;
-        }	
-				__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC);	
-      }
-      else
+      if(UART_WaitOnFlagUntilTimeout(huart, UART_FLAG_TC, RESET, tickstart, Timeout) != HAL_OK)
       {
-        huart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);				
-				/* uart 8bit communication doesn't support parity transmit */
-        if(UART_WaitOnFlagUntilTimeout(huart, UART_FLAG_TC, RESET, tickstart, Timeout) != HAL_OK)
-        {
-          return HAL_TIMEOUT;
-        }
-				__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC);	
-      }
+        return HAL_TIMEOUT;
+      }	
+			__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC);	
     }
 
     /* At end of Tx process, restore huart->gState to Ready */
@@ -454,6 +588,52 @@ HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, u
   }
 }
 
+/**
+  * @brief  Sends one address frame (9th bit set) in multiprocessor mode.
+  * @note   Only the nodes whose given or broadcast address matches are 
+  *         interrupted, the data frames that follow are sent with the usual
+  *         transmit functions.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  Address: address of the destination node
+  * @param  Timeout: Timeout duration  
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_MultiProcessor_SendAddress(UART_HandleTypeDef *huart, uint8_t Address, uint32_t Timeout)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  
+  /* Check that a Tx process is not already ongoing */
+  if(huart->gState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  /* Process Locked */
+  __HAL_LOCK(huart);
+
+  huart->gState = HAL_UART_STATE_BUSY_TX;
+
+  /* TC interrupt must be enabled to unmask TC flag for polling */
+  __HAL_UART_ENABLE_IT(huart, UART_IT_TC);
+
+  SET_BIT(huart->Instance->SCON, UART_SCON_TB8);
+  huart->Instance->SBUF = Address;
+  if(UART_WaitOnFlagUntilTimeout(huart, UART_FLAG_TC, RESET, HAL_GetTick(), Timeout) != HAL_OK)
+  {
+    status = HAL_TIMEOUT;
+  }
+  __HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC);
+  CLEAR_BIT(huart->Instance->SCON, UART_SCON_TB8);
+
+  huart->gState = HAL_UART_STATE_READY;
+
+  /* Process Unlocked */
+  __HAL_UNLOCK(huart);
+
+  return status;
+}
+
 
 void Naked_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size,IRQn_Type IRQn)
 {
@@ -466,22 +646,7 @@ void Naked_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Siz
     while(huart->TxXferCount > 0U)
     {
       huart->TxXferCount--;
-      if(huart->Init.WordLength == UART_WORDLENGTH_9B)
-      {			
-				if(huart->Init.Parity == UART_PARITY_EVEN)
-				{
-					MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, ((ParityTable256[*pData] & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-				}
-				else if(huart->Init.Parity == UART_PARITY_ODD)
-				{
-					MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, (((~ParityTable256[*pData]) & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-				}						
-        huart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);	
-      }
-      else
-      {
-        huart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);				
-      }
+      huart->TxByte(huart->Instance, *pData++);
 			Timeout = 0;
 			while((huart->Instance->INTSR & UART_FLAG_TC) != (UART_FLAG_TC)) 
 			{
@@ -510,7 +675,7 @@ void Naked_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Siz
   */
 HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout)
 {
-  uint8_t tmp;
+  uint32_t error;
   uint32_t tickstart = 0U;
   
   /* Check that a Rx process is not already ongoing */
@@ -540,78 +705,23 @@ HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef *huart, uint8_t *pData, ui
     while(huart->RxXferCount > 0U)
     {
       huart->RxXferCount--;
-      if(huart->Init.WordLength == UART_WORDLENGTH_9B)
-      {
-        if(UART_WaitOnFlagUntilTimeout(huart, UART_FLAG_RXNE, RESET, tickstart, Timeout) != HAL_OK)
-        {
-          return HAL_TIMEOUT;
-        }
-				__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);
-
-				tmp = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);
-				if(huart->Init.Parity == UART_PARITY_NONE)
-				{
-						*pData++ = tmp&((uint8_t)0xFF);					
-				}
-				else if(huart->Init.Parity == UART_PARITY_EVEN)
-				{					
-					if((ParityTable256[tmp&((uint8_t)0xFF)]) == (((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos) & UART_BIT0_Msk))	
-					{
-						*pData++ = tmp&((uint8_t)0xFF);
-					}
-					else
-					{
-						/* Rx error process, set huart->RxState to Error */
-						huart->RxState = HAL_UART_STATE_ERROR;
-						huart->ErrorCode = HAL_UART_ERROR_PARITY;						
-						__HAL_UNLOCK(huart);
-						return HAL_ERROR;						
-					}				
-				}
-				else if(huart->Init.Parity == UART_PARITY_ODD)
-				{
-					if((ParityTable256[tmp&((uint8_t)0xFF)]) == ((~((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos)) & UART_BIT0_Msk))	
-					{
-						*pData++ = tmp&((uint8_t)0xFF);
-					}	
-					else
-					{
-						/* Rx error process, set huart->RxState to Error */
-						huart->RxState = HAL_UART_STATE_ERROR;
-						huart->ErrorCode = HAL_UART_ERROR_PARITY;								
-						__HAL_UNLOCK(huart);
-						return HAL_ERROR;						
-					}							
-				}
-				else
-				{
-					/* Rx error process, set huart->RxState to Error */
-					huart->RxState = HAL_UART_STATE_ERROR;
-					__HAL_UNLOCK(huart);
-					return HAL_ERROR;						
-				}
-      } 
-      else
+      if(UART_WaitOnFlagUntilTimeout(huart, UART_FLAG_RXNE, RESET, tickstart, Timeout) != HAL_OK)
       {
-        if(UART_WaitOnFlagUntilTimeout(huart, UART_FLAG_RXNE, RESET, tickstart, Timeout) != HAL_OK)
-        {
-          return HAL_TIMEOUT;
-        }
-				__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);
-				
-				/* uart 8bit communication doesn't support parity check */
-        if(huart->Init.Parity != UART_PARITY_NONE)
-        {
-					/* Rx error process, set huart->RxState to Error */
-					huart->RxState = HAL_UART_STATE_ERROR;
-					__HAL_UNLOCK(huart);
-					return HAL_ERROR;		
-        }
-        else
-        {
-          *pData++ = (uint8_t)(huart->Instance->SBUF & (uint8_t)0x00FF);
-        }
+        return HAL_TIMEOUT;
       }
+			__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);
+
+			/* Parity is checked by the handler bound to the frame format at init */
+			error = huart->RxByte(huart->Instance, pData);
+			if(error != HAL_UART_ERROR_NONE)
+			{
+				/* Rx error process, set huart->RxState to Error */
+				huart->RxState = HAL_UART_STATE_ERROR;
+				huart->ErrorCode = error;
+				__HAL_UNLOCK(huart);
+				return HAL_ERROR;
+			}
+			pData++;
     }
 
     /* At end of Rx process, restore huart->RxState to Ready */
@@ -662,28 +772,9 @@ HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, uint8_t *pData
     /* This interrupt must be enabled first, otherwise TC flag will not set */		
     __HAL_UART_ENABLE_IT(huart, UART_IT_TC);		
 		
-		if(huart->Init.WordLength == UART_WORDLENGTH_9B)
-		{
-			if(huart->Init.Parity == UART_PARITY_EVEN)
-			{
-				MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, ((ParityTable256[*pData] & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-			}
-			else if(huart->Init.Parity == UART_PARITY_ODD)
-			{
-				MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, (((~ParityTable256[*pData]) & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-			}				
-			
-			huart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);	
-			huart->pTxBuffPtr = pData;
-			huart->TxXferCount--;			
-		}
-		else
-		{
-			/* uart 8bit communication doesn't support parity transmit */
-			huart->Instance->SBUF = (*pData++ & (uint8_t)0xFF);
-			huart->pTxBuffPtr = pData;
-			huart->TxXferCount--;
-		}		
+		huart->TxByte(huart->Instance, *pData++);
+		huart->pTxBuffPtr = pData;
+		huart->TxXferCount--;
 	
     return HAL_OK;
   }
@@ -832,6 +923,204 @@ HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef *huart)
 }
 
 
+/**
+  * @brief  Starts stream mode: Rx bytes are stored into a ring and the Tx ring
+  *         is drained by interrupt.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  pTxBuff: Pointer to Tx ring storage
+  * @param  TxSize: Tx ring size in bytes, must be a power of two
+  * @param  pRxBuff: Pointer to Rx ring storage
+  * @param  RxSize: Rx ring size in bytes, must be a power of two
+  * @note   While stream mode is running gState and RxState are kept busy, so the
+  *         blocking and buffer based interrupt APIs return HAL_BUSY.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_Stream_Start(UART_HandleTypeDef *huart, uint8_t *pTxBuff, uint16_t TxSize, uint8_t *pRxBuff, uint16_t RxSize)
+{
+  /* Check that no Tx or Rx process is ongoing */
+  if((huart->gState == HAL_UART_STATE_READY) && (huart->RxState == HAL_UART_STATE_READY))
+  {
+    if((pTxBuff == NULL) || (pRxBuff == NULL))
+    {
+      return HAL_ERROR;
+    }
+    /* Check the parameters */
+    assert_param(IS_UART_RING_SIZE(TxSize));
+    assert_param(IS_UART_RING_SIZE(RxSize));
+
+    /* Process Locked */
+    __HAL_LOCK(huart);
+
+    huart->TxRing.pBuffer = pTxBuff;
+    huart->TxRing.Mask = TxSize - 1U;
+    huart->TxRing.Head = 0U;
+    huart->TxRing.Tail = 0U;
+    huart->RxRing.pBuffer = pRxBuff;
+    huart->RxRing.Mask = RxSize - 1U;
+    huart->RxRing.Head = 0U;
+    huart->RxRing.Tail = 0U;
+    huart->TxRingActive = 0U;
+
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+
+    /* Process Unlocked */
+    __HAL_UNLOCK(huart);
+
+    /* Drop stale flags, then keep both interrupts enabled for the whole session */
+    __HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC | UART_FLAG_RXNE | UART_FLAG_FE);
+    __HAL_UART_ENABLE_IT(huart, UART_IT_TC | UART_IT_RXNE);
+
+    return HAL_OK;
+  }
+  else
+  {
+    return HAL_BUSY;
+  }
+}
+
+/**
+  * @brief  Stops stream mode and detaches the rings.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @note   Bytes still queued in the Tx ring are discarded.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_Stream_Stop(UART_HandleTypeDef *huart)
+{
+  /* Disable TCIE, RXNE interrupts */
+  CLEAR_BIT(huart->Instance->SCON, (UART_SCON_TIEN | UART_SCON_RIEN));
+
+  huart->TxRing.pBuffer = NULL;
+  huart->RxRing.pBuffer = NULL;
+  huart->TxRingActive = 0U;
+
+  /* Restore huart->RxState and huart->gState to Ready */
+  huart->RxState = HAL_UART_STATE_READY;
+  huart->gState = HAL_UART_STATE_READY;
+
+  return HAL_OK;
+}
+
+/**
+  * @brief  Queues data into the Tx ring without waiting for the wire.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  pData: Pointer to data buffer
+  * @param  Size: Amount of data to be queued
+  * @note   Must only be called from a single context (the producer).
+  * @retval Number of bytes actually queued, less than Size if the ring is full
+  */
+uint16_t HAL_UART_Write(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+  UART_RingBuffTypeDef *ring = &huart->TxRing;
+  uint16_t head = ring->Head;
+  uint16_t space;
+  uint16_t count;
+
+  if(ring->pBuffer == NULL)
+  {
+    return 0U;
+  }
+
+  space = (uint16_t)(ring->Mask + 1U - (uint16_t)(head - ring->Tail));
+  if(Size > space)
+  {
+    Size = space;
+  }
+
+  for(count = 0U; count < Size; count++)
+  {
+    ring->pBuffer[head & ring->Mask] = pData[count];
+    head++;
+  }
+  /* Make the payload visible before publishing the new head */
+  __DMB();
+  ring->Head = head;
+
+  /* The Tx interrupt only runs while a byte is on the wire, so restart it if 
+     it already found the ring empty. The ISR can not touch Tail while idle. */
+  if((huart->TxRingActive == 0U) && (Size != 0U))
+  {
+    huart->TxRingActive = 1U;
+    huart->TxByte(huart->Instance, ring->pBuffer[ring->Tail & ring->Mask]);
+    ring->Tail++;
+  }
+
+  return Size;
+}
+
+/**
+  * @brief  Fetches received data from the Rx ring.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  pData: Pointer to data buffer
+  * @param  Size: Maximum amount of data to be read
+  * @note   Must only be called from a single context (the consumer).
+  * @retval Number of bytes actually read
+  */
+uint16_t HAL_UART_Read(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  UART_RingBuffTypeDef *ring = &huart->RxRing;
+  uint16_t tail = ring->Tail;
+  uint16_t avail;
+  uint16_t count;
+
+  if(ring->pBuffer == NULL)
+  {
+    return 0U;
+  }
+
+  avail = (uint16_t)(ring->Head - tail);
+  if(Size > avail)
+  {
+    Size = avail;
+  }
+  /* Do not read the payload before the head it was published with */
+  __DMB();
+
+  for(count = 0U; count < Size; count++)
+  {
+    pData[count] = ring->pBuffer[tail & ring->Mask];
+    tail++;
+  }
+  ring->Tail = tail;
+
+  return Size;
+}
+
+/**
+  * @brief  Returns the free space left in the Tx ring.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval Number of bytes HAL_UART_Write() can accept right now
+  */
+uint16_t HAL_UART_GetTxFree(UART_HandleTypeDef *huart)
+{
+  if(huart->TxRing.pBuffer == NULL)
+  {
+    return 0U;
+  }
+  return (uint16_t)(huart->TxRing.Mask + 1U - (uint16_t)(huart->TxRing.Head - huart->TxRing.Tail));
+}
+
+/**
+  * @brief  Returns the number of bytes waiting in the Rx ring.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval Number of bytes HAL_UART_Read() can return right now
+  */
+uint16_t HAL_UART_GetRxCount(UART_HandleTypeDef *huart)
+{
+  if(huart->RxRing.pBuffer == NULL)
+  {
+    return 0U;
+  }
+  return (uint16_t)(huart->RxRing.Head - huart->RxRing.Tail);
+}
+
 /**
   * @brief  This function handles UART interrupt request.
   * @param  huart: pointer to a UART_HandleTypeDef structure that contains
@@ -844,6 +1133,13 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
   uint32_t sconits    = READ_REG(huart->Instance->SCON);
   uint32_t errorflags = 0x00U;
 	
+  /* UART in stream mode ----------------------------------------------------*/
+  if(huart->RxRing.pBuffer != NULL)
+  {
+    UART_Stream_IT(huart, isrflags);
+    return;
+  }
+
   /* If no error occurs */
   errorflags = (isrflags & (uint32_t)UART_INTSR_FE);
   if(errorflags == RESET)
@@ -899,7 +1195,6 @@ void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
 
 void Naked_UART_IRQHandler(UART_HandleTypeDef *huart)
 {
-		uint8_t tmp;
 		uint32_t isrflags   = READ_REG(huart->Instance->INTSR);
 		uint32_t sconits    = READ_REG(huart->Instance->SCON);
 		uint32_t errorflags = 0x00U;
@@ -912,32 +1207,11 @@ void Naked_UART_IRQHandler(UART_HandleTypeDef *huart)
 			if(((isrflags & UART_INTSR_RI) != RESET) && ((sconits & UART_SCON_RIEN) != RESET))
 			{
 					__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);		
-					if(huart->Init.WordLength == UART_WORDLENGTH_9B)
-					{
-						if(huart->Init.Parity == UART_PARITY_NONE)
-						{
-							*huart->pRxBuffPtr++ = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);
-						}
-						else if(huart->Init.Parity == UART_PARITY_EVEN)
-						{
-							tmp = (uint8_t)(huart->Instance->SBUF & (uint8_t)0x0FF);	
-							if((ParityTable256[tmp&((uint8_t)0xFF)]) == (((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos) & UART_BIT0_Msk))	
-							{
-								*huart->pRxBuffPtr++ = tmp&((uint8_t)0xFF);
-							}			
-						}
-						else if(huart->Init.Parity == UART_PARITY_ODD)
-						{
-							tmp = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);	
-							if((ParityTable256[tmp&((uint8_t)0xFF)]) == ((~((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos)) & UART_BIT0_Msk))
-							{
-								*huart->pRxBuffPtr++ = tmp&((uint8_t)0xFF);
-							}				
-						}			
-					}
-					else
+					/* A byte failing the parity check is dropped, an 8 bit frame is
+					   stored whatever the parity setting */
+					if(huart->RxByte(huart->Instance, huart->pRxBuffPtr) != HAL_UART_ERROR_PARITY)
 					{
-						*huart->pRxBuffPtr++ = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);
+						huart->pRxBuffPtr++;
 					}
 					if(--huart->RxXferCount == 0U)
 					{
@@ -1203,23 +1477,7 @@ static HAL_StatusTypeDef UART_WaitOnFlagUntilTimeout(UART_HandleTypeDef *huart,
 			return HAL_OK;
     }				
 		
-    if(huart->Init.WordLength == UART_WORDLENGTH_9B)
-    {						
-			if(huart->Init.Parity == UART_PARITY_EVEN)
-			{
-				MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, ((ParityTable256[*huart->pTxBuffPtr] & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-			}
-			else if(huart->Init.Parity == UART_PARITY_ODD)
-			{
-				MODIFY_REG(huart->Instance->SCON, UART_SCON_TB8, (((~ParityTable256[*huart->pTxBuffPtr]) & UART_BIT0_Msk) << UART_SCON_TB8_Pos));
-			}				
-			
-      huart->Instance->SBUF = (uint8_t)((*huart->pTxBuffPtr++) & (uint8_t)0xFF);
-    } 
-    else
-    {
-      huart->Instance->SBUF = (uint8_t)((*huart->pTxBuffPtr++) & (uint8_t)0xFF);
-    }
+    huart->TxByte(huart->Instance, *huart->pTxBuffPtr++);
 		
     return HAL_OK;
   }
@@ -1239,63 +1497,21 @@ static HAL_StatusTypeDef UART_WaitOnFlagUntilTimeout(UART_HandleTypeDef *huart,
   */
 HAL_StatusTypeDef UART_Receive_IT(UART_HandleTypeDef *huart)
 {
-  uint8_t tmp;
+  uint32_t error;
   
 	/* Check that a Rx process is ongoing */
   if(huart->RxState == HAL_UART_STATE_BUSY_RX) 
   {
 		__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);		
-    if(huart->Init.WordLength == UART_WORDLENGTH_9B)
-    {
-      if(huart->Init.Parity == UART_PARITY_NONE)
-      {
-        *huart->pRxBuffPtr++ = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);
-      }
-      else if(huart->Init.Parity == UART_PARITY_EVEN)
-      {
-				tmp = (uint8_t)(huart->Instance->SBUF & (uint8_t)0x0FF);	
-				if((ParityTable256[tmp&((uint8_t)0xFF)]) == (((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos) & UART_BIT0_Msk))	
-				{
-					*huart->pRxBuffPtr++ = tmp&((uint8_t)0xFF);
-				}
-				else
-				{
-					/* Rx error process, set huart->RxState to Error */
-					huart->RxState = HAL_UART_STATE_ERROR;		
-					huart->ErrorCode = HAL_UART_ERROR_PARITY;
-					return HAL_ERROR;	
-				}					
-      }
-      else if(huart->Init.Parity == UART_PARITY_ODD)
-      {
-				tmp = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);	
-				if((ParityTable256[tmp&((uint8_t)0xFF)]) == ((~((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos)) & UART_BIT0_Msk))
-				{
-					*huart->pRxBuffPtr++ = tmp&((uint8_t)0xFF);
-				}
-				else
-				{
-					/* Rx error process, set huart->RxState to Error */
-					huart->RxState = HAL_UART_STATE_ERROR;		
-					huart->ErrorCode = HAL_UART_ERROR_PARITY;					
-					return HAL_ERROR;	
-				}					
-      }			
-    }
-    else
+    error = huart->RxByte(huart->Instance, huart->pRxBuffPtr);
+    if(error != HAL_UART_ERROR_NONE)
     {
-      if(huart->Init.Parity != UART_PARITY_NONE)
-      {
-				/* Rx error process, set huart->RxState to Error */
-				huart->RxState = HAL_UART_STATE_ERROR;	
-				huart->ErrorCode = HAL_UART_ERROR_CONFIG;						
-				return HAL_ERROR;				
-      }
-      else
-      {
-        *huart->pRxBuffPtr++ = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);
-      }
+			/* Rx error process, set huart->RxState to Error */
+			huart->RxState = HAL_UART_STATE_ERROR;		
+			huart->ErrorCode = error;
+			return HAL_ERROR;	
     }
+    huart->pRxBuffPtr++;
 
     if(--huart->RxXferCount == 0U)
     {
@@ -1326,38 +1542,205 @@ HAL_StatusTypeDef UART_Receive_IT(UART_HandleTypeDef *huart)
 HAL_StatusTypeDef UART_Single_Receive_IT(UART_HandleTypeDef *huart)
 {
   uint8_t tmp;
-	/* Check that a Rx process is ongoing */
-	if(huart->Init.WordLength == UART_WORDLENGTH_9B)
+	/* A byte failing the parity check is dropped, an 8 bit frame is stored
+	   whatever the parity setting */
+	if(huart->RxByte(huart->Instance, &tmp) != HAL_UART_ERROR_PARITY)
 	{
-		if(huart->Init.Parity == UART_PARITY_NONE)
-		{
-			*huart->pRxBuffPtr = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);
-		}
-		else if(huart->Init.Parity == UART_PARITY_EVEN)
-		{
-			tmp = (uint8_t)(huart->Instance->SBUF & (uint8_t)0x0FF);	
-			if((ParityTable256[tmp&((uint8_t)0xFF)]) == (((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos) & UART_BIT0_Msk))	
-			{
-				*huart->pRxBuffPtr = tmp&((uint8_t)0xFF);
-			}
-		}
-		else if(huart->Init.Parity == UART_PARITY_ODD)
-		{
-			tmp = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);	
-			if((ParityTable256[tmp&((uint8_t)0xFF)]) == ((~((huart->Instance->SCON & UART_SCON_RB8) >> UART_SCON_RB8_Pos)) & UART_BIT0_Msk))
-			{
-				*huart->pRxBuffPtr = tmp&((uint8_t)0xFF);
-			}			
-		}			
-	}
-	else
-	{
-		 *huart->pRxBuffPtr = (uint8_t)(huart->Instance->SBUF & (uint8_t)0xFF);
+		*huart->pRxBuffPtr = tmp;
 	}
 
 	return HAL_OK;
 }
 
+/**
+  * @brief  Stream mode interrupt service: fills the Rx ring and drains the Tx ring.
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  isrflags: INTSR value sampled on interrupt entry
+  * @retval None
+  */
+static void UART_Stream_IT(UART_HandleTypeDef *huart, uint32_t isrflags)
+{
+  UART_RingBuffTypeDef *ring;
+  uint16_t head;
+  uint8_t tmp;
+  uint32_t error;
+
+  /* UART frame error occurred -----------------------------------*/
+  if((isrflags & UART_INTSR_FE) != RESET)
+  {
+    huart->ErrorCode |= HAL_UART_ERROR_FE;
+		__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_FE);
+  }
+
+  /* UART in mode Receiver -------------------------------------------------*/
+  if((isrflags & UART_INTSR_RI) != RESET)
+  {
+		__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);
+    error = huart->RxByte(huart->Instance, &tmp);
+    huart->ErrorCode |= error;
+
+    if(error == HAL_UART_ERROR_NONE)
+    {
+      ring = &huart->RxRing;
+      head = ring->Head;
+      if((uint16_t)(head - ring->Tail) <= ring->Mask)
+      {
+        ring->pBuffer[head & ring->Mask] = tmp;
+        /* Make the payload visible before publishing the new head */
+        __DMB();
+        ring->Head = head + 1U;
+      }
+      else
+      {
+        huart->ErrorCode |= HAL_UART_ERROR_ORE;
+      }
+    }
+  }
+
+  /* UART in mode Transmitter ------------------------------------------------*/
+  if((isrflags & UART_INTSR_TI) != RESET)
+  {
+		__HAL_UART_CLEAR_FLAG(huart, UART_FLAG_TC);
+    ring = &huart->TxRing;
+    if(ring->Head != ring->Tail)
+    {
+      huart->TxByte(huart->Instance, ring->pBuffer[ring->Tail & ring->Mask]);
+      ring->Tail++;
+    }
+    else
+    {
+      /* Ring empty, HAL_UART_Write() restarts the transfer */
+      huart->TxRingActive = 0U;
+    }
+  }
+
+  /* Non Blocking error : transfer goes on. 
+     Error is notified to user through user error callback */
+  if(huart->ErrorCode != HAL_UART_ERROR_NONE)
+  {
+    HAL_UART_ErrorCallback(huart);
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+  }
+}
+
+/**
+  * @brief  Binds the byte handlers matching Init.WordLength and Init.Parity, 
+  *         the transfer loops and interrupt handlers then never test the frame
+  *         format again.
+  * @note   8 bit frames can not carry a parity bit, the receiver reports a 
+  *         HAL_UART_ERROR_CONFIG error if a parity is requested. In 9 bit mode 
+  *         without parity TB8 is left to the application (multiprocessor mode).
+  * @param  huart: pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval None
+  */
+static void UART_SetByteHandlers(UART_HandleTypeDef *huart)
+{
+  if((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_EVEN))
+  {
+    huart->TxByte = UART_TxByte_Even;
+    huart->RxByte = UART_RxByte_Even;
+  }
+  else if((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_ODD))
+  {
+    huart->TxByte = UART_TxByte_Odd;
+    huart->RxByte = UART_RxByte_Odd;
+  }
+  else
+  {
+    huart->TxByte = UART_TxByte;
+    huart->RxByte = (huart->Init.Parity == UART_PARITY_NONE) ? UART_RxByte : UART_RxByte_Config;
+  }
+}
+
+/**
+  * @brief  Writes one byte, 8 bit frames or 9 bit frames without parity.
+  * @param  UARTx: UART registers base address
+  * @param  Data: byte to be sent
+  * @retval None
+  */
+static void UART_TxByte(UART_TypeDef *UARTx, uint8_t Data)
+{
+  UARTx->SBUF = Data;
+}
+
+/**
+  * @brief  Writes one byte with its even parity bit in TB8.
+  * @param  UARTx: UART registers base address
+  * @param  Data: byte to be sent
+  * @retval None
+  */
+static void UART_TxByte_Even(UART_TypeDef *UARTx, uint8_t Data)
+{
+  UARTx->SCON = (UARTx->SCON & ~UART_SCON_TB8) | ((uint32_t)ParityTable256[Data] << UART_SCON_TB8_Pos);
+  UARTx->SBUF = Data;
+}
+
+/**
+  * @brief  Writes one byte with its odd parity bit in TB8.
+  * @param  UARTx: UART registers base address
+  * @param  Data: byte to be sent
+  * @retval None
+  */
+static void UART_TxByte_Odd(UART_TypeDef *UARTx, uint8_t Data)
+{
+  UARTx->SCON = (UARTx->SCON & ~UART_SCON_TB8) | ((uint32_t)(ParityTable256[Data] ^ UART_BIT0_Msk) << UART_SCON_TB8_Pos);
+  UARTx->SBUF = Data;
+}
+
+/**
+  * @brief  Reads one byte, no parity check.
+  * @param  UARTx: UART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_UART_ERROR_NONE
+  */
+static uint32_t UART_RxByte(UART_TypeDef *UARTx, uint8_t *pData)
+{
+  *pData = (uint8_t)UARTx->SBUF;
+  return HAL_UART_ERROR_NONE;
+}
+
+/**
+  * @brief  Reads one byte and checks its even parity bit in RB8.
+  * @param  UARTx: UART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_UART_ERROR_NONE or HAL_UART_ERROR_PARITY
+  */
+static uint32_t UART_RxByte_Even(UART_TypeDef *UARTx, uint8_t *pData)
+{
+  uint8_t tmp = (uint8_t)UARTx->SBUF;
+
+  *pData = tmp;
+  return ((ParityTable256[tmp] ^ (UARTx->SCON >> UART_SCON_RB8_Pos)) & UART_BIT0_Msk) * HAL_UART_ERROR_PARITY;
+}
+
+/**
+  * @brief  Reads one byte and checks its odd parity bit in RB8.
+  * @param  UARTx: UART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_UART_ERROR_NONE or HAL_UART_ERROR_PARITY
+  */
+static uint32_t UART_RxByte_Odd(UART_TypeDef *UARTx, uint8_t *pData)
+{
+  uint8_t tmp = (uint8_t)UARTx->SBUF;
+
+  *pData = tmp;
+  return ((ParityTable256[tmp] ^ (UARTx->SCON >> UART_SCON_RB8_Pos) ^ UART_BIT0_Msk) & UART_BIT0_Msk) * HAL_UART_ERROR_PARITY;
+}
+
+/**
+  * @brief  Reads one byte of an unsupported frame format (parity on 8 bit frames).
+  * @param  UARTx: UART registers base address
+  * @param  pData: Pointer to the received byte
+  * @retval HAL_UART_ERROR_CONFIG
+  */
+static uint32_t UART_RxByte_Config(UART_TypeDef *UARTx, uint8_t *pData)
+{
+  *pData = (uint8_t)UARTx->SBUF;
+  return HAL_UART_ERROR_CONFIG;
+}
+
 /**
   * @brief  Configures the UART peripheral. 
   * @param  huart: pointer to a UART_HandleTypeDef structure that contains
@@ -1379,6 +1762,8 @@ static void UART_SetConfig(UART_HandleTypeDef *huart)
   /*-------------------------- UART BAUDCR Configuration ---------------------*/
   huart->Instance->BAUDCR = (((((huart->Init.BaudDouble >> UART_SCON_DBAUD_Pos)+1)*HAL_RCC_GetPCLKFreq())/(32*(huart->Init.BaudRate))-1) & UART_BAUDCR_BRG) | UART_BAUDCR_SELF_BRG;
 
+  /*-------------------------- Byte handlers ---------------------------------*/
+  UART_SetByteHandlers(huart);
 }
 
 
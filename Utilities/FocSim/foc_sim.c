@@ -0,0 +1,313 @@
+/**
+  ******************************************************************************
+  * @file    foc_sim.c
+  * @author  Application Team
+  * @Version V1.0.0
+  * @brief   Host simulation of Common/foc.c driving a PMSM model.
+  *          Build on Linux with:
+  *            cc -O2 -DFOC_HOST_SIM -I../../Common -o foc_sim foc_sim.c ../../Common/foc.c -lm
+  *          Usage:
+  *            foc_sim [-csv]
+  *          Runs the scenarios below through the same FocStep() as the target,
+  *          the currents quantized as 12 bit ADC samples and the duty cycles
+  *          applied one period late as TIM1 does. Prints the tracking errors of
+  *          each scenario and exits with 1 if one is out of its bounds. With
+  *          -csv the sampled trace is printed on stdout instead.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "foc.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PWM_HZ                  20000.0
+#define PWM_PERIOD              600U        /* 24 MHz, center aligned */
+#define SUBSTEPS                20          /* Model steps per PWM period */
+#define ADC_NOISE               2           /* Peak ADC noise, LSB */
+
+/* Motor and inverter */
+#define VDC                     24.0        /* Bus voltage, V */
+#define IBASE                   10.0        /* ADC full scale current, A */
+#define RS                      0.5         /* Phase resistance, ohm */
+#define LS                      1.0e-3      /* Phase inductance, H */
+#define PSI                     0.01        /* Magnet flux linkage, Wb */
+#define POLES                   4           /* Pole pairs */
+#define INERTIA                 1.0e-5      /* kg m^2 */
+#define FRICTION                1.0e-5      /* N m s */
+
+#define TWO_PI                  6.283185307179586
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  double ia, ib;                /* Phase currents, A */
+  double speed;                 /* Mechanical speed, rad/s */
+  double angle;                 /* Electrical angle, rad */
+  double load;                  /* Load torque, N m */
+} Motor_TypeDef;
+
+typedef struct
+{
+  const char *name;
+  uint8_t angleSource;
+  uint8_t mode;
+  double duration;              /* s */
+  double checkFrom;             /* Errors measured after this time, s */
+  double maxSpeedError;         /* Hz electrical, mean absolute */
+  double maxAngleError;         /* degrees electrical, rms */
+} Scenario_TypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static const Scenario_TypeDef Scenarios[] =
+{
+  { "sensorless speed", FOC_ANGLE_SENSORLESS, FOC_MODE_SPEED,   2.0, 0.8, 1.0, 10.0 },
+  { "external speed",   FOC_ANGLE_EXTERNAL,   FOC_MODE_SPEED,   2.0, 0.8, 1.0,  1.0 },
+  { "external current", FOC_ANGLE_EXTERNAL,   FOC_MODE_CURRENT, 0.5, 0.1, 0.0,  1.0 },
+};
+static int Csv;
+
+/* Private functions ---------------------------------------------------------*/
+static int32_t SpeedUnits(double hz)
+{
+  return (int32_t)(hz / PWM_HZ * 4294967296.0);
+}
+
+static double SpeedHz(int32_t speed)
+{
+  return speed * PWM_HZ / 4294967296.0;
+}
+
+static double Wrap(double a)
+{
+  return a - (TWO_PI * floor((a + (TWO_PI / 2.0)) / TWO_PI));
+}
+
+static uint32_t AdcSample(double i)
+{
+  long raw = 2048 + lround(i / IBASE * 2048.0) + ((rand() % ((2 * ADC_NOISE) + 1)) - ADC_NOISE);
+
+  return (raw < 0) ? 0U : ((raw > 4095) ? 4095U : (uint32_t)raw);
+}
+
+/**
+  * @brief  Per unit parameters of the model motor, see FocConfigTypeDef.
+  * @param  config: filled
+  * @param  sc: scenario
+  */
+static void Configure(FocConfigTypeDef *config, const Scenario_TypeDef *sc)
+{
+  memset(config, 0, sizeof(*config));
+  config->CurrentGain = 32767;
+  config->AngleSource = sc->angleSource;
+  config->Mode = sc->mode;
+  /* Current loops at about 1 kHz: Kp = wc L Ibase / Vdc, Ki = Kp Rs / L Tpwm */
+  config->CurrentPi.Kp = 10700;
+  config->CurrentPi.Ki = 267;
+  config->CurrentPi.Shift = 12;
+  /* Speed loop at about 20 Hz, every FOC_SPEED_DIVIDER periods */
+  config->SpeedPi.Kp = 2100;
+  config->SpeedPi.Ki = 50;
+  config->SpeedPi.Shift = 10;
+  config->CurrentMax = (int16_t)(5.0 / IBASE * 32768.0);
+  config->VoltageMax = 18000;
+  config->Rs = (int16_t)(RS * IBASE / VDC * 32768.0);
+  config->Ls = (int16_t)(LS * IBASE / (VDC / PWM_HZ) * 256.0);
+  /* Flux PSI / (Vdc Tpwm) = 8.3 in q15, 17000 after the shift */
+  config->FluxShift = 4;
+  /* PLL at about 100 Hz */
+  config->PllKp = 1760;
+  config->PllKi = 40;
+  config->StartupSpeed = SpeedUnits(20.0);
+  config->StartupAccel = SpeedUnits(20.0) / 10000;
+  config->StartupCurrent = (int16_t)(3.0 / IBASE * 32768.0);
+}
+
+/**
+  * @brief  Advances the motor by one PWM period at constant duty cycles.
+  * @param  m: motor
+  * @param  duty: compare values
+  */
+static void MotorPeriod(Motor_TypeDef *m, const uint16_t *duty)
+{
+  double dt = 1.0 / (PWM_HZ * SUBSTEPS);
+  double va = (duty[0] / (double)PWM_PERIOD) * VDC;
+  double vb = (duty[1] / (double)PWM_PERIOD) * VDC;
+  double vc = (duty[2] / (double)PWM_PERIOD) * VDC;
+  double valpha = ((2.0 * va) - vb - vc) / 3.0;
+  double vbeta = (vb - vc) / sqrt(3.0);
+  double ialpha, ibeta, ea, eb, torque;
+  int k;
+
+  for(k = 0; k < SUBSTEPS; k++)
+  {
+    ialpha = m->ia;
+    ibeta = (m->ia + (2.0 * m->ib)) / sqrt(3.0);
+    ea = -POLES * m->speed * PSI * sin(m->angle);
+    eb = POLES * m->speed * PSI * cos(m->angle);
+    ialpha += (valpha - (RS * ialpha) - ea) / LS * dt;
+    ibeta += (vbeta - (RS * ibeta) - eb) / LS * dt;
+    torque = 1.5 * POLES * PSI * ((ibeta * cos(m->angle)) - (ialpha * sin(m->angle)));
+    m->speed += (torque - (FRICTION * m->speed) - m->load) / INERTIA * dt;
+    m->angle = Wrap(m->angle + (POLES * m->speed * dt));
+    m->ia = ialpha;
+    m->ib = ((sqrt(3.0) * ibeta) - ialpha) / 2.0;
+  }
+}
+
+/**
+  * @brief  Runs one scenario: start, speed or current steps, load step.
+  * @param  sc: scenario
+  * @retval 0 within bounds, 1 otherwise
+  */
+static int RunScenario(const Scenario_TypeDef *sc)
+{
+  FocConfigTypeDef config;
+  FocTypeDef foc;
+  Motor_TypeDef motor = { 0.0, 0.0, 0.0, 1.0, 0.0 };
+  uint16_t applied[3] = { PWM_PERIOD / 2, PWM_PERIOD / 2, PWM_PERIOD / 2 };
+  uint16_t duty[3];
+  long steps = lround(sc->duration * PWM_HZ);
+  long n, count = 0;
+  double t, ref = 0.0, speedHz, speedError = 0.0, angleError = 0.0, iqError = 0.0, e;
+  int16_t ia, ib;
+
+  Configure(&config, sc);
+  FocReset(&foc, &config, PWM_PERIOD);
+  foc.State = (sc->angleSource == FOC_ANGLE_SENSORLESS) ? FOC_STATE_STARTUP : FOC_STATE_RUN;
+
+  for(n = 0; n < steps; n++)
+  {
+    t = n / PWM_HZ;
+
+    /* References: open loop start to 20 Hz in 0.5 s, speed ramp then step,
+       or current steps, and a load step */
+    if(sc->mode == FOC_MODE_SPEED)
+    {
+      ref = (t < 0.5) ? 20.0 : ((t < 0.8) ? 20.0 + (80.0 * (t - 0.5) / 0.3) : ((t < 1.4) ? 100.0 : 150.0));
+      foc.SpeedRef = SpeedUnits(ref);
+    }
+    else
+    {
+      ref = (t < 0.25) ? 1.0 : 2.0;
+      foc.IqRef = (int16_t)(ref / IBASE * 32768.0);
+    }
+    motor.load = (t < 1.0) ? 0.0 : 0.05;
+    if(sc->mode == FOC_MODE_CURRENT)
+    {
+      /* Held by the load, so the current loop sees a constant back EMF */
+      motor.load = 1.5 * POLES * PSI * ref;
+    }
+
+    /* Sensor: exact angle at each period */
+    if(sc->angleSource == FOC_ANGLE_EXTERNAL)
+    {
+      foc.ExtAngle = (uint32_t)(int64_t)llround(motor.angle / TWO_PI * 4294967296.0);
+      foc.ExtSpeed = SpeedUnits(POLES * motor.speed / TWO_PI);
+    }
+
+    ia = (int16_t)(((int32_t)AdcSample(motor.ia) - 2048) * config.CurrentGain >> 11);
+    ib = (int16_t)(((int32_t)AdcSample(motor.ib) - 2048) * config.CurrentGain >> 11);
+    FocStep(&foc, ia, ib, duty);
+
+    /* Compare values preloaded, active from the next period */
+    MotorPeriod(&motor, applied);
+    memcpy(applied, duty, sizeof(applied));
+
+    speedHz = POLES * motor.speed / TWO_PI;
+    if(Csv)
+    {
+      if((n % 20) == 0)
+      {
+        printf("%s,%.4f,%u,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f\n", sc->name, t, (unsigned)foc.State, ref, speedHz,
+               SpeedHz(foc.Speed), Wrap(((uint32_t)foc.Angle / 4294967296.0 * TWO_PI) - motor.angle) * 360.0 / TWO_PI,
+               foc.Id * IBASE / 32768.0, foc.Iq * IBASE / 32768.0);
+      }
+    }
+    if((t >= sc->checkFrom) && (foc.State == FOC_STATE_RUN))
+    {
+      e = Wrap((foc.Angle / 4294967296.0 * TWO_PI) - motor.angle) * 360.0 / TWO_PI;
+      angleError += e * e;
+      if(sc->mode == FOC_MODE_SPEED)
+      {
+        /* Settled parts only, away from the load and reference steps */
+        if(((t > 1.1) && (t < 1.4)) || (t > 1.6))
+        {
+          speedError += fabs(speedHz - ref);
+          count++;
+        }
+      }
+      else
+      {
+        iqError += fabs((foc.Iq * IBASE / 32768.0) - ref);
+        count++;
+      }
+    }
+  }
+
+  if(count == 0)
+  {
+    count = 1;
+  }
+  angleError = sqrt(angleError / (double)(steps - lround(sc->checkFrom * PWM_HZ)));
+  speedError /= (double)count;
+  iqError /= (double)count;
+  if(!Csv)
+  {
+    printf("%-18s state %u  speed %7.2f Hz  angle error %5.2f deg rms  ", sc->name, (unsigned)foc.State,
+           POLES * motor.speed / TWO_PI, angleError);
+    if(sc->mode == FOC_MODE_SPEED)
+    {
+      printf("speed error %5.2f Hz  ", speedError);
+    }
+    else
+    {
+      printf("Iq error %5.3f A  ", iqError);
+    }
+  }
+
+  if((foc.State != FOC_STATE_RUN) || (angleError > sc->maxAngleError) ||
+     ((sc->mode == FOC_MODE_SPEED) && (speedError > sc->maxSpeedError)) ||
+     ((sc->mode == FOC_MODE_CURRENT) && (iqError > 0.1)))
+  {
+    if(!Csv)
+    {
+      printf("FAIL\n");
+    }
+    return 1;
+  }
+  if(!Csv)
+  {
+    printf("ok\n");
+  }
+  return 0;
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+  unsigned i;
+  int failed = 0;
+
+  if((argc > 2) || ((argc == 2) && (strcmp(argv[1], "-csv") != 0)))
+  {
+    fprintf(stderr, "usage: %s [-csv]\n", argv[0]);
+    return 2;
+  }
+  Csv = (argc == 2);
+  if(Csv)
+  {
+    printf("scenario,t,state,ref,speed_hz,est_speed_hz,angle_error_deg,id_a,iq_a\n");
+  }
+
+  srand(1);
+  for(i = 0; i < (sizeof(Scenarios) / sizeof(Scenarios[0])); i++)
+  {
+    failed |= RunScenario(&Scenarios[i]);
+  }
+  return failed;
+}
@@ -0,0 +1,357 @@
+/**
+  ******************************************************************************
+  * @file    kv_sim.c
+  * @author  Application Team
+  * @Version V1.0.0
+  * @brief   Host power cut test of Common/kvstore.c on a simulated flash.
+  *          Build on Linux with:
+  *            cc -O2 -DKV_HOST_SIM -I. -I../../Common -o kv_sim kv_sim.c ../../Common/kvstore.c
+  *          Usage:
+  *            kv_sim [operations] [seed]
+  *          Runs a random sequence of writes and deletes on the store. Before
+  *          every word program and every page erase the process forks: the
+  *          child cuts the power there, leaving the word or the page half
+  *          done, mounts the store again and checks it against the reference
+  *          model, then checks that the store still takes writes. Exits with 1
+  *          if one of the cuts lost or corrupted data.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "kvstore.h"
+
+/* Private define ------------------------------------------------------------*/
+#define FLASH_WORDS             ((KV_PAGE_COUNT * KV_PAGE_SIZE) / 4U)
+#define CUT_VARIANTS            3           /* Step not started, two partial results */
+#define DEFAULT_OPERATIONS      400
+#define PROBE_KEY               0U
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  int length;                   /* -1 when the key is not stored */
+  uint8_t data[KV_MAX_VALUE_SIZE];
+} Value_TypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+uint32_t KvSimFlash[FLASH_WORDS];
+
+static Value_TypeDef Model[KV_MAX_KEYS];    /* State after the last completed operation */
+static Value_TypeDef Pending;               /* Value of the operation in progress */
+static int PendingKey = -1;
+static int Cutting = 0;                     /* Fork at every step */
+static unsigned long Steps = 0;
+static unsigned long Cuts = 0;
+static unsigned long Failures = 0;
+static uint32_t Random = 1U;
+static jmp_buf PowerCut;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t NextRandom(void)
+{
+  Random ^= Random << 13;
+  Random ^= Random >> 17;
+  Random ^= Random << 5;
+  return Random;
+}
+
+/**
+  * @brief  Cuts the power before a step: forks, the child leaves the step
+  *         partially done and runs the recovery check
+  * @param  word: index of the word programmed, or of the first word erased
+  * @param  value: word value once programmed, ignored for an erase
+  * @param  erase: 1 for a page erase
+  * @retval None
+  */
+static void CutPower(uint32_t word, uint32_t value, int erase)
+{
+  int variant, status;
+  uint32_t i;
+  pid_t pid;
+
+  for(variant = 0; variant < CUT_VARIANTS; variant++)
+  {
+    pid = fork();
+    if(pid < 0)
+    {
+      perror("fork");
+      exit(2);
+    }
+    if(pid == 0)
+    {
+      Random = ((uint32_t)(Steps * CUT_VARIANTS + variant) * 2654435761U) | 1U;
+      (void)NextRandom();
+      if(variant != 0)
+      {
+        if(erase)
+        {
+          /* Each word erased, untouched, or with some bits set back */
+          for(i = word; i < word + KV_PAGE_SIZE / 4U; i++)
+          {
+            switch(NextRandom() % 3U)
+            {
+              case 0: KvSimFlash[i] = 0xFFFFFFFFU; break;
+              case 1: break;
+              default: KvSimFlash[i] |= NextRandom(); break;
+            }
+          }
+        }
+        else
+        {
+          /* Only some of the bits to clear are cleared */
+          KvSimFlash[word] &= ~((KvSimFlash[word] & ~value) & NextRandom());
+        }
+      }
+      Cutting = 0;
+      longjmp(PowerCut, 1);
+    }
+    if((waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+    {
+      fprintf(stderr, "step %lu variant %d: recovery failed\n", Steps, variant);
+      Failures++;
+    }
+    Cuts++;
+  }
+}
+
+/**
+  * @brief  Checks the mounted store against the model
+  * @note   The key of the interrupted operation may hold either value.
+  * @retval 0 if the store matches
+  */
+static int CheckStore(void)
+{
+  uint8_t data[KV_MAX_VALUE_SIZE];
+  uint8_t length;
+  int key, stored;
+  const Value_TypeDef *v;
+
+  for(key = 0; key < KV_MAX_KEYS; key++)
+  {
+    stored = (KvRead((uint8_t)key, data, sizeof(data), &length) == HAL_OK) ? length : -1;
+    v = &Model[key];
+    if((stored == v->length) && ((stored <= 0) || (memcmp(data, v->data, stored) == 0)))
+    {
+      continue;
+    }
+    v = &Pending;
+    if((key == PendingKey) && (stored == v->length) && ((stored <= 0) || (memcmp(data, v->data, stored) == 0)))
+    {
+      continue;
+    }
+    fprintf(stderr, "key %d: stored length %d, expected %d\n", key, stored, Model[key].length);
+    return 1;
+  }
+  return 0;
+}
+
+/**
+  * @brief  Runs in the child after a power cut
+  * @retval Process exit code, 0 when the store recovered
+  */
+static int Recover(void)
+{
+  static const uint8_t probe[] = "probe";
+
+  if((KvInit() != HAL_OK) || CheckStore())
+  {
+    return 1;
+  }
+
+  /* The store must take writes again and keep them over a restart */
+  if(PendingKey == PROBE_KEY)
+  {
+    PendingKey = -1;
+  }
+  if(KvWrite(PROBE_KEY, probe, sizeof(probe)) != HAL_OK)
+  {
+    return 1;
+  }
+  Model[PROBE_KEY].length = sizeof(probe);
+  memcpy(Model[PROBE_KEY].data, probe, sizeof(probe));
+  if((KvInit() != HAL_OK) || CheckStore())
+  {
+    return 1;
+  }
+  return 0;
+}
+
+/* HAL stand-ins -------------------------------------------------------------*/
+/**
+  * @brief  Programs a buffer the way the flash does: bits are only cleared,
+  *         one word at a time, unchanged words are skipped
+  */
+HAL_StatusTypeDef HAL_FLASH_ProgramBuffer(uint32_t Address, const uint8_t *pData, uint32_t Length)
+{
+  uint32_t word, value, shift;
+
+  if((pData == NULL) || (Length == 0U) || ((Address + Length) > sizeof(KvSimFlash)))
+  {
+    return HAL_ERROR;
+  }
+
+  while(Length != 0U)
+  {
+    word = Address / 4U;
+    value = KvSimFlash[word];
+    do
+    {
+      shift = (Address & 3U) * 8U;
+      value = (value & ~(0xFFU << shift)) | ((uint32_t)*pData++ << shift);
+      Address++;
+      Length--;
+    } while((Length != 0U) && ((Address & 3U) != 0U));
+
+    if(value == KvSimFlash[word])
+    {
+      continue;
+    }
+    if((KvSimFlash[word] & value) != value)
+    {
+      return HAL_ERROR;
+    }
+    if(Cutting)
+    {
+      CutPower(word, value, 0);
+    }
+    Steps++;
+    KvSimFlash[word] = value;
+  }
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+  uint32_t page, word;
+
+  *PageError = 0xFFFFFFFFU;
+  if((pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES) || ((pEraseInit->PageAddress % KV_PAGE_SIZE) != 0U) ||
+     ((pEraseInit->PageAddress + pEraseInit->NbPages * KV_PAGE_SIZE) > sizeof(KvSimFlash)))
+  {
+    return HAL_ERROR;
+  }
+
+  for(page = 0; page < pEraseInit->NbPages; page++)
+  {
+    word = (pEraseInit->PageAddress + page * KV_PAGE_SIZE) / 4U;
+    if(Cutting)
+    {
+      CutPower(word, 0xFFFFFFFFU, 1);
+    }
+    Steps++;
+    memset(&KvSimFlash[word], 0xFF, KV_PAGE_SIZE);
+  }
+  return HAL_OK;
+}
+
+/* CRC16 x16+x12+x5+1 reflected, as computed by the HAL */
+uint32_t HAL_CRC_SW_Accumulate(uint32_t Crc, const uint8_t pBuffer[], uint32_t BufferLength)
+{
+  uint32_t crc = Crc & 0xFFFFU;
+  int bit;
+
+  while(BufferLength-- != 0U)
+  {
+    crc ^= *pBuffer++;
+    for(bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 1U) ? ((crc >> 1) ^ 0x8408U) : (crc >> 1);
+    }
+  }
+  return crc;
+}
+
+/* Main ----------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+  static int operations = DEFAULT_OPERATIONS;
+  int i, n, key;
+  uint8_t length;
+  HAL_StatusTypeDef status;
+
+  /* A cut child resumes here and never returns to the workload */
+  if(setjmp(PowerCut) != 0)
+  {
+    exit(Recover());
+  }
+
+  if(argc > 3)
+  {
+    fprintf(stderr, "usage: %s [operations] [seed]\n", argv[0]);
+    return 2;
+  }
+  if(argc > 1)
+  {
+    operations = atoi(argv[1]);
+  }
+  if(argc > 2)
+  {
+    Random = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  if((operations <= 0) || (Random == 0U))
+  {
+    fprintf(stderr, "usage: %s [operations] [seed]\n", argv[0]);
+    return 2;
+  }
+
+  memset(KvSimFlash, 0xFF, sizeof(KvSimFlash));
+  for(key = 0; key < KV_MAX_KEYS; key++)
+  {
+    Model[key].length = -1;
+  }
+  Pending.length = -1;
+  Cutting = 1;
+
+  /* Blank flash: the first mount formats the store */
+  if(KvInit() != HAL_OK)
+  {
+    fprintf(stderr, "format failed\n");
+    return 1;
+  }
+
+  for(i = 0; i < operations; i++)
+  {
+    key = (int)(NextRandom() % KV_MAX_KEYS);
+    if((NextRandom() % 5U) == 0U)
+    {
+      Pending.length = -1;
+      PendingKey = key;
+      status = KvDelete((uint8_t)key);
+    }
+    else
+    {
+      length = (uint8_t)(NextRandom() % (KV_MAX_VALUE_SIZE + 1U));
+      Pending.length = length;
+      for(n = 0; n < length; n++)
+      {
+        Pending.data[n] = (uint8_t)NextRandom();
+      }
+      PendingKey = key;
+      status = KvWrite((uint8_t)key, Pending.data, length);
+    }
+    if(status != HAL_OK)
+    {
+      fprintf(stderr, "operation %d failed\n", i);
+      return 1;
+    }
+    Model[key] = Pending;
+    PendingKey = -1;
+  }
+
+  Cutting = 0;
+  if((KvInit() != HAL_OK) || CheckStore())
+  {
+    fprintf(stderr, "final mount does not match the model\n");
+    Failures++;
+  }
+
+  printf("%d operations, %lu flash steps, %lu power cuts, %lu failures\n", operations, Steps, Cuts, Failures);
+  return (Failures != 0U) ? 1 : 0;
+}
@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    kv_sim_hal.h
+  * @author  Application Team
+  * @Version V1.0.0
+  * @brief   The part of the HAL used by Common/kvstore.c, for a host build
+  *          with KV_HOST_SIM. The functions are implemented by kv_sim.c on a
+  *          RAM image of the store.
+  ******************************************************************************
+  */
+
+#ifndef __KV_SIM_HAL_H
+#define __KV_SIM_HAL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+  uint32_t TypeErase;
+  uint32_t PageAddress;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+#define FLASH_TYPEERASE_PAGES     0x00U
+#define FLASH_PAGE_SIZE           0x200U
+#define FLASH_SIZE_32K            0x8000U
+#define CRC_SW_INIT_VALUE         (0xFFFFU)
+
+/* The store starts at offset 0 of the flash image */
+#define KV_FLASH_BASE             0U
+#define KV_FLASH_PTR(addr)        ((const uint8_t *)KvSimFlash + (addr))
+
+extern uint32_t KvSimFlash[];
+
+HAL_StatusTypeDef HAL_FLASH_ProgramBuffer(uint32_t Address, const uint8_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_FLASH_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+uint32_t HAL_CRC_SW_Accumulate(uint32_t Crc, const uint8_t pBuffer[], uint32_t BufferLength);
+
+#endif /* __KV_SIM_HAL_H */
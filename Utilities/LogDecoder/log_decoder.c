@@ -0,0 +1,408 @@
+/**
+  ******************************************************************************
+  * @file    log_decoder.c
+  * @author  Application Team
+  * @Version V1.0.0
+  * @brief   Host tool rebuilding the text of LOG_T() tokenized log records.
+  *          Build on Linux with:
+  *            cc -O2 -o log_decoder log_decoder.c
+  *          Usage:
+  *            log_decoder <firmware.elf> [capture.bin]
+  *          The capture is read from stdin when no file is given, so the tool
+  *          can sit behind a serial port reader. Bytes that do not start a
+  *          valid record are copied through as plain printf text.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define LOG_T_SYNC              0xA0000000U   /* Must match Common/log.h */
+#define LOG_T_SYNC_MASK         0xF0000000U
+#define LOG_T_MAX_ARGS          8
+#define LOG_T_ADDR_MASK         0x00FFFFFFU
+
+#define ELF_SHT_PROGBITS        1U
+#define ELF_SHF_ALLOC           2U
+#define MAX_SECTIONS            64
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t addr;
+  uint32_t size;
+  const uint8_t *data;
+} Section_TypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t *ElfImage;
+static Section_TypeDef FmtSection;
+static Section_TypeDef RoSections[MAX_SECTIONS];
+static int RoSectionCount;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t rd32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+  * @brief  Loads the ELF file and indexes .log_fmt and the loadable sections.
+  * @param  path: ELF file name
+  * @retval 0 on success
+  */
+static int LoadElf(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  long len;
+  uint32_t shoff;
+  uint16_t shentsize, shnum, shstrndx;
+  const uint8_t *sh, *strtab;
+  int i;
+
+  if(f == NULL)
+  {
+    perror(path);
+    return -1;
+  }
+  fseek(f, 0, SEEK_END);
+  len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  ElfImage = malloc((size_t)len);
+  if((ElfImage == NULL) || (fread(ElfImage, 1, (size_t)len, f) != (size_t)len))
+  {
+    fclose(f);
+    fprintf(stderr, "%s: read error\n", path);
+    return -1;
+  }
+  fclose(f);
+
+  /* 32 bit, little endian ELF only */
+  if((len < 52) || (memcmp(ElfImage, "\177ELF", 4) != 0) || (ElfImage[4] != 1) || (ElfImage[5] != 1))
+  {
+    fprintf(stderr, "%s: not a 32 bit little endian ELF file\n", path);
+    return -1;
+  }
+
+  shoff = rd32(&ElfImage[32]);
+  shentsize = rd16(&ElfImage[46]);
+  shnum = rd16(&ElfImage[48]);
+  shstrndx = rd16(&ElfImage[50]);
+  if((shstrndx >= shnum) || ((uint64_t)shoff + (uint64_t)shnum * shentsize > (uint64_t)len))
+  {
+    fprintf(stderr, "%s: bad section table\n", path);
+    return -1;
+  }
+  strtab = &ElfImage[rd32(&ElfImage[shoff + shstrndx * shentsize + 16])];
+
+  for(i = 0; i < shnum; i++)
+  {
+    const char *name;
+    uint32_t type, flags, addr, offset, size;
+
+    sh = &ElfImage[shoff + i * shentsize];
+    name = (const char *)&strtab[rd32(&sh[0])];
+    type = rd32(&sh[4]);
+    flags = rd32(&sh[8]);
+    addr = rd32(&sh[12]);
+    offset = rd32(&sh[16]);
+    size = rd32(&sh[20]);
+    if((type != ELF_SHT_PROGBITS) || ((uint64_t)offset + size > (uint64_t)len))
+    {
+      continue;
+    }
+
+    if(strcmp(name, ".log_fmt") == 0)
+    {
+      FmtSection.addr = addr;
+      FmtSection.size = size;
+      FmtSection.data = &ElfImage[offset];
+    }
+    else if(((flags & ELF_SHF_ALLOC) != 0U) && (RoSectionCount < MAX_SECTIONS))
+    {
+      RoSections[RoSectionCount].addr = addr;
+      RoSections[RoSectionCount].size = size;
+      RoSections[RoSectionCount].data = &ElfImage[offset];
+      RoSectionCount++;
+    }
+  }
+
+  if(FmtSection.data == NULL)
+  {
+    fprintf(stderr, "%s: no .log_fmt section, was LOG_TOKENIZED enabled?\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+  * @brief  Returns the format string a record header points to.
+  * @param  header: record header word
+  * @retval Format string, NULL if the header is not a valid record start
+  */
+static const char *LookupFormat(uint32_t header)
+{
+  uint32_t addr = header & LOG_T_ADDR_MASK;
+  uint32_t base = FmtSection.addr & LOG_T_ADDR_MASK;
+  uint32_t offset;
+
+  if(((header & LOG_T_SYNC_MASK) != LOG_T_SYNC) || (((header >> 24) & 0x0FU) > LOG_T_MAX_ARGS))
+  {
+    return NULL;
+  }
+  if((addr < base) || (addr >= base + FmtSection.size))
+  {
+    return NULL;
+  }
+  /* A format ID always points at the beginning of a string */
+  offset = addr - base;
+  if((offset != 0U) && (FmtSection.data[offset - 1U] != '\0'))
+  {
+    return NULL;
+  }
+  return (const char *)&FmtSection.data[offset];
+}
+
+/**
+  * @brief  Returns a string constant of the target image.
+  * @param  addr: target address
+  * @retval String, NULL if the address is not in a loadable section
+  */
+static const char *LookupString(uint32_t addr)
+{
+  int i;
+
+  for(i = 0; i < RoSectionCount; i++)
+  {
+    if((addr >= RoSections[i].addr) && (addr < RoSections[i].addr + RoSections[i].size) &&
+       (memchr(&RoSections[i].data[addr - RoSections[i].addr], '\0', RoSections[i].addr + RoSections[i].size - addr) != NULL))
+    {
+      return (const char *)&RoSections[i].data[addr - RoSections[i].addr];
+    }
+  }
+  return NULL;
+}
+
+/**
+  * @brief  Prints one record, consuming one argument word per conversion.
+  * @param  fmt: format string
+  * @param  args: argument words
+  * @param  nargs: argument count
+  * @retval None
+  */
+static void PrintRecord(const char *fmt, const uint32_t *args, uint32_t nargs)
+{
+  char spec[32];
+  uint32_t next = 0;
+  size_t n;
+
+  while(*fmt != '\0')
+  {
+    if(*fmt != '%')
+    {
+      putchar(*fmt++);
+      continue;
+    }
+    if(fmt[1] == '%')
+    {
+      putchar('%');
+      fmt += 2;
+      continue;
+    }
+
+    /* Copy flags, width and precision, '*' takes an argument word like printf */
+    n = 0;
+    spec[n++] = *fmt++;
+    while((*fmt != '\0') && (strchr("-+ #0123456789.*", *fmt) != NULL) && (n < sizeof(spec) - 2))
+    {
+      if(*fmt == '*')
+      {
+        n += (size_t)snprintf(&spec[n], sizeof(spec) - 2 - n, "%d", (next < nargs) ? (int32_t)args[next] : 0);
+        next++;
+        fmt++;
+        if(n > sizeof(spec) - 2)
+        {
+          n = sizeof(spec) - 2;
+        }
+        continue;
+      }
+      spec[n++] = *fmt++;
+    }
+    /* Arguments were truncated to 32 bit on target, drop length modifiers */
+    while((*fmt != '\0') && (strchr("hlLqjzt", *fmt) != NULL))
+    {
+      fmt++;
+    }
+    if(*fmt == '\0')
+    {
+      break;
+    }
+    spec[n++] = *fmt;
+    spec[n] = '\0';
+
+    if(next >= nargs)
+    {
+      fputs("<?>", stdout);
+    }
+    else
+    {
+      uint32_t w = args[next];
+
+      switch(*fmt)
+      {
+        case 'd':
+        case 'i':
+          printf(spec, (int)(int32_t)w);
+          break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+          printf(spec, (unsigned int)w);
+          break;
+        case 'c':
+          printf(spec, (int)(w & 0xFFU));
+          break;
+        case 'p':
+          printf("0x%08x", (unsigned int)w);
+          break;
+        case 's':
+        {
+          const char *str = LookupString(w);
+          if(str != NULL)
+          {
+            printf(spec, str);
+          }
+          else
+          {
+            printf("<str@0x%08x>", (unsigned int)w);
+          }
+          break;
+        }
+        default:
+          printf("<%s:0x%08x>", spec, (unsigned int)w);
+          break;
+      }
+    }
+    next++;
+    fmt++;
+  }
+}
+
+/**
+  * @brief  Splits the capture into records and plain text.
+  * @param  in: capture stream
+  * @retval None
+  */
+static void Decode(FILE *in)
+{
+  uint8_t win[4 * (LOG_T_MAX_ARGS + 1)];
+  uint32_t args[LOG_T_MAX_ARGS];
+  size_t have = 0;
+  size_t need;
+  int eof = 0;
+  int c;
+  uint32_t i;
+
+  for(;;)
+  {
+    const char *fmt = NULL;
+
+    need = 4;
+    while(!eof && (have < need))
+    {
+      if((c = getc(in)) == EOF)
+      {
+        eof = 1;
+        break;
+      }
+      win[have++] = (uint8_t)c;
+      if(have == 4)
+      {
+        fmt = LookupFormat(rd32(win));
+        if(fmt != NULL)
+        {
+          need = 4U * (((rd32(win) >> 24) & 0x0FU) + 1U);
+        }
+      }
+    }
+    if(have == 0)
+    {
+      break;
+    }
+    if((have >= 4) && (fmt == NULL))
+    {
+      fmt = LookupFormat(rd32(win));
+      if(fmt != NULL)
+      {
+        need = 4U * (((rd32(win) >> 24) & 0x0FU) + 1U);
+      }
+    }
+
+    if((fmt != NULL) && (have >= need))
+    {
+      for(i = 0; i < need / 4U - 1U; i++)
+      {
+        args[i] = rd32(&win[4U * (i + 1U)]);
+      }
+      PrintRecord(fmt, args, (uint32_t)(need / 4U - 1U));
+      memmove(win, &win[need], have - need);
+      have -= need;
+      fflush(stdout);
+    }
+    else
+    {
+      /* Not a record, or a record cut by the end of the capture */
+      putchar(win[0]);
+      if(win[0] == '\n')
+      {
+        fflush(stdout);
+      }
+      memmove(win, &win[1], have - 1U);
+      have--;
+    }
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  FILE *in = stdin;
+
+  if((argc < 2) || (argc > 3))
+  {
+    fprintf(stderr, "usage: %s <firmware.elf> [capture.bin]\n", argv[0]);
+    return 2;
+  }
+  if(LoadElf(argv[1]) != 0)
+  {
+    return 1;
+  }
+  if(argc == 3)
+  {
+    in = fopen(argv[2], "rb");
+    if(in == NULL)
+    {
+      perror(argv[2]);
+      return 1;
+    }
+  }
+
+  Decode(in);
+
+  if(in != stdin)
+  {
+    fclose(in);
+  }
+  free(ElfImage);
+  return 0;
+}
@@ -0,0 +1,54 @@
+/**
+  ******************************************************************************
+  * @file    cx32l003_hal_conf.h
+  * @author  Application Team
+  * @Version V1.0.0
+  * @brief   HAL configuration of the UartRingSim host build: only the modules
+  *          the UART driver needs.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CX32L003_HAL_CONF_H
+#define __CX32L003_HAL_CONF_H
+
+/* ########################## Module Selection ############################## */
+#define HAL_MODULE_ENABLED
+#define HAL_RCC_MODULE_ENABLED
+#define HAL_CORTEX_MODULE_ENABLED
+#define HAL_GPIO_MODULE_ENABLED
+#define HAL_UART_MODULE_ENABLED
+
+/* ########################## Oscillator Values adaptation ####################*/
+#define HIRC_VALUE_24M                ((uint32_t)24000000)
+#define HIRC_VALUE_22M                ((uint32_t)22120000)
+#define HIRC_VALUE_16M                ((uint32_t)16000000)
+#define HIRC_VALUE_8M                 ((uint32_t)8000000)
+#define HIRC_VALUE_4M                 ((uint32_t)4000000)
+#define HXT_VALUE                     ((uint32_t)8000000)
+#define HXT_STARTUP_TIMEOUT           ((uint32_t)100)
+#define LIRC_VALUE                    38400U
+#define LXT_VALUE                     ((uint32_t)32768)
+#define LSE_VALUE                     ((uint32_t)32768)
+#define LXT_STARTUP_TIMEOUT           ((uint32_t)5000)
+
+/* ########################### System Configuration ######################### */
+#define  VDD_VALUE                    ((uint32_t)3300)
+#define  PRIORITY_HIGHEST             0
+#define  PRIORITY_HIGH                1
+#define  PRIORITY_LOW                 2
+#define  PRIORITY_LOWEST              3
+#define  TICK_INT_PRIORITY            ((uint32_t)PRIORITY_LOWEST)
+#define  USE_RTOS                     0
+#define  PREFETCH_ENABLE              1
+
+/* Includes ------------------------------------------------------------------*/
+#include "cx32l003_hal_rcc.h"
+#include "cx32l003_hal_gpio.h"
+#include "cx32l003_hal_cortex.h"
+#include "cx32l003_hal_uart.h"
+
+/* Exported macro ------------------------------------------------------------*/
+#define assert_param(expr) ((void)0U)
+
+#endif /* __CX32L003_HAL_CONF_H */
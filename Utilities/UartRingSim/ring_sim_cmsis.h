@@ -0,0 +1,34 @@
+/**
+  ******************************************************************************
+  * @file    ring_sim_cmsis.h
+  * @author  Application Team
+  * @Version V1.0.0
+  * @brief   Host stand-ins of the CMSIS core intrinsics, forced in front of
+  *          every file of the UartRingSim build with -include. __DMB() is
+  *          where the ring functions publish or consume an index: it calls
+  *          RingSimPreempt() so that uart_ring_sim.c can take interrupts there.
+  ******************************************************************************
+  */
+
+#ifndef __RING_SIM_CMSIS_H
+#define __RING_SIM_CMSIS_H
+
+#include <stdint.h>
+
+/* Keeps core_cmInstr.h and core_cmFunc.h from pulling cmsis_gcc.h */
+#define __CMSIS_GCC_H
+
+void RingSimPreempt(void);
+
+#define __DMB()                   RingSimPreempt()
+#define __DSB()                   __asm__ volatile("" ::: "memory")
+#define __ISB()                   __asm__ volatile("" ::: "memory")
+#define __NOP()                   __asm__ volatile("" ::: "memory")
+#define __WFI()                   do { } while(0)
+#define __disable_irq()           do { } while(0)
+#define __enable_irq()            do { } while(0)
+
+static inline uint32_t __get_PRIMASK(void) { return 0U; }
+static inline void __set_PRIMASK(uint32_t priMask) { (void)priMask; }
+
+#endif /* __RING_SIM_CMSIS_H */
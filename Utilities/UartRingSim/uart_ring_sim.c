@@ -0,0 +1,450 @@
+/**
+  ******************************************************************************
+  * @file    uart_ring_sim.c
+  * @author  Application Team
+  * @Version V1.0.0
+  * @brief   Host test of the UART stream mode rings of the HAL driver.
+  *          Build on Linux with:
+  *            cc -O2 -include ring_sim_cmsis.h -I. -I../../Drivers/CX32L003_HAL_Driver/Inc
+  *               -I../../Drivers/CMSIS/Include -I../../Drivers/CMSIS/Device/XMC/CX32L003/Include
+  *               -o uart_ring_sim uart_ring_sim.c ../../Drivers/CX32L003_HAL_Driver/Src/cx32l003_hal_uart.c
+  *          Usage:
+  *            uart_ring_sim [steps] [seed]
+  *          Runs the real cx32l003_hal_uart.c on a RAM copy of the UART
+  *          registers. For several ring sizes a random sequence of
+  *          HAL_UART_Write() and HAL_UART_Read() calls races with bytes leaving
+  *          and reaching the wire; the interrupts are also taken inside the
+  *          ring functions, at their __DMB(). Every byte sent and received is
+  *          checked against a reference queue, and the free-running indices
+  *          wrap many times. Exits with 1 on the first mismatch of a ring size.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cx32l003_hal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define RING_MAX                256U
+#define DEFAULT_STEPS           1000000UL
+#define MAX_MESSAGES            10
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint16_t TxSize;
+  uint16_t RxSize;
+} RingSize_TypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static const RingSize_TypeDef RingSizes[] =
+{
+  { 2U, 2U }, { 8U, 8U }, { 16U, 4U }, { 4U, 64U }, { 256U, 256U }
+};
+
+static UART_TypeDef Uart;
+static UART_HandleTypeDef UartHandle;
+static uint8_t TxStorage[RING_MAX];
+static uint8_t RxStorage[RING_MAX];
+static void (*DriverTxByte)(UART_TypeDef *UARTx, uint8_t Data);
+
+/* Reference model, counters never wrap */
+static uint32_t TxQueued;                   /* Accepted by HAL_UART_Write() */
+static uint32_t TxHanded;                   /* Written to SBUF by the driver */
+static uint32_t TxWire;                     /* Completely shifted out */
+static uint8_t TxShift;                     /* Byte on the wire */
+static int OnWire;
+static uint32_t RxStored;                   /* Arrived and expected in the ring */
+static uint32_t RxRead;                     /* Returned by HAL_UART_Read() */
+static uint32_t RxDropped;                  /* Arrived on a full ring */
+static uint8_t RxReference[RING_MAX];
+static uint32_t LastError;
+
+static const RingSize_TypeDef *Size;
+static unsigned long Step;
+static int InInterrupt = 0;
+static int Preempting = 0;
+static unsigned long Failures = 0;
+static uint32_t Random = 1U;
+
+/* Private functions ---------------------------------------------------------*/
+static uint32_t NextRandom(void)
+{
+  Random ^= Random << 13;
+  Random ^= Random >> 17;
+  Random ^= Random << 5;
+  return Random;
+}
+
+/* Tx byte number n, a lost, repeated or reordered byte changes the sequence */
+static uint8_t TxPattern(uint32_t n)
+{
+  return (uint8_t)((n * 131U) ^ (n >> 8));
+}
+
+static int Fail(const char *what)
+{
+  if(Failures++ < MAX_MESSAGES)
+  {
+    fprintf(stderr, "rings %u/%u, step %lu: %s\n", Size->TxSize, Size->RxSize, Step, what);
+  }
+  return 1;
+}
+
+/**
+  * @brief  Wraps the driver Tx byte handler to follow the shift register
+  */
+static void SimTxByte(UART_TypeDef *UARTx, uint8_t Data)
+{
+  if(OnWire)
+  {
+    Fail("SBUF written while a byte is on the wire");
+  }
+  if(Data != TxPattern(TxHanded))
+  {
+    Fail("Tx byte out of sequence");
+  }
+  DriverTxByte(UARTx, Data);
+  TxShift = (uint8_t)Uart.SBUF;
+  OnWire = 1;
+  TxHanded++;
+}
+
+/**
+  * @brief  Enters HAL_UART_IRQHandler() with the given INTSR flags
+  */
+static void Interrupt(uint32_t flags)
+{
+  InInterrupt = 1;
+  Uart.INTSR = flags;
+  HAL_UART_IRQHandler(&UartHandle);
+  Uart.INTSR = 0U;
+  InInterrupt = 0;
+}
+
+/**
+  * @brief  The byte on the wire completes and, if rx is set, a byte arrives in
+  *         the same interrupt
+  */
+static void WireEvent(int tx, int rx)
+{
+  uint32_t flags = 0U;
+  uint32_t ring = RxStored - RxRead;
+  uint8_t data = (uint8_t)NextRandom();
+
+  if(tx && OnWire)
+  {
+    if(TxShift != TxPattern(TxWire))
+    {
+      Fail("wrong byte on the wire");
+    }
+    TxWire++;
+    OnWire = 0;
+    flags |= UART_INTSR_TI;
+  }
+  if(rx)
+  {
+    Uart.SBUF = data;
+    flags |= UART_INTSR_RI;
+  }
+  if(flags == 0U)
+  {
+    return;
+  }
+
+  LastError = HAL_UART_ERROR_NONE;
+  Interrupt(flags);
+
+  if(rx)
+  {
+    if(ring < Size->RxSize)
+    {
+      RxReference[RxStored % RING_MAX] = data;
+      RxStored++;
+      if(LastError != HAL_UART_ERROR_NONE)
+      {
+        Fail("error reported with room in the Rx ring");
+      }
+    }
+    else
+    {
+      RxDropped++;
+      if(LastError != HAL_UART_ERROR_ORE)
+      {
+        Fail("full Rx ring not reported as an overrun");
+      }
+    }
+  }
+  else if(LastError != HAL_UART_ERROR_NONE)
+  {
+    Fail("error reported by a Tx interrupt");
+  }
+}
+
+/**
+  * @brief  Queues a random amount of data, more than the ring sometimes
+  */
+static void WriteEvent(void)
+{
+  uint8_t buffer[2U * RING_MAX];
+  uint16_t size = (uint16_t)(NextRandom() % (2U * Size->TxSize + 1U));
+  uint16_t room = (uint16_t)(Size->TxSize - (TxQueued - TxHanded));
+  uint16_t i, count;
+
+  for(i = 0U; i < size; i++)
+  {
+    buffer[i] = TxPattern(TxQueued + i);
+  }
+  if(HAL_UART_GetTxFree(&UartHandle) != room)
+  {
+    Fail("HAL_UART_GetTxFree() does not match the model");
+  }
+  count = HAL_UART_Write(&UartHandle, buffer, size);
+  if(count != ((size < room) ? size : room))
+  {
+    Fail("HAL_UART_Write() queued the wrong amount");
+  }
+  TxQueued += count;
+}
+
+/**
+  * @brief  Fetches a random amount of data, more than available sometimes
+  */
+static void ReadEvent(void)
+{
+  uint8_t buffer[2U * RING_MAX];
+  uint16_t size = (uint16_t)(NextRandom() % (2U * Size->RxSize + 1U));
+  uint16_t avail = (uint16_t)(RxStored - RxRead);
+  uint16_t i, count;
+
+  if(HAL_UART_GetRxCount(&UartHandle) != avail)
+  {
+    Fail("HAL_UART_GetRxCount() does not match the model");
+  }
+  count = HAL_UART_Read(&UartHandle, buffer, size);
+  if(count != ((size < avail) ? size : avail))
+  {
+    Fail("HAL_UART_Read() returned the wrong amount");
+  }
+  for(i = 0U; i < count; i++)
+  {
+    if(buffer[i] != RxReference[(RxRead + i) % RING_MAX])
+    {
+      Fail("Rx byte out of sequence");
+      break;
+    }
+  }
+  RxRead += count;
+}
+
+/**
+  * @brief  Runs the workload on one pair of ring sizes
+  * @retval 0 if every check passed
+  */
+static int RunRings(unsigned long steps)
+{
+  unsigned long failures = Failures;
+  uint32_t event;
+
+  TxQueued = TxHanded = TxWire = 0U;
+  RxStored = RxRead = RxDropped = 0U;
+  OnWire = 0;
+
+  if(HAL_UART_Stream_Start(&UartHandle, TxStorage, Size->TxSize, RxStorage, Size->RxSize) != HAL_OK)
+  {
+    return Fail("HAL_UART_Stream_Start() failed");
+  }
+
+  Preempting = 1;
+  for(Step = 0; (Step < steps) && (Failures == failures); Step++)
+  {
+    /* Bursts of writes or reads make the rings run full and empty */
+    event = NextRandom() % 16U;
+    if(event < 5U)
+    {
+      WriteEvent();
+    }
+    else if(event < 10U)
+    {
+      ReadEvent();
+    }
+    else
+    {
+      WireEvent(event < 14U, event >= 12U);
+    }
+
+    /* The Tx interrupt must never stop with bytes left in the ring */
+    if(!OnWire && (TxQueued != TxHanded))
+    {
+      Fail("Tx ring stalled");
+    }
+  }
+  Preempting = 0;
+
+  /* Drain both directions */
+  while(OnWire && (Failures == failures))
+  {
+    WireEvent(1, 0);
+  }
+  while((RxRead != RxStored) && (Failures == failures))
+  {
+    ReadEvent();
+  }
+  if((Failures == failures) && ((TxWire != TxQueued) || (HAL_UART_GetTxFree(&UartHandle) != Size->TxSize)))
+  {
+    Fail("Tx ring not drained");
+  }
+
+  HAL_UART_Stream_Stop(&UartHandle);
+  if((HAL_UART_Write(&UartHandle, TxStorage, 1U) != 0U) || (HAL_UART_Read(&UartHandle, RxStorage, 1U) != 0U))
+  {
+    Fail("ring used after HAL_UART_Stream_Stop()");
+  }
+
+  printf("rings %3u/%-3u %8lu steps, %8lu bytes sent, %8lu received, %8lu overruns\n", Size->TxSize, Size->RxSize,
+         Step, (unsigned long)TxWire, (unsigned long)RxRead, (unsigned long)RxDropped);
+  return (Failures != failures) ? 1 : 0;
+}
+
+/**
+  * @brief  Initializes the UART again in the middle of a stream mode session:
+  *         the rings must be detached as by HAL_UART_Stream_Stop()
+  * @retval 0 if every check passed
+  */
+static int RunReinit(void)
+{
+  static const uint8_t data[] = "reinit";
+  unsigned long failures = Failures;
+
+  Size = &RingSizes[1];
+  Step = 0;
+  UartHandle.TxByte = DriverTxByte;
+  if(HAL_UART_Stream_Start(&UartHandle, TxStorage, Size->TxSize, RxStorage, Size->RxSize) != HAL_OK)
+  {
+    return Fail("HAL_UART_Stream_Start() failed");
+  }
+  (void)HAL_UART_Write(&UartHandle, data, sizeof(data));
+
+  if((HAL_UART_DeInit(&UartHandle) != HAL_OK) || (HAL_UART_Init(&UartHandle) != HAL_OK))
+  {
+    return Fail("HAL_UART_DeInit() or HAL_UART_Init() failed");
+  }
+  if((HAL_UART_Write(&UartHandle, data, sizeof(data)) != 0U) || (HAL_UART_GetRxCount(&UartHandle) != 0U))
+  {
+    Fail("ring used after HAL_UART_DeInit() and HAL_UART_Init()");
+  }
+  /* A byte received now must not reach the old Rx ring */
+  RxStorage[0] = 0U;
+  Uart.SBUF = 0x5AU;
+  Interrupt(UART_INTSR_RI);
+  if((RxStorage[0] != 0U) || (UartHandle.RxRing.Head != 0U))
+  {
+    Fail("interrupt taken in stream mode after HAL_UART_Init()");
+  }
+  if(HAL_UART_Stream_Start(&UartHandle, TxStorage, Size->TxSize, RxStorage, Size->RxSize) != HAL_OK)
+  {
+    Fail("HAL_UART_Stream_Start() refused after HAL_UART_Init()");
+  }
+  HAL_UART_Stream_Stop(&UartHandle);
+
+  printf("reinit during a stream session %s\n", (Failures != failures) ? "failed" : "passed");
+  return (Failures != failures) ? 1 : 0;
+}
+
+/* Driver hooks --------------------------------------------------------------*/
+/**
+  * @brief  Called by __DMB() in the driver: takes a wire interrupt there half
+  *         of the time, while HAL_UART_Write() or HAL_UART_Read() is running
+  */
+void RingSimPreempt(void)
+{
+  uint32_t event;
+
+  if(!Preempting || InInterrupt)
+  {
+    return;
+  }
+  event = NextRandom() % 8U;
+  if(event < 4U)
+  {
+    WireEvent(event != 0U, event != 1U);
+  }
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  LastError |= huart->ErrorCode;
+}
+
+uint32_t HAL_RCC_GetPCLKFreq(void)
+{
+  return HIRC_VALUE_24M;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return 0U;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  (void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+  (void)IRQn;
+}
+
+/* Main ----------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+  unsigned long steps = DEFAULT_STEPS;
+  unsigned int i;
+  int result = 0;
+
+  if(argc > 3)
+  {
+    fprintf(stderr, "usage: %s [steps] [seed]\n", argv[0]);
+    return 2;
+  }
+  if(argc > 1)
+  {
+    steps = strtoul(argv[1], NULL, 0);
+  }
+  if(argc > 2)
+  {
+    Random = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  if((steps == 0UL) || (Random == 0U))
+  {
+    fprintf(stderr, "usage: %s [steps] [seed]\n", argv[0]);
+    return 2;
+  }
+
+  UartHandle.Instance = &Uart;
+  UartHandle.Init.BaudRate = 115200U;
+  UartHandle.Init.BaudDouble = UART_BAUDDOUBLE_ENABLE;
+  UartHandle.Init.WordLength = UART_WORDLENGTH_8B;
+  UartHandle.Init.Parity = UART_PARITY_NONE;
+  UartHandle.Init.Mode = UART_MODE_TX_RX;
+  if(HAL_UART_Init(&UartHandle) != HAL_OK)
+  {
+    fprintf(stderr, "HAL_UART_Init() failed\n");
+    return 1;
+  }
+  DriverTxByte = UartHandle.TxByte;
+  UartHandle.TxByte = SimTxByte;
+
+  for(i = 0U; i < sizeof(RingSizes) / sizeof(RingSizes[0]); i++)
+  {
+    Size = &RingSizes[i];
+    result |= RunRings(steps);
+  }
+  result |= RunReinit();
+
+  printf("%lu failures\n", Failures);
+  return result;
+}